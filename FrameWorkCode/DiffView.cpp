@@ -10,6 +10,7 @@
 #include "DiffView.h"
 #include "ui_DiffView.h"
 #include "diff_match_patch.h"
+#include "htmltotext.h"
 #include <string>
 #include <qstring.h>
 #include <Project.h>
@@ -156,13 +157,8 @@ void DiffView::Load_comparePage(string page)
             }
         }
 
-        QTextDocument doc;
-
-        doc.setHtml(qs2);
-        qs2 = doc.toPlainText().replace(" \n","\n");
-
-        doc.setHtml(qs3);
-        qs3 = doc.toPlainText().replace(" \n","\n");
+        qs2 = HtmlToText::toPlainText(qs2).replace(" \n","\n");
+        qs3 = HtmlToText::toPlainText(qs3).replace(" \n","\n");
 
         int l1,l2,l3, DiffOcr_Corrector,DiffCorrector_Verifier,DiffOcr_Verifier;
         float ocrErrorPerc;
@@ -192,14 +188,9 @@ void DiffView::Load_comparePage(string page)
         if(ocrErrorPerc>100) ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l1)*100;
         OcrAcc = 100 - (((float)lround(ocrErrorPerc*100))/100);
 
-        doc.setHtml(qs1);
-        QString interntext = doc.toPlainText();
-
-        doc.setHtml(qs2);
-        QString ocrtext = doc.toPlainText();
-
-        doc.setHtml(qs3);
-        QString verifiertext = doc.toPlainText();
+        QString interntext = HtmlToText::toPlainText(qs1);
+        QString ocrtext = HtmlToText::toPlainText(qs2);
+        QString verifiertext = HtmlToText::toPlainText(qs3);
 
         //!Displays changes by color coding
         auto diffs = dmp.diff_main(ocrtext,interntext);
@@ -15,6 +15,7 @@
 #include <QDialog>
 #include <QInputDialog>
 #include "lg2_common.h"
+#include "jsonstore.h"
 #include "loadingspinner.h"
 #include "qlabel.h"
 #include "qnetworkaccessmanager.h"
@@ -401,6 +402,40 @@ void Project::AddTemp(Filter * filter, QFile & file,QString prefix) {
     mTreeModel->layoutChanged();
 }
 
+/*!
+ * \fn Project::AddFiles
+ * \brief Adds a batch of files of \a dirPath to the project tree view with one insert into the model,
+ *        instead of relaying out the whole tree for every file like AddTemp().
+ * \param filter
+ * \param dirPath
+ * \param fileNames
+ */
+void Project::AddFiles(Filter * filter, const QString & dirPath, const QStringList & fileNames) {
+    QString name = filter->name();
+    TreeItem * t = mRoot->find(name);
+    QVector<TreeItem*> items;
+    for (const QString & fileName : fileNames)
+    {
+        // Add only required files(ingore all except html and txt) to the tree view
+        QString suff = QFileInfo(fileName).completeSuffix();
+        if (name == "Document" && suff != "txt" && suff != "html")
+            continue;
+
+        TreeItem * f = new TreeItem(fileName,NodeType::_FILETYPE,t);
+        QFile * filep = new QFile(dirPath + "/" + fileName);
+        mFiles.push_back(filep);
+        f->SetFile(filep);
+        f->SetFilter(filter);
+        items.push_back(f);
+    }
+    if (items.isEmpty())
+        return;
+    mTreeModel->BeginInsertRows(t, t->child_count(), items.size());
+    for (TreeItem * f : items)
+        t->append_child(f);
+    mTreeModel->EndInsertRows();
+}
+
 /*!
  * \fn Project::save_xml
  * \brief This function when called saves the xml changes to disk. We used standard c++ functions to achieve this.
@@ -1347,6 +1382,9 @@ int match_cb(const char *path, const char *spec, void *payload) {
      * or a negative number to abort the operation.
      */
     std::string spath = path;
+    //! journals of JsonStore left by a session that did not close are folded into their files on next use
+    if (QString::fromStdString(spath).endsWith(".journal"))
+        return 1;
     return 0;
 }
 
@@ -1373,21 +1411,87 @@ void Project::lg2_add(QString workingFolder)
 
 /*!
  * \fn Project::lg2_add
- * \brief It adds everything in the current directory to the current git index.
+ * \brief It adds the changes of the working tree to the current git index.
+ * \details The first call after the repository is opened adds everything in the current directory, as files
+ * may have changed while the tool was not running. After that only the files marked with markForCommit() are
+ * added, with the folders of small files the tool writes to from many places (Dicts, Comments, logs and bboxf)
+ * and the files at the top of the project, so a commit does not have to stat and hash every page of the set.
+ * The index is opened once and kept.
  */
 void Project::lg2_add() {
-    const char * paths[] = { "/*"};
-    git_strarray arr = { (char**)paths,1 };
-    git_index *idx = NULL;\
     lg2_common lg2;
-    int error = git_repository_index(&idx, repo);
-    lg2.check_lg2(error, "Error Could not open index", "");
-    error = git_index_add_all(idx, &arr, GIT_INDEX_ADD_DEFAULT, match_cb, nullptr);
-    lg2.check_lg2(error, "Error could not add", "");
-    error = git_index_update_all(idx, &arr, match_cb, nullptr);
-    lg2.check_lg2(error, "Error could not update", "");
-    git_index_write(idx);
-    git_index_free(idx);
+    int error;
+    //! the comment and log files are committed in full, not as journals
+    JsonStore::compactAll();
+    if (!mIndex) {
+        error = git_repository_index(&mIndex, repo);
+        lg2.check_lg2(error, "Error Could not open index", "");
+        if (error) {
+            mIndex = nullptr;
+            return;
+        }
+    }
+    else {
+        //! a merge or git outside of the tool may have written the index since
+        git_index_read(mIndex, 0);
+    }
+
+    if (mStageAll) {
+        const char * paths[] = { "/*"};
+        git_strarray arr = { (char**)paths,1 };
+        error = git_index_add_all(mIndex, &arr, GIT_INDEX_ADD_DEFAULT, match_cb, nullptr);
+        lg2.check_lg2(error, "Error could not add", "");
+        error = git_index_update_all(mIndex, &arr, match_cb, nullptr);
+        lg2.check_lg2(error, "Error could not update", "");
+        mStageAll = false;
+        mPendingPaths.clear();
+        git_index_write(mIndex);
+        return;
+    }
+
+    //! images are marked by their writers, so a commit does not stat every scan of the set
+    const char * folders[] = { "Dicts/*", "Comments/*", "logs/*", "bboxf/*" };
+    for (const char * folder : folders) {
+        git_strarray arr = { (char**)&folder,1 };
+        error = git_index_add_all(mIndex, &arr, GIT_INDEX_ADD_DEFAULT, match_cb, nullptr);
+        lg2.check_lg2(error, "Error could not add", "");
+        error = git_index_update_all(mIndex, &arr, match_cb, nullptr);
+        lg2.check_lg2(error, "Error could not update", "");
+    }
+
+    for (const QString & name : mProjectDir.entryList(QDir::Files))
+        mPendingPaths.insert(name);
+    for (const QString & path : mPendingPaths) {
+        QByteArray p = path.toUtf8();
+        bool tracked = git_index_get_bypath(mIndex, p.constData(), 0) != nullptr;
+        if (QFileInfo::exists(mProjectDir.absoluteFilePath(path))) {
+            //! like add_all, untracked files that are ignored stay out
+            int ignored = 0;
+            if (!tracked && git_ignore_path_is_ignored(&ignored, repo, p.constData()) == 0 && ignored)
+                continue;
+            error = git_index_add_bypath(mIndex, p.constData());
+            lg2.check_lg2(error, "Error could not add", "");
+        }
+        else if (tracked) {
+            error = git_index_remove_bypath(mIndex, p.constData());
+            lg2.check_lg2(error, "Error could not update", "");
+        }
+    }
+    mPendingPaths.clear();
+    git_index_write(mIndex);
+}
+
+/*!
+ * \fn Project::markForCommit
+ * \brief Marks a file the tool wrote or removed, so the next lg2_add() adds it to the index
+ * \param filePath
+ */
+void Project::markForCommit(QString filePath)
+{
+    QString path = QDir::cleanPath(mProjectDir.relativeFilePath(QFileInfo(filePath).absoluteFilePath()));
+    if (path.isEmpty() || path.startsWith(".."))
+        return;
+    mPendingPaths.insert(path);
 }
 
 /*!
@@ -1509,6 +1613,14 @@ void Project::open_git_repo()
     lg2_common lg2;
     git_signature * out;
 
+    if (mIndex)
+    {
+        git_index_free(mIndex);
+        mIndex = nullptr;
+    }
+    mPendingPaths.clear();
+    mStageAll = true;
+
     if (gitdir.exists())
     {
         lg2.check_lg2(git_repository_open(&repo, dir.c_str()), "Failed to Open", "");
@@ -1910,3 +2022,102 @@ QString Project::describe_commit(QString mRole,QString commit_number)
 
     return changedFiles;
 }
+
+/*!
+ * \fn Project::syncEditedFiles
+ * \brief Loads the edited files log of mRole into memory, unless it is already loaded and the file has not changed since
+ * \details The file is changed outside of Project only when a fetch brings in another copy, so it is read again then.
+ * \param mRole
+ */
+void Project::syncEditedFiles(QString mRole)
+{
+    QString path = mProjectDir.absolutePath() + "/Dicts/." + mRole + "_EditedFiles.txt";
+    QFileInfo info(path);
+    qint64 size = info.exists() ? info.size() : -1;
+    if (mEditedFilesRole == mRole && mEditedFilesPath == path && mEditedFilesSize == size && mEditedFilesModified == info.lastModified())
+        return;
+
+    mEditedFilesRole = mRole;
+    mEditedFilesPath = path;
+    mEditedFiles.clear();
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream in(&file);
+        while (!in.atEnd()) {
+            QString line = in.readLine().trimmed();
+            if (!line.isEmpty())
+                mEditedFiles.insert(line);
+        }
+        file.close();
+    }
+    stampEditedFiles();
+}
+
+/*!
+ * \fn Project::stampEditedFiles
+ * \brief Remembers the size and modification time of the edited files log as last seen by Project
+ */
+void Project::stampEditedFiles()
+{
+    QFileInfo info(mEditedFilesPath);
+    mEditedFilesSize = info.exists() ? info.size() : -1;
+    mEditedFilesModified = info.lastModified();
+}
+
+/*!
+ * \fn Project::getEditedFiles
+ * \brief Returns the paths of the pages edited by mRole, i.e. the lines of Dicts/.<role>_EditedFiles.txt
+ * \param mRole
+ * \return
+ */
+const QSet<QString> &Project::getEditedFiles(QString mRole)
+{
+    syncEditedFiles(mRole);
+    return mEditedFiles;
+}
+
+/*!
+ * \fn Project::isFileEdited
+ * \param mRole
+ * \param filePath
+ * \return true if filePath is in the edited files log of mRole
+ */
+bool Project::isFileEdited(QString mRole, QString filePath)
+{
+    return getEditedFiles(mRole).contains(filePath);
+}
+
+/*!
+ * \fn Project::addEditedFile
+ * \brief Adds filePath to the edited files log of mRole. The file is only appended to, and only if filePath is new.
+ * \param mRole
+ * \param filePath
+ */
+void Project::addEditedFile(QString mRole, QString filePath)
+{
+    syncEditedFiles(mRole);
+    if (mEditedFiles.contains(filePath))
+        return;
+
+    QFile file(mEditedFilesPath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        QTextStream out(&file);
+        out << filePath << endl;
+        file.close();
+    }
+    mEditedFiles.insert(filePath);
+    stampEditedFiles();
+}
+
+/*!
+ * \fn Project::clearEditedFiles
+ * \brief Deletes the edited files log of mRole
+ * \param mRole
+ */
+void Project::clearEditedFiles(QString mRole)
+{
+    syncEditedFiles(mRole);
+    QFile::remove(mEditedFilesPath);
+    mEditedFiles.clear();
+    stampEditedFiles();
+}
@@ -11,6 +11,8 @@
 #include <diff_match_patch.h>
 #include <qlist.h>
 #include <QObject>
+#include <QSet>
+#include <QDateTime>
 
 class Project {
 public:
@@ -28,6 +30,7 @@ public:
 	void open_git_repo();
     void lg2_add(QString workingFolder);
     void lg2_add();
+    void markForCommit(QString filePath);
     bool commit(std::string message);
     bool push(QString branchName);
 	bool add_config();
@@ -35,6 +38,7 @@ public:
     int fetch(QString);
     bool enable_push(bool increment);
 	void AddTemp(Filter * f, QFile &pFile,QString prefix);
+	void AddFiles(Filter * f, const QString &dirPath, const QStringList &fileNames);
     int findNumberOfFilesInDirectory(std::string);
     int LevenshteinWithGraphemes(QList<Diff> diffs);
     int GetGraphemesCount(QString string);
@@ -49,6 +53,8 @@ public:
         for (auto f : mFilters) {
                     delete f;
                 }
+		if(mIndex)
+			git_index_free(mIndex);
 		if(repo)
         //git_repository_free(repo);
             ;
@@ -75,6 +81,10 @@ public:
 		m_isOpen = open;
 	}
     bool fetch_n_merge(QString gDirTwoLevelUp, QString mRole);
+    const QSet<QString> &getEditedFiles(QString mRole);
+    bool isFileEdited(QString mRole, QString filePath);
+    void addEditedFile(QString mRole, QString filePath);
+    void clearEditedFiles(QString mRole);
 private:
 	bool m_isOpen = false;
 	QVector<QFile*> mFiles;
@@ -87,6 +97,20 @@ private:
 	QDir mProjectDir;
     pugi::xml_document doc;
 
+    //! Dicts/.<role>_EditedFiles.txt of mEditedFilesRole, kept in memory; the stamp is the size and time of the file when it was last read or written
+    QString mEditedFilesRole;
+    QString mEditedFilesPath;
+    QSet<QString> mEditedFiles;
+    qint64 mEditedFilesSize = -1;
+    QDateTime mEditedFilesModified;
+    void syncEditedFiles(QString mRole);
+    void stampEditedFiles();
+
+    //! index of repo kept open between commits, and the files written since the last lg2_add(), relative to mProjectDir
+    git_index * mIndex = nullptr;
+    QSet<QString> mPendingPaths;
+    bool mStageAll = true;      // the next lg2_add() stages the whole working tree
+
 public:
     std::string mName = "";
     std::string mEmail = "";
@@ -10,6 +10,7 @@
  *
  */
 #include "Symbols.h"
+#include "mainwindow.h"
 #include "qbuffer.h"
 #include "qclipboard.h"
 #include "qdir.h"
@@ -278,6 +279,7 @@ void SymbolsView::on_copyButton_clicked()
             buffer.open(QIODevice::WriteOnly);
             image.save(file_name, "PNG");
         }
+        ((MainWindow *)(parentWidget()))->GetProject().markForCommit(file_name);
         if(file_name.back()!='#')
         {
             QString html = "<img src=\""+file_name+"\">";
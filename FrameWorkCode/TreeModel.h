@@ -23,6 +23,13 @@ public:
 		
 		endRemoveRows();
 	}
+	void BeginInsertRows(TreeItem * parent, int row, int rows) {
+		QModelIndex idx = parent == mRootItem ? QModelIndex() : createIndex(parent->row(), 0, parent);
+		beginInsertRows(idx, row, rows + row - 1);
+	}
+	void EndInsertRows() {
+		endInsertRows();
+	}
 private:
 	void setupModelData(const QStringList &lines, TreeItem * parent);
 	TreeItem * mRootItem;
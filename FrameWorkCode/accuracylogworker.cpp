@@ -0,0 +1,279 @@
+/*!
+ * \class AccuracyLogWorker
+ * \brief Computes the accuracy log of a VerifierOutput folder on a thread pool, outside of the GUI thread
+ */
+#include "accuracylogworker.h"
+#include "Project.h"
+#include "diff_match_patch.h"
+#include "htmltotext.h"
+#include <QFile>
+#include <QTextStream>
+#include <QCryptographicHash>
+#include <QScopedArrayPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QDebug>
+#include <fstream>
+#include <sstream>
+#include <math.h>
+
+/*!
+ * \class AccuracyLogTask
+ * \brief Runs computePage() for one page on the accuracy log thread pool
+ * \details Every task writes only its own PageJob and then marks it done, so the rows can be written in page order while the later pages are still computed.
+ */
+class AccuracyLogTask : public QRunnable
+{
+public:
+    AccuracyLogTask(AccuracyLogWorker *worker, AccuracyLogWorker::PageJob *job, QAtomicInt *done)
+        : worker(worker), job(job), done(done) {}
+
+    void run() override
+    {
+        worker->computePage(job);
+        done->storeRelease(1);
+    }
+
+private:
+    AccuracyLogWorker *worker;
+    AccuracyLogWorker::PageJob *job;
+    QAtomicInt *done;
+};
+
+/*!
+ * \fn AccuracyLogWorker::AccuracyLogWorker
+ * \param parent
+ * \param mProject
+ * \param folder VerifierOutput folder
+ * \param textFiles pages of the folder
+ */
+AccuracyLogWorker::AccuracyLogWorker(QObject *parent, Project *mProject, QString folder, QStringList textFiles)
+    : QObject(parent), mProject(mProject), folder(folder), textFiles(textFiles)
+{
+    int loc = folder.lastIndexOf("/");
+    csvPath = folder.mid(0, loc) + "/AccuracyLog.csv";
+    cachePath = folder.mid(0, loc) + "/AccuracyLog.cache";
+}
+
+/*!
+ * \fn readText
+ * \brief Contents of a page, empty if it can not be read
+ * \param path
+ * \return
+ */
+static QString readText(const QString &path)
+{
+    QString text = "";
+    if (path.isEmpty())
+        return text;
+    QFile sFile(path);
+    if (sFile.open(QFile::ReadOnly | QFile::Text))
+    {
+        QTextStream in(&sFile);
+        in.setCodec("UTF-8");
+        text = in.readAll();
+        sFile.close();
+    }
+    return text;
+}
+
+/*!
+ * \fn AccuracyLogWorker::computePage
+ * \brief Computes the csv row of one page, unless the texts have the hash of its cached row
+ * \details Stores the following values in the row:
+ * Page Name
+ * Word Errors of the Corrector
+ * Character Errors of the Corrector
+ * Percent Word Level Accuracy (Corrector)
+ * Percent Character Level Accuracy (Corrector)
+ * Percent Change made by Corrector wrt OCR Text
+ * Percent Accuracy of OCR
+ * \param job
+ * \sa diff_match_patch::diff_main(),  Project::LevenshteinWithGraphemes(), Project::GetGraphemesCount()
+ */
+void AccuracyLogWorker::computePage(PageJob *job)
+{
+    QString fileName = job->fileName;
+    string pageName = fileName.toUtf8().constData();
+    fileName = folder + "/" + fileName;
+
+    QString verifierText = fileName;
+    QString correctorText = fileName.replace("VerifierOutput","CorrectorOutput"); //CAN CHANGE ACCORDING TO FILE STRUCTURE
+    QString ocrText = fileName.replace("CorrectorOutput","Inds"); //CAN CHANGE ACCORDING TO FILE STRUCTURE
+    ocrText.replace(".html",".txt");
+    ocrText.replace("V1_", "");
+    ocrText.replace("V2_", "");
+    ocrText.replace("V3_", "");
+
+    QString qs1 = readText(ocrText);
+    QString qs2 = readText(correctorText);
+    QString qs3 = readText(verifierText);
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(qs1.toUtf8());
+    hash.addData("\0", 1);
+    hash.addData(qs2.toUtf8());
+    hash.addData("\0", 1);
+    hash.addData(qs3.toUtf8());
+    QByteArray key = hash.result().toHex();
+    if (job->cached && job->hash == key)
+        return;
+    job->hash = key;
+    job->cached = false;
+    job->row.clear();
+
+    qs1 = qs1.simplified(); qs2 = qs2.simplified(); qs3 = qs3.simplified();
+    int l1,l2,l3, DiffOcr_Corrector,DiffCorrector_Verifier,DiffOcr_Verifier; float correctorChangesPerc,verifierChangesPerc,ocrErrorPerc;
+
+    qs2 = HtmlToText::toPlainText(qs2).replace(" \n","\n");
+    qs3 = HtmlToText::toPlainText(qs3).replace(" \n","\n");
+
+    if(qs1=="" | qs2 == "" | qs3 == "")
+    {
+        return;
+    }
+    l1 = mProject->GetGraphemesCount(qs1); l2 = mProject->GetGraphemesCount(qs2); l3 = mProject->GetGraphemesCount(qs3);
+
+    diff_match_patch dmp;
+
+    auto diffs1 = dmp.diff_main(qs1,qs2);
+    DiffOcr_Corrector = mProject->LevenshteinWithGraphemes(diffs1);
+    correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l2)*100;
+    if(correctorChangesPerc>100)
+        correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l1)*100;
+    correctorChangesPerc = (((float)lround(correctorChangesPerc*100))/100);
+
+    auto diffs2 = dmp.diff_main(qs2,qs3);
+    DiffCorrector_Verifier = mProject->LevenshteinWithGraphemes(diffs2);
+    verifierChangesPerc = ((float)(DiffCorrector_Verifier)/(float)l3)*100;
+    if(verifierChangesPerc>100)
+        verifierChangesPerc = ((float)(DiffCorrector_Verifier)/(float)l2)*100;
+    verifierChangesPerc = (((float)lround(verifierChangesPerc*100))/100);
+    float correctorCharAcc =100- (((float)lround(verifierChangesPerc*100))/100); //Corrector accuracy = 100-changes mabe by Verfier
+
+    auto diffs3 = dmp.diff_main(qs1,qs3);
+    DiffOcr_Verifier = mProject->LevenshteinWithGraphemes(diffs3);
+    ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l3)*100;
+    if(ocrErrorPerc>100)
+        ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l1)*100;
+    float ocrAcc = 100 - (((float)lround(ocrErrorPerc*100))/100);
+
+    auto a = dmp.diff_linesToChars(qs2, qs3); //LinesToChars modifed for WordstoChar in diff_match_patch.cpp
+    auto lineText1 = a[0].toString();
+    auto lineText2 = a[1].toString();
+    int wordCount2 = qs2.simplified().count(" ");
+    int wordCount3 = qs3.simplified().count(" ");
+    auto diffs = dmp.diff_main(lineText1, lineText2);
+    int worderrors = dmp.diff_levenshtein(diffs);
+
+    float correctorwordaccuracy = (float)(worderrors)/(float)wordCount3*100;
+    if(correctorwordaccuracy>100)
+        correctorwordaccuracy = (float)(worderrors)/(float)wordCount2*100;
+    correctorwordaccuracy = (((float)lround(correctorwordaccuracy*100))/100);
+
+    std::ostringstream row;
+    row<<pageName<<","<<worderrors<<","<<DiffCorrector_Verifier<<","<< correctorwordaccuracy<<","<<correctorCharAcc<<"," <<correctorChangesPerc<<","<<ocrAcc<<"\n";
+    job->row = row.str();
+}
+
+/*!
+ * \fn AccuracyLogWorker::readCache
+ * \brief Reads AccuracyLog.cache, one "page TAB hash TAB row" line per page
+ * \return hash and row of every cached page
+ */
+QMap<QString, QPair<QByteArray, string> > AccuracyLogWorker::readCache()
+{
+    QMap<QString, QPair<QByteArray, string> > cache;
+    QFile file(cachePath);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return cache;
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    while (!in.atEnd()) {
+        QStringList fields = in.readLine().split("\t");
+        if (fields.size() != 3)
+            continue;
+        string row = fields[2].toUtf8().constData();
+        if (!row.empty())
+            row += "\n";
+        cache.insert(fields[0], qMakePair(fields[1].toLatin1(), row));
+    }
+    file.close();
+    return cache;
+}
+
+/*!
+ * \fn AccuracyLogWorker::writeCache
+ * \param jobs
+ */
+void AccuracyLogWorker::writeCache(const QVector<PageJob> &jobs)
+{
+    QFile file(cachePath);
+    if (!file.open(QFile::WriteOnly | QFile::Text | QFile::Truncate)) {
+        qDebug() << "Could not write" << cachePath;
+        return;
+    }
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    for (const PageJob &job : jobs) {
+        QString row = QString::fromStdString(job.row).trimmed();
+        out << job.fileName << "\t" << job.hash << "\t" << row << "\n";
+    }
+    file.close();
+}
+
+/*!
+ * \fn AccuracyLogWorker::writeAccuracyLog
+ * \brief Computes the pages on a thread pool of QThread::idealThreadCount() threads and writes their rows to AccuracyLog.csv in page order
+ * \details While the pool works this thread writes the rows of the pages done so far that follow the last written one, and reports the progress.
+ * Pages with a missing text get no row, as before.
+ */
+void AccuracyLogWorker::writeAccuracyLog()
+{
+    int total = textFiles.size();
+    QMap<QString, QPair<QByteArray, string> > cache = readCache();
+    QVector<PageJob> jobs(total);
+    for (int i = 0; i < total; i++) {
+        jobs[i].fileName = textFiles[i];
+        jobs[i].cached = cache.contains(textFiles[i]);
+        if (jobs[i].cached) {
+            jobs[i].hash = cache[textFiles[i]].first;
+            jobs[i].row = cache[textFiles[i]].second;
+        }
+    }
+
+    std::ofstream csvFile(csvPath.toUtf8().constData());
+    csvFile<<"Page Name,"<<"Errors (Word level),"<<"Errors (Character-Level),"<< "Accuracy of Corrector (Word level),"<<"Accuracy of Corrector (Character-Level)," <<"Changes made by Corrector(%)," <<"OCR Accuracy(w.rt. Verified Text)"<<"\n";
+    csvFile.flush();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    QScopedArrayPointer<QAtomicInt> done(new QAtomicInt[total > 0 ? total : 1]);
+    for (int i = 0; i < total; i++)
+        pool.start(new AccuracyLogTask(this, &jobs[i], &done[i]));
+
+    int written = 0;
+    int perc = 0; // percentage to be shown on progress bar
+    bool finished = total == 0;
+    while (!finished) {
+        finished = pool.waitForDone(100);
+        int start = written;
+        while (written < total && done[written].loadAcquire()) {
+            csvFile << jobs[written].row;
+            written++;
+        }
+        if (written > start)
+            csvFile.flush();
+        int tempPerc = (written * 100) / total;
+        if (tempPerc > perc) {
+            perc = tempPerc;
+            emit changeProgressBarValue(perc);
+        }
+    }
+    csvFile.close();
+
+    writeCache(jobs);
+    emit finishedWritingAccuracyLog();
+}
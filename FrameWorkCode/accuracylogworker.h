@@ -0,0 +1,55 @@
+#ifndef ACCURACYLOGWORKER_H
+#define ACCURACYLOGWORKER_H
+
+#include <QObject>
+#include <QMap>
+#include <QVector>
+#include <QStringList>
+#include <string>
+
+using namespace std;
+
+class Project;
+
+/*
+ * Writes AccuracyLog.csv for the pages of a VerifierOutput folder.
+ * Every page is compared with its CorrectorOutput and Inds versions on a
+ * thread pool; the rows are written in page order as soon as all the pages
+ * before them are done. The row of every page is kept in AccuracyLog.cache
+ * beside the csv with the hash of the three texts it was computed from, so a
+ * rerun computes only the pages whose texts changed.
+ */
+class AccuracyLogWorker : public QObject
+{
+    Q_OBJECT
+public:
+    struct PageJob {
+        QString fileName;       // page in the VerifierOutput folder
+        QByteArray hash;        // of the OCR, corrector and verifier texts
+        string row;             // csv row, empty if one of the texts is missing
+        bool cached;            // row and hash were read from the cache file
+    };
+
+    explicit AccuracyLogWorker(QObject *parent = nullptr, Project *mProject = nullptr, QString folder = "", QStringList textFiles = {});
+
+    void computePage(PageJob *job);
+
+public slots:
+    void writeAccuracyLog();
+
+signals:
+    void changeProgressBarValue(int value);
+    void finishedWritingAccuracyLog();
+
+private:
+    Project *mProject;
+    QString folder;
+    QStringList textFiles;
+    QString csvPath;
+    QString cachePath;
+
+    QMap<QString, QPair<QByteArray, string> > readCache();
+    void writeCache(const QVector<PageJob> &jobs);
+};
+
+#endif // ACCURACYLOGWORKER_H
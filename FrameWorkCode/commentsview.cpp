@@ -11,6 +11,7 @@
 #include <QCloseEvent>
 #include <QString>
 #include "crashlog.h"
+#include "jsonstore.h"
 #include <string>
 QString commentFilename;
 QString pagename;
@@ -102,26 +103,5 @@ void CommentsView::on_pushButton_clicked() //Verifier-Version
 
     QString comments = ui->commentTextBrowser->toPlainText();
 
-    QFile jsonFile(commentFilename);
-    jsonFile.open(QIODevice::ReadOnly | QIODevice::Text);
-    QByteArray data = jsonFile.readAll();
-
-    QJsonParseError errorPtr;
-    QJsonDocument document = QJsonDocument::fromJson(data, &errorPtr);
-    QJsonObject mainObj = document.object();
-    QJsonObject pages = mainObj.value("pages").toObject();
-    QJsonObject page = pages.value(pagename).toObject();
-    jsonFile.close();
-    page["comments"] = comments;
-
-    pages.remove(pagename);
-    pages.insert(pagename,page);
-    mainObj.remove("pages");
-    mainObj.insert("pages",pages);
-    document.setObject(mainObj);
-
-    QFile jsonFile1(commentFilename);
-    jsonFile1.open(QIODevice::WriteOnly);
-    jsonFile1.write(document.toJson());
-
+    JsonStore::get(commentFilename)->insert({ "pages", pagename, "comments" }, comments);
 }
@@ -0,0 +1,52 @@
+/*!
+ * \class CorrectionPairs
+ * \brief Hash index of the correction pairs by SLP1 key
+ */
+#include "correctionpairs.h"
+
+/*!
+ * \fn CorrectionPairs::CorrectionPairs
+ */
+CorrectionPairs::CorrectionPairs()
+{
+    clear();
+}
+
+/*!
+ * \fn CorrectionPairs::clear
+ */
+void CorrectionPairs::clear()
+{
+    pairs.clear();
+}
+
+/*!
+ * \fn CorrectionPairs::add
+ * \param key
+ * \param word
+ */
+void CorrectionPairs::add(const string& key, const string& word)
+{
+    pairs[key].insert(word);
+}
+
+/*!
+ * \fn CorrectionPairs::set
+ * \param key
+ * \param words
+ */
+void CorrectionPairs::set(const string& key, const std::set<string>& words)
+{
+    pairs[key] = words;
+}
+
+/*!
+ * \fn CorrectionPairs::find
+ * \param key
+ * \return
+ */
+const std::set<string>* CorrectionPairs::find(const string& key) const
+{
+    const_iterator it = pairs.find(key);
+    return it == pairs.end() ? nullptr : &it->second;
+}
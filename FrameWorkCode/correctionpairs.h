@@ -0,0 +1,47 @@
+#ifndef CORRECTIONPAIRS_H
+#define CORRECTIONPAIRS_H
+
+#include <string>
+#include <set>
+#include <unordered_map>
+
+using namespace std;
+
+/*
+ * Correction pairs (CPairs): an OCR word and the words it was corrected to,
+ * from the CPair file of the project and from global replace.
+ * Keys and words are SLP1, so the context menu finds the corrections of a word
+ * with one hash lookup of its SLP1 form instead of transliterating every key.
+ */
+class CorrectionPairs
+{
+public:
+    typedef unordered_map<string, std::set<string> >::const_iterator const_iterator;
+
+    CorrectionPairs();
+
+    void clear();
+
+    size_t size() const { return pairs.size(); }
+
+    bool empty() const { return pairs.empty(); }
+
+    //! Adds word to the corrections of key
+    void add(const string& key, const string& word);
+
+    //! Replaces the corrections of key
+    void set(const string& key, const std::set<string>& words);
+
+    //! Corrections of key, nullptr if key has none
+    const std::set<string>* find(const string& key) const;
+
+    //! Entries in no particular order
+    const_iterator begin() const { return pairs.begin(); }
+
+    const_iterator end() const { return pairs.end(); }
+
+private:
+    unordered_map<string, std::set<string> > pairs;
+};
+
+#endif // CORRECTIONPAIRS_H
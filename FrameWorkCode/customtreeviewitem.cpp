@@ -1,14 +1,14 @@
 #include "customtreeviewitem.h"
 
-customTreeviewItem::customTreeviewItem(QTreeView* tv,QMap<QString, int> checkedPages, QAbstractItemModel *model)
+customTreeviewItem::customTreeviewItem(QTreeView* tv, const PageStatusIndex *pageStatus, PageStatusIndex::Status status, QAbstractItemModel *model)
 {
     this->treeView = tv;
-    this->changedPages = checkedPages;
+    this->pageStatus = pageStatus;
+    this->status = status;
     this->model = model;
 }
 
-void customTreeviewItem::update(QMap<QString, int> checkedPages)
+void customTreeviewItem::update()
 {
-    this->changedPages = checkedPages;
+    treeView->viewport()->update();
 }
-
@@ -9,16 +9,16 @@
 #include<QModelIndex>
 #include<QDebug>
 #include<QAbstractItemModel>
+#include "pagestatusindex.h"
 class customTreeviewItem: public QStyledItemDelegate
 {
 public:
-    customTreeviewItem(QTreeView* treeView, QMap<QString, int> checkedPages,QAbstractItemModel *model);
+    customTreeviewItem(QTreeView* treeView, const PageStatusIndex *pageStatus, PageStatusIndex::Status status, QAbstractItemModel *model);
 
     void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override
     {
         QString treeItemLabel = index.data(Qt::DisplayRole).toString();
-        QStringList pageNames = changedPages.keys();
-        if (pageNames.contains(treeItemLabel) ){
+        if (pageStatus->has(treeItemLabel, status)){
             painter->fillRect(option.rect, QColor(60,179,113));
             QRect adjustedRect = option.rect.adjusted(0, 0, 0, 0);
             painter->drawRect(adjustedRect);
@@ -27,11 +27,12 @@ public:
 
     }
 
-    void update(QMap<QString, int> checkedPages);
+    void update();
 
 private:
     QTreeView* treeView;
-    QMap<QString, int> changedPages;
+    const PageStatusIndex *pageStatus;
+    PageStatusIndex::Status status;     // pages with this status are highlighted
     QAbstractItemModel *model;
 };
 
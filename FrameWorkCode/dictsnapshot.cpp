@@ -0,0 +1,577 @@
+#include "dictsnapshot.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+const char MAGIC[8] = { 'O', 'O', 'C', 'D', 'S', 'N', 'A', 'P' };
+const quint32 BYTE_ORDER_MARK = 0x01020304;
+
+/*
+ * Section layout: number of pooled strings, their end offsets, the pool bytes and then
+ * the tables, which hold pool indices in place of strings.
+ */
+class SectionWriter
+{
+public:
+    string body;
+
+    void u32(uint32_t v) { body.append((const char*)&v, sizeof(v)); }
+
+    void str(const string& s)
+    {
+        unordered_map<string, uint32_t>::iterator it = ids.find(s);
+        if (it == ids.end()) {
+            it = ids.insert(make_pair(s, (uint32_t)ends.size())).first;
+            pool += s;
+            ends.push_back((uint32_t)pool.size());
+        }
+        u32(it->second);
+    }
+
+    void counts(const Lexicon& m) { m.write(body); }
+
+    void words(const vector<string>& v)
+    {
+        u32((uint32_t)v.size());
+        for (size_t i = 0; i < v.size(); i++) str(v[i]);
+    }
+
+    string finish() const
+    {
+        string out;
+        uint32_t n = (uint32_t)ends.size();
+        out.reserve(sizeof(n) + ends.size() * sizeof(uint32_t) + pool.size() + body.size());
+        out.append((const char*)&n, sizeof(n));
+        out.append((const char*)ends.data(), ends.size() * sizeof(uint32_t));
+        out += pool;
+        out += body;
+        return out;
+    }
+
+private:
+    unordered_map<string, uint32_t> ids;
+    vector<uint32_t> ends;
+    string pool;
+};
+
+//! Reads a section in place; any read past the end clears ok
+class SectionReader
+{
+public:
+    bool ok;
+    const char *p, *end;
+
+    SectionReader(const char* data, const char* dataEnd) : ok(true), p(data), end(dataEnd), count(0)
+    {
+        count = u32();
+        if (!ok || (size_t)(end - p) / sizeof(uint32_t) < count) { ok = false; return; }
+        ends = p;
+        p += count * sizeof(uint32_t);
+        poolSize = count ? endOf(count - 1) : 0;
+        if ((size_t)(end - p) < poolSize) { ok = false; return; }
+        pool = p;
+        p += poolSize;
+    }
+
+    uint32_t u32()
+    {
+        uint32_t v = 0;
+        if ((size_t)(end - p) < sizeof(v)) { ok = false; return 0; }
+        memcpy(&v, p, sizeof(v));
+        p += sizeof(v);
+        return v;
+    }
+
+    void str(string& s)
+    {
+        uint32_t id = u32();
+        if (!ok || id >= count) { ok = false; s.clear(); return; }
+        uint32_t b = id ? endOf(id - 1) : 0, e = endOf(id);
+        if (b > e || e > poolSize) { ok = false; s.clear(); return; }
+        s.assign(pool + b, e - b);
+    }
+
+    void counts(Lexicon& m) { if (ok && !m.read(p, end)) ok = false; }
+
+    void words(vector<string>& v)
+    {
+        uint32_t n = u32();
+        if (!ok || n > (size_t)(end - p) / sizeof(uint32_t)) { ok = false; return; }
+        v.resize(n);
+        for (uint32_t i = 0; i < n && ok; i++) str(v[i]);
+    }
+
+    void read(trie& t) { if (ok && !t.read(p, end)) ok = false; }
+
+private:
+    uint32_t count, poolSize = 0;
+    const char *ends = nullptr, *pool = nullptr;
+
+    uint32_t endOf(uint32_t i) const { uint32_t v; memcpy(&v, ends + i * sizeof(v), sizeof(v)); return v; }
+};
+
+void putU32(string& out, quint32 v) { out.append((const char*)&v, sizeof(v)); }
+void putI64(string& out, qint64 v) { out.append((const char*)&v, sizeof(v)); }
+
+bool getU32(const char*& p, const char* end, quint32& v)
+{
+    if ((size_t)(end - p) < sizeof(v)) return false;
+    memcpy(&v, p, sizeof(v));
+    p += sizeof(v);
+    return true;
+}
+
+bool getI64(const char*& p, const char* end, qint64& v)
+{
+    if ((size_t)(end - p) < sizeof(v)) return false;
+    memcpy(&v, p, sizeof(v));
+    p += sizeof(v);
+    return true;
+}
+
+const int MD5_SIZE = 16;
+
+}
+
+/*!
+ * \fn DictSnapshot::DictSnapshot
+ * \brief Maps the snapshot of the project, if there is one. Nothing is parsed until a section is asked for.
+ * \param projectDir
+ */
+DictSnapshot::DictSnapshot(const QString& projectDir) : base(nullptr), dirty(false)
+{
+    dictDir = projectDir + "/Dicts/";
+    QByteArray key = QCryptographicHash::hash(QDir(projectDir).absolutePath().toUtf8(), QCryptographicHash::Md5).toHex();
+    path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/dictsnapshots/" + QString(key) + ".bin";
+    if (!open()) close();
+}
+
+/*!
+ * \fn DictSnapshot::~DictSnapshot
+ */
+DictSnapshot::~DictSnapshot()
+{
+    close();
+}
+
+/*!
+ * \fn DictSnapshot::sourcesOf
+ * \param s
+ * \return files in Dicts/ that section s is built from
+ */
+QStringList DictSnapshot::sourcesOf(Section s)
+{
+    switch (s) {
+    case DictSection: return QStringList() << "Dict";
+    case OCRSection: return QStringList() << "GEROCR" << "IEROCR";
+    case CPairsSection: return QStringList() << "Corrector_CPair";
+    case LSTMSection: return QStringList() << "LSTM";
+    case ConfusionsSection: return QStringList() << "CorrectorCPair";
+    default: return QStringList();
+    }
+}
+
+/*!
+ * \fn DictSnapshot::stampOf
+ * \param name file in Dicts/
+ * \param withHash the MD5 of the contents is only computed when asked for
+ * \return
+ */
+DictSnapshot::Stamp DictSnapshot::stampOf(const QString& name, bool withHash) const
+{
+    Stamp st;
+    QFileInfo info(dictDir + name);
+    st.size = info.exists() ? info.size() : -1;
+    st.mtime = info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+    if (withHash && st.size >= 0) {
+        QFile f(info.absoluteFilePath());
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        if (f.open(QIODevice::ReadOnly)) hash.addData(&f);
+        st.md5 = hash.result();
+    }
+    if (st.md5.isEmpty()) st.md5 = QByteArray(MD5_SIZE, 0);
+    return st;
+}
+
+/*!
+ * \fn DictSnapshot::open
+ * \brief Maps the snapshot file and reads its section table
+ * \return false if there is no usable snapshot
+ */
+bool DictSnapshot::open()
+{
+    file.setFileName(path);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) return false;
+    qint64 size = file.size();
+    base = (const char*)file.map(0, size);
+    if (!base) return false;
+
+    const char *p = base, *end = base + size;
+    quint32 version, bom, count;
+    if (size < (qint64)sizeof(MAGIC) || memcmp(p, MAGIC, sizeof(MAGIC)) != 0) return false;
+    p += sizeof(MAGIC);
+    if (!getU32(p, end, version) || version != VERSION) return false;
+    if (!getU32(p, end, bom) || bom != BYTE_ORDER_MARK) return false;
+    if (!getU32(p, end, count)) return false;
+
+    for (quint32 i = 0; i < count; i++) {
+        quint32 id, nStamps;
+        if (!getU32(p, end, id) || id >= SectionCount) return false;
+        if (!getU32(p, end, nStamps) || nStamps > (quint32)sourcesOf((Section)id).size()) return false;
+        Entry& e = entries[id];
+        e.stamps.resize(nStamps);
+        for (quint32 j = 0; j < nStamps; j++) {
+            if (!getI64(p, end, e.stamps[j].size) || !getI64(p, end, e.stamps[j].mtime)) return false;
+            if (end - p < MD5_SIZE) return false;
+            e.stamps[j].md5 = QByteArray(p, MD5_SIZE);
+            p += MD5_SIZE;
+        }
+        qint64 offset, length;
+        if (!getI64(p, end, offset) || !getI64(p, end, length)) return false;
+        if (offset < 0 || length < 0 || offset > size || length > size - offset) return false;
+        e.data = base + offset;
+        e.length = length;
+        e.present = true;
+    }
+    return true;
+}
+
+/*!
+ * \fn DictSnapshot::close
+ * \brief Unmaps the snapshot; the sections read from it are no longer available.
+ */
+void DictSnapshot::close()
+{
+    if (base) file.unmap((uchar*)base);
+    base = nullptr;
+    if (file.isOpen()) file.close();
+    for (int s = 0; s < SectionCount; s++) {
+        if (!entries[s].stored) entries[s] = Entry();
+    }
+}
+
+/*!
+ * \fn DictSnapshot::isCurrent
+ * \brief A section is current when all its source files still have the stored size and
+ *        either the same modification time or, if only the time changed, the same MD5.
+ * \param s
+ * \return
+ */
+bool DictSnapshot::isCurrent(Section s)
+{
+    Entry& e = entries[s];
+    if (e.current >= 0) return e.current;
+
+    QStringList sources = sourcesOf(s);
+    e.current = e.present && e.stamps.size() == (size_t)sources.size();
+    for (int i = 0; e.current && i < sources.size(); i++) {
+        const Stamp& old = e.stamps[i];
+        Stamp now = stampOf(sources[i], false);
+        if (now.size != old.size) e.current = 0;
+        else if (now.size >= 0 && now.mtime != old.mtime)
+            e.current = stampOf(sources[i], true).md5 == old.md5;
+    }
+    return e.current;
+}
+
+/*!
+ * \fn DictSnapshot::section
+ * \param s
+ * \param p set to the start of the section
+ * \param end set to the end of the section
+ * \return false if the section has to be rebuilt from the source files
+ */
+bool DictSnapshot::section(Section s, const char*& p, const char*& end)
+{
+    if (!base || !isCurrent(s)) return false;
+    p = entries[s].data;
+    end = p + entries[s].length;
+    return true;
+}
+
+/*!
+ * \fn DictSnapshot::store
+ * \brief Keeps the new contents of a section along with the current stamps of its sources
+ * \param s
+ * \param data
+ */
+void DictSnapshot::store(Section s, const string& data)
+{
+    Entry& e = entries[s];
+    QStringList sources = sourcesOf(s);
+    e.newStamps.clear();
+    for (int i = 0; i < sources.size(); i++) e.newStamps.push_back(stampOf(sources[i], true));
+    e.newData = data;
+    e.stored = true;
+    dirty = true;
+}
+
+/*!
+ * \fn DictSnapshot::save
+ * \brief Writes the stored sections and the unchanged ones of the old snapshot to a new file
+ * \return
+ */
+bool DictSnapshot::save()
+{
+    if (!dirty) return true;
+
+    //! Sections kept from the old snapshot are copied before it is unmapped
+    vector<int> ids;
+    vector<const vector<Stamp>*> stamps;
+    vector<string> bodies;
+    for (int s = 0; s < SectionCount; s++) {
+        Entry& e = entries[s];
+        if (e.stored) {
+            ids.push_back(s);
+            stamps.push_back(&e.newStamps);
+            bodies.push_back(string());
+            bodies.back().swap(e.newData);
+        } else if (base && isCurrent((Section)s)) {
+            ids.push_back(s);
+            stamps.push_back(&e.stamps);
+            bodies.push_back(string(e.data, e.length));
+        }
+    }
+
+    string header(MAGIC, sizeof(MAGIC));
+    putU32(header, VERSION);
+    putU32(header, BYTE_ORDER_MARK);
+    putU32(header, (quint32)ids.size());
+    size_t headerSize = header.size();
+    for (size_t i = 0; i < ids.size(); i++)
+        headerSize += 2 * sizeof(quint32) + stamps[i]->size() * (2 * sizeof(qint64) + MD5_SIZE) + 2 * sizeof(qint64);
+
+    qint64 offset = headerSize;
+    for (size_t i = 0; i < ids.size(); i++) {
+        putU32(header, ids[i]);
+        putU32(header, (quint32)stamps[i]->size());
+        for (size_t j = 0; j < stamps[i]->size(); j++) {
+            const Stamp& st = (*stamps[i])[j];
+            putI64(header, st.size);
+            putI64(header, st.mtime);
+            header.append(st.md5.constData(), MD5_SIZE);
+        }
+        putI64(header, offset);
+        putI64(header, bodies[i].size());
+        offset += bodies[i].size();
+    }
+
+    //! The old file cannot be replaced while it is mapped
+    close();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) {
+        cout << "Error: dictionary snapshot " << path.toUtf8().constData() << " could not be written" << endl;
+        return false;
+    }
+    out.write(header.data(), header.size());
+    for (size_t i = 0; i < bodies.size(); i++) out.write(bodies[i].data(), bodies[i].size());
+    dirty = false;
+    for (int s = 0; s < SectionCount; s++) entries[s] = Entry();
+    return out.commit();
+}
+
+/*!
+ * \fn DictSnapshot::loadDict
+ * \param Dict
+ * \param TDict
+ * \return
+ */
+bool DictSnapshot::loadDict(Lexicon& Dict, trie& TDict)
+{
+    Dict.clear();
+    TDict.clear();
+    const char *p, *end;
+    if (!section(DictSection, p, end)) return false;
+
+    SectionReader r(p, end);
+    r.counts(Dict);
+    r.read(TDict);
+    if (!r.ok) { Dict.clear(); TDict.clear(); }
+    return r.ok;
+}
+
+/*!
+ * \fn DictSnapshot::storeDict
+ * \param Dict
+ * \param TDict
+ */
+void DictSnapshot::storeDict(const Lexicon& Dict, trie& TDict)
+{
+    SectionWriter w;
+    w.counts(Dict);
+    TDict.write(w.body);
+    store(DictSection, w.finish());
+}
+
+/*!
+ * \fn DictSnapshot::loadOCR
+ * \brief Restores the GEROCR/IEROCR words, the PWords derived from them and their tries
+ * \return
+ */
+bool DictSnapshot::loadOCR(Lexicon& GBook, Lexicon& IBook, Lexicon& PWords,
+                           vector<string>& vGBook, vector<string>& vIBook,
+                           trie& TGBook, trie& TGBookP, trie& TPWords, trie& TPWordsP)
+{
+    GBook.clear(); IBook.clear(); PWords.clear();
+    vGBook.clear(); vIBook.clear();
+    TGBook.clear(); TGBookP.clear(); TPWords.clear(); TPWordsP.clear();
+    const char *p, *end;
+    if (!section(OCRSection, p, end)) return false;
+
+    SectionReader r(p, end);
+    r.counts(GBook);
+    r.counts(IBook);
+    r.counts(PWords);
+    r.words(vGBook);
+    r.words(vIBook);
+    r.read(TGBook);
+    r.read(TGBookP);
+    r.read(TPWords);
+    r.read(TPWordsP);
+    if (!r.ok) {
+        GBook.clear(); IBook.clear(); PWords.clear();
+        vGBook.clear(); vIBook.clear();
+        TGBook.clear(); TGBookP.clear(); TPWords.clear(); TPWordsP.clear();
+    }
+    return r.ok;
+}
+
+/*!
+ * \fn DictSnapshot::storeOCR
+ */
+void DictSnapshot::storeOCR(const Lexicon& GBook, const Lexicon& IBook, const Lexicon& PWords,
+                            const vector<string>& vGBook, const vector<string>& vIBook,
+                            trie& TGBook, trie& TGBookP, trie& TPWords, trie& TPWordsP)
+{
+    SectionWriter w;
+    w.counts(GBook);
+    w.counts(IBook);
+    w.counts(PWords);
+    w.words(vGBook);
+    w.words(vIBook);
+    TGBook.write(w.body);
+    TGBookP.write(w.body);
+    TPWords.write(w.body);
+    TPWordsP.write(w.body);
+    store(OCRSection, w.finish());
+}
+
+/*!
+ * \fn DictSnapshot::loadCPairs
+ * \param CPairs
+ * \return
+ */
+bool DictSnapshot::loadCPairs(CorrectionPairs& CPairs)
+{
+    CPairs.clear();
+    const char *p, *end;
+    if (!section(CPairsSection, p, end)) return false;
+
+    SectionReader r(p, end);
+    uint32_t n = r.u32();
+    string key, word;
+    set<string> words;
+    for (uint32_t i = 0; i < n && r.ok; i++) {
+        r.str(key);
+        words.clear();
+        uint32_t m = r.u32();
+        for (uint32_t j = 0; j < m && r.ok; j++) {
+            r.str(word);
+            words.emplace_hint(words.end(), word);
+        }
+        CPairs.set(key, words);
+    }
+    if (!r.ok) CPairs.clear();
+    return r.ok;
+}
+
+/*!
+ * \fn DictSnapshot::storeCPairs
+ * \param CPairs
+ */
+void DictSnapshot::storeCPairs(const CorrectionPairs& CPairs)
+{
+    SectionWriter w;
+    w.u32((uint32_t)CPairs.size());
+    for (CorrectionPairs::const_iterator it = CPairs.begin(); it != CPairs.end(); ++it) {
+        w.str(it->first);
+        w.u32((uint32_t)it->second.size());
+        for (set<string>::const_iterator jt = it->second.begin(); jt != it->second.end(); ++jt) w.str(*jt);
+    }
+    store(CPairsSection, w.finish());
+}
+
+/*!
+ * \fn DictSnapshot::loadLSTM
+ * \param LSTM
+ * \return
+ */
+bool DictSnapshot::loadLSTM(map<string, string>& LSTM)
+{
+    LSTM.clear();
+    const char *p, *end;
+    if (!section(LSTMSection, p, end)) return false;
+
+    SectionReader r(p, end);
+    uint32_t n = r.u32();
+    string key, value;
+    for (uint32_t i = 0; i < n && r.ok; i++) {
+        r.str(key);
+        r.str(value);
+        LSTM.emplace_hint(LSTM.end(), key, value);
+    }
+    if (!r.ok) LSTM.clear();
+    return r.ok;
+}
+
+/*!
+ * \fn DictSnapshot::storeLSTM
+ * \param LSTM
+ */
+void DictSnapshot::storeLSTM(const map<string, string>& LSTM)
+{
+    SectionWriter w;
+    w.u32((uint32_t)LSTM.size());
+    for (map<string, string>::const_iterator it = LSTM.begin(); it != LSTM.end(); ++it) {
+        w.str(it->first);
+        w.str(it->second);
+    }
+    store(LSTMSection, w.finish());
+}
+
+/*!
+ * \fn DictSnapshot::loadConfusions
+ * \param ConfPmap
+ * \return
+ */
+bool DictSnapshot::loadConfusions(Lexicon& ConfPmap)
+{
+    ConfPmap.clear();
+    const char *p, *end;
+    if (!section(ConfusionsSection, p, end)) return false;
+
+    SectionReader r(p, end);
+    r.counts(ConfPmap);
+    if (!r.ok) ConfPmap.clear();
+    return r.ok;
+}
+
+/*!
+ * \fn DictSnapshot::storeConfusions
+ * \param ConfPmap
+ */
+void DictSnapshot::storeConfusions(const Lexicon& ConfPmap)
+{
+    SectionWriter w;
+    w.counts(ConfPmap);
+    store(ConfusionsSection, w.finish());
+}
@@ -0,0 +1,97 @@
+#ifndef DICTSNAPSHOT_H
+#define DICTSNAPSHOT_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "trieEditdis.h"
+#include "correctionpairs.h"
+
+using namespace std;
+
+/*
+ * Binary snapshot of the data LoadDataWorker builds from the files in Dicts/.
+ * The snapshot is kept in the user's cache directory, one file per project, and
+ * is split in sections, each tied to the source files it was built from (size,
+ * modification time and MD5). A section is used only while its sources are
+ * unchanged, so editing one file rebuilds just that section on the next open.
+ * Every section starts with its own string pool; the tables refer to pooled
+ * strings by index. Lexicons and tries are stored as their own pools and arrays
+ * and are copied back in bulk instead of being rebuilt word by word; the keys of
+ * a lexicon are hashed once more to check its tables (see Lexicon::read).
+ * The file is memory mapped while it is read, but every section is copied out
+ * of the mapping, nothing refers to it once the load is done.
+ */
+class DictSnapshot
+{
+public:
+    enum Section { DictSection, OCRSection, CPairsSection, LSTMSection, ConfusionsSection, SectionCount };
+
+    //! Bump whenever the layout or the way the source files are parsed changes
+    static const quint32 VERSION = 2;
+
+    explicit DictSnapshot(const QString& projectDir);
+    ~DictSnapshot();
+
+    //! The load functions clear their containers first and return false if the section is missing or stale
+    bool loadDict(Lexicon& Dict, trie& TDict);
+    void storeDict(const Lexicon& Dict, trie& TDict);
+
+    bool loadOCR(Lexicon& GBook, Lexicon& IBook, Lexicon& PWords,
+                 vector<string>& vGBook, vector<string>& vIBook,
+                 trie& TGBook, trie& TGBookP, trie& TPWords, trie& TPWordsP);
+    void storeOCR(const Lexicon& GBook, const Lexicon& IBook, const Lexicon& PWords,
+                  const vector<string>& vGBook, const vector<string>& vIBook,
+                  trie& TGBook, trie& TGBookP, trie& TPWords, trie& TPWordsP);
+
+    bool loadCPairs(CorrectionPairs& CPairs);
+    void storeCPairs(const CorrectionPairs& CPairs);
+
+    bool loadLSTM(map<string, string>& LSTM);
+    void storeLSTM(const map<string, string>& LSTM);
+
+    bool loadConfusions(Lexicon& ConfPmap);
+    void storeConfusions(const Lexicon& ConfPmap);
+
+    //! Writes the snapshot back if any section was stored
+    bool save();
+
+private:
+    struct Stamp {
+        qint64 size;    // -1 if the file does not exist
+        qint64 mtime;
+        QByteArray md5;
+    };
+
+    struct Entry {
+        bool present = false;
+        int current = -1;       // -1 not checked yet
+        vector<Stamp> stamps;
+        const char* data = nullptr;
+        quint64 length = 0;
+        bool stored = false;
+        vector<Stamp> newStamps;
+        string newData;
+    };
+
+    QString dictDir, path;
+    QFile file;
+    const char* base;
+    Entry entries[SectionCount];
+    bool dirty;
+
+    static QStringList sourcesOf(Section s);
+    Stamp stampOf(const QString& name, bool withHash) const;
+    bool open();
+    void close();
+    bool isCurrent(Section s);
+    bool section(Section s, const char*& p, const char*& end);
+    void store(Section s, const string& data);
+};
+
+#endif // DICTSNAPSHOT_H
@@ -5,6 +5,7 @@
 \sa    min(),editDist()
 */
 #include <cassert>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "eddis.h"
@@ -30,32 +31,107 @@ size_t eddis :: min(size_t x, size_t y, size_t z)
  * \brief This function takes two strings as argument then calculates the edit distance of both strings
  *        ie. minimum number of operation required to convert string first to string second then
  *        it returns the converted string
+ * \details Uses the bit-parallel algorithm of Myers (block form by Hyyrö) with the shorter
+ *          string as the pattern, which takes O(ceil(m/64) * n) word operations.
  * \param A
  * \param B
- * \return M[A.size()][B.size()]
- * \sa min()
+ * \return Levenshtein distance between A and B
+ * \sa min(), editDistBatch()
  */
 size_t eddis::editDist(const string& A, const string& B)
 {
-    size_t NA = A.size();
-       size_t NB = B.size();
+    const string& P = (A.size() <= B.size()) ? A : B;
+    const string& T = (A.size() <= B.size()) ? B : A;
 
-       vector<vector<size_t>> M(NA + 1, vector<size_t>(NB + 1));
+    if (P.empty()) return T.size();
 
-       for (size_t a = 0; a <= NA; ++a)
-           M[a][0] = a;
+    buildPeq(P);
+    return myersDist(P.size(), T);
+}
+
+/*!
+ * \fn eddis::editDistBatch
+ * \brief Computes editDist(query, candidates[i]) for every candidate, building the pattern
+ *        masks of the query only once.
+ * \param query
+ * \param candidates
+ * \param out receives one distance per candidate
+ */
+void eddis::editDistBatch(const string& query, const vector<string>& candidates, vector<size_t>& out)
+{
+    out.resize(candidates.size());
+    if (query.empty()) {
+        for (size_t i = 0; i < candidates.size(); ++i) out[i] = candidates[i].size();
+        return;
+    }
+
+    buildPeq(query);
+    for (size_t i = 0; i < candidates.size(); ++i)
+        out[i] = candidates[i].empty() ? query.size() : myersDist(query.size(), candidates[i]);
+}
+
+/*!
+ * \fn eddis::buildPeq
+ * \brief Sets bit i of block i/64 in the mask of byte P[i].
+ * \param P
+ */
+void eddis::buildPeq(const string& P)
+{
+    blocks = (P.size() + 63) / 64;
+    peq.assign(256 * blocks, 0);
+    for (size_t i = 0; i < P.size(); ++i)
+        peq[(unsigned char)P[i] * blocks + i / 64] |= (uint64_t)1 << (i % 64);
+}
+
+/*!
+ * \fn eddis::myersDist
+ * \brief Global edit distance between the pattern held in peq (of length m) and T.
+ *        Each block keeps the vertical +1/-1 deltas of its 64 DP cells; the horizontal delta
+ *        leaving one block is carried into the next one.
+ * \param m pattern length
+ * \param T
+ * \return
+ */
+size_t eddis::myersDist(size_t m, const string& T)
+{
+    static const uint64_t high = (uint64_t)1 << 63;
+    const uint64_t last = (uint64_t)1 << ((m - 1) % 64);
+
+    Pv.assign(blocks, ~(uint64_t)0);
+    Mv.assign(blocks, 0);
+    size_t score = m;
+
+    for (size_t j = 0; j < T.size(); ++j) {
+        const uint64_t* Eqs = &peq[(unsigned char)T[j] * blocks];
+        int hin = 1;   // first row is D[0][j] = j
+
+        for (size_t b = 0; b < blocks; ++b) {
+            uint64_t Eq = Eqs[b];
+            uint64_t pv = Pv[b], mv = Mv[b];
+            uint64_t hbit = (b + 1 == blocks) ? last : high;
+
+            uint64_t Xv = Eq | mv;
+            if (hin < 0) Eq |= 1;
+            uint64_t Xh = (((Eq & pv) + pv) ^ pv) | Eq;
+            uint64_t Ph = mv | ~(Xh | pv);
+            uint64_t Mh = pv & Xh;
+
+            int hout = 0;
+            if (Ph & hbit) hout = 1;
+            else if (Mh & hbit) hout = -1;
+
+            Ph <<= 1;
+            Mh <<= 1;
+            if (hin < 0) Mh |= 1;
+            else if (hin > 0) Ph |= 1;
 
-       for (size_t b = 0; b <= NB; ++b)
-           M[0][b] = b;
+            Pv[b] = Mh | ~(Xv | Ph);
+            Mv[b] = Ph & Xv;
+            hin = hout;
+        }
 
-       for (size_t a = 1; a <= NA; ++a)
-           for (size_t b = 1; b <= NB; ++b)
-           {
-               size_t x = M[a-1][b] + 1;
-               size_t y = M[a][b-1] + 1;
-               size_t z = M[a-1][b-1] + (A[a-1] == B[b-1] ? 0 : 1);
-               M[a][b] = min(x,y,z);
-           }
+        score += hin;
+    }
 
-       return M[A.size()][B.size()];
+    return score;
 }
@@ -2,6 +2,7 @@
 #define EDDIS_H
 
 #include <cassert>
+#include <cstdint>
 #include <string>
 #include <vector>
 using namespace std;
@@ -12,6 +13,19 @@ inline size_t min(size_t x, size_t y, size_t z);
 
 size_t editDist(const string& A, const string& B);
 
+void editDistBatch(const string& query, const vector<string>& candidates, vector<size_t>& out);
+
+private:
+//! Match masks of the pattern, 64 pattern bytes per block, blocks entries per byte value
+vector<uint64_t> peq;
+size_t blocks = 0;
+//! Vertical delta vectors of the running column, one word per block
+vector<uint64_t> Pv, Mv;
+
+void buildPeq(const string& P);
+
+size_t myersDist(size_t m, const string& T);
+
 };
 
 #endif // EDDIS_H
@@ -1,4 +1,5 @@
 #include "equationeditor.h"
+#include "mainwindow.h"
 #include "qdebug.h"
 #include "qpushbutton.h"
 #include "ui_equationeditor.h"
@@ -431,6 +432,10 @@ void equationeditor::on_actionInsert_Equation_triggered()
     in<<QGuiApplication::clipboard()->text();
     file.flush();
     file.close();
+    //! the png and the Latex are committed even if the MathBran file below can't be written
+    Project &project = ((MainWindow *)(parentWidget()))->GetProject();
+    project.markForCommit(file_name);
+    project.markForCommit(file.fileName());
     //Save Mathbran notation file which will be useful in editing equations
     QFile f("../Equations_/"+count+".txt");
 
@@ -444,6 +449,7 @@ void equationeditor::on_actionInsert_Equation_triggered()
     out << typeset_edit.toMathBran();
     f.flush();
     f.close();
+    project.markForCommit(f.fileName());
 
     //Insert equation png at cursor position
     QString filename = "../Equations_/"+count+".png";
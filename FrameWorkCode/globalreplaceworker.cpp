@@ -8,8 +8,36 @@
 #include <string>
 #include <mainwindow.h>
 #include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
 #include <editdistance.h>
 
+/*!
+ * \class ReplacePageTask
+ * \brief Runs writeGlobalCPairsToFiles() for one page on the global replace thread pool
+ * \details Every task works on its own QTextDocument and HandleBbox and writes its result into its own PageJob, so pages can be processed in any order.
+ */
+class ReplacePageTask : public QRunnable
+{
+public:
+    ReplacePageTask(GlobalReplaceWorker *worker, GlobalReplaceWorker::PageJob *job, QAtomicInt *done)
+        : worker(worker), job(job), done(done) {}
+
+    void run() override
+    {
+        QTextDocument doc;
+        job->replaced = worker->writeGlobalCPairsToFiles(job->path, *job->map, &doc, job->replacements);
+        done->ref();
+    }
+
+private:
+    GlobalReplaceWorker *worker;
+    GlobalReplaceWorker::PageJob *job;
+    QAtomicInt *done;
+};
+
 
 /*!
  * \fn GlobalReplaceWorker::GlobalReplaceWorker
@@ -31,6 +59,8 @@
  * \param x1
  * \param files
  * \param pairMap
+ * \param mRole
+ * \param editedFiles pages in the edited files log of mRole, see Project::getEditedFiles()
  */
 GlobalReplaceWorker::GlobalReplaceWorker(QObject *parent,
                                          QList<QString> *filesChangedUsingGlobalReplace,
@@ -49,7 +79,8 @@ GlobalReplaceWorker::GlobalReplaceWorker(QObject *parent,
                                          int *x1,
                                          int *files,
                                          int pairMap,
-                                         QString mRole
+                                         QString mRole,
+                                         QSet<QString> editedFiles
                                          ) : QObject(parent)
 {
     this->filesChangedUsingGlobalReplace = filesChangedUsingGlobalReplace;
@@ -72,206 +103,183 @@ GlobalReplaceWorker::GlobalReplaceWorker(QObject *parent,
     this->pairMap = pairMap;
     this->mRole = mRole;
 
-    editedFilesLogPath = gDirTwoLevelUp + "/Dicts/." +mRole+"_EditedFiles.txt";
+    this->editedFiles = editedFiles;
+
+    //! One matcher for all the words of the map, shared read only by the pages
+    QStringList words;
+    QMap<QString, QString>::const_iterator grmIterator;
+    for (grmIterator = globalReplacementMap2.constBegin(); grmIterator != globalReplacementMap2.constEnd(); ++grmIterator)
+    {
+        //if condition will avoid replacing images globally.
+        if(grmIterator.key().isEmpty() || grmIterator.key().length() == 1)
+            continue;
+        words << grmIterator.key();
+        wordReplacements << "<span style = \"background-color:#ffff00;\">" + grmIterator.value() + "</span>";
+    }
+    wordMatcher = WordMatcher(words, Qt::CaseInsensitive);
 }
 
 /*!
  * \fn GlobalReplaceWorker::writeGlobalCPairsToFiles
  * \brief This function writes the required replacements to the file specified
  * \details It copies the contents of the file to a QTextDocument which is used for replacement purpose.
+ * All the words of the map are found in one pass over the page by a WordMatcher.
+ * This is called from several pool threads at once, so it only reads the shared maps and records the replacements made in \a replacements.
  * \param file_path
  * \param globalReplacementMap
  * \param doc
+ * \param replacements source -> target of every replacement applied to the page
  * \return Number of replaced words
  */
-int GlobalReplaceWorker::writeGlobalCPairsToFiles(QString file_path, QMap<QString, QString> globalReplacementMap, QTextDocument *doc)
+int GlobalReplaceWorker::writeGlobalCPairsToFiles(QString file_path, const QMap<QString, QString> &globalReplacementMap, QTextDocument *doc, QMap<QString, QString> &replacements)
 {
     // if any file other than html is passed, just return back
     doc->clear();
     if(!file_path.endsWith(".html")){
         return 0;
     }
-    if (handleBbox != nullptr) {
-        delete handleBbox;
-    }
+    Q_UNUSED(globalReplacementMap);
 
-    QFile *file = new QFile(file_path);
-    handleBbox = new HandleBbox(doc);
-    QTextDocument *curDoc = handleBbox->loadFileInDoc(file);
+    QFile file(file_path);
+    HandleBbox handleBbox(doc);
+    QTextDocument *curDoc = handleBbox.loadFileInDoc(&file);
 
     if (curDoc == nullptr) {
         qDebug() << "Cannot load file";
         return 0;
     }
 
-    QMap <QString, QString> sentencesReplaced;
-    QMap <QString, QString>::iterator grmIterator;
-    QFile f(file_path);
-    f.open(QIODevice::ReadOnly);
     QStringList temporaryList = file_path.split("/");
     QString pageName = temporaryList.at(temporaryList.size()-1);
+    int tot_replaced = 0;
 
-    //!Set encoding and read the file content
-    QTextStream in(&f);
-    in.setCodec("UTF-8");
-    QString s1 = in.readAll();
-    f.close();
-    f.open(QIODevice::WriteOnly);
-    int replaced = 0, tot_replaced = 0;
-
-    QString replacementString1;
-    //!Replacing words by iterating the map
+    //!Replacing words of the map in one pass
     if(pairMap)
     {
-        QMap< QPair<QString,QString>,QString>::iterator grmIterator;
-        QMap<QString, QString>::Iterator itr;
-        for (grmIterator = globalReplacementMapAfterCheck.begin(); grmIterator != globalReplacementMapAfterCheck.end(); ++grmIterator)
+        //! const iterators only: a non-const begin() would detach the shared map from several threads
+        QMap< QPair<QString,QString>,QString>::const_iterator grmIterator;
+        QStringList sentences, htmlReplacements;
+        for (grmIterator = globalReplacementMapAfterCheck.constBegin(); grmIterator != globalReplacementMapAfterCheck.constEnd(); ++grmIterator)
         {
             if(pageName != grmIterator.key().second)
             {
                 continue;
             }
-//            qDebug()<<"Going to replace in ::"<<pageName;
             QString sanstr(grmIterator.value());
             //if condition will avoid replacing images globally.
             if(sanstr.isEmpty() || sanstr.length() == 1)
                 continue;
-            sanstr.replace("\(","\\(");sanstr.replace("\)","\\)");
             sanstr = sanstr.trimmed();
-            QString replacementString = grmIterator.key().first; // \1 would be replace by the first paranthesis i.e. the \b  and \2 would be replaced by the second \b by QT Regex
-            QStringList org_sen = sanstr.split(" ");
-
-
-            std::string rep = replacementString.toStdString();
-            QString::fromStdString(rep).toUtf8();
-            QString replacement = QString::fromStdString(rep);
-
-            QStringList replaced_list = replacement.split(" ");
-            QString replaced_sen = replacement;
-            for(itr = sentencesReplaced.begin(); itr != sentencesReplaced.end(); ++itr){
-                qDebug()<<sanstr<<" :: "<<itr.key();
-                if(sanstr.contains(itr.key())){
-                    sanstr = sanstr.replace(itr.key(),itr.value());
-                    replacementString = replacementString.replace(itr.key(),"<span style = \"background-color:#ffff00;\">"+itr.value()+"</span>");
-                }
-            }
-
-            std::string str = replacementString.toStdString();
-            QString::fromStdString(str).toUtf8();
-            replacementString1 = QString::fromStdString(str);
-            (*mapOfReplacements)[grmIterator.value()] = grmIterator.key().first.trimmed();
-            //browser->moveCursor(QTextCursor::Start);
+            QString replacementString = grmIterator.key().first.trimmed();
+            replacements[grmIterator.value()] = replacementString;
 
-            QRegularExpression re(sanstr);
             //Code to highlight replaced words only; finding sentence1 -sentence2
+            QStringList org_sen = sanstr.split(" ");
+            QStringList replaced_list = replacementString.split(" ");
+            QString replaced_sen = replacementString;
             for(int i=0; i<org_sen.size(); i++){
                 if(replaced_list.contains(org_sen[i]))
                     replaced_sen = replaced_sen.remove(org_sen[i]);
             }
             replaced_sen = replaced_sen.trimmed();
-            qDebug() <<"original :"<<sanstr;
-            QTextCursor docCursor(doc);
-            docCursor.movePosition(QTextCursor::Start, QTextCursor::MoveAnchor);
-            int startPos = 0;
-
-            while (true) {
-                QTextCursor cur = doc->find(re, startPos, QTextDocument::FindWholeWords);
-                QTextCursor origCur(cur);
-                if (cur.isNull()) {
-                    break;
-                }
-
-                QTextCharFormat fmt;
-                startPos = cur.position() + 1;
-                int pos = cur.position(); // get the cursor position
-                int ancr = pos - replacementString.size() + 1; // anchor is now cursor position - length of old word to be replaced
+            QString final_str = replacementString;
+            final_str = final_str.replace(replaced_sen, "<span style = \"background-color:#ffff00;\">" + replaced_sen + "</span>");
 
-                if (pos < ancr) {
-                    cur.setPosition(pos, QTextCursor::MoveAnchor);
-                    cur.setPosition(ancr, QTextCursor::KeepAnchor);
-                }
-                fmt = cur.charFormat(); // get the QTextCharFormat of old/word phrase to be replaced
-                replacementString1 = replacementString.trimmed();
-                QString final_str = replacementString1;
-                final_str = final_str.replace(replaced_sen, "<span style = \"background-color:#ffff00;\">" + replaced_sen + "</span>");
-                origCur.insertHtml(final_str);
-                cur.setPosition(origCur.position());
-                pos = cur.position();
-                ancr = pos - replacementString1.size();
-                cur.setPosition(pos, QTextCursor::MoveAnchor);
-                cur.mergeCharFormat(fmt); // apply the text properties captured earlier
-                tot_replaced += 1;
-                sentencesReplaced.insert(sanstr, replacementString1);
-            }
+            sentences << sanstr;
+            htmlReplacements << final_str;
+        }
+        if(!sentences.isEmpty())
+        {
+            WordMatcher matcher(sentences, Qt::CaseInsensitive);
+            tot_replaced = matcher.replaceInDocument(doc, htmlReplacements, true);
         }
     }
     else
     {
-        QMap<QString,QString>::iterator grmIterator;
-        for (grmIterator = globalReplacementMap2.begin(); grmIterator != globalReplacementMap2.end(); ++grmIterator)
+        QMap<QString,QString>::const_iterator grmIterator;
+        for (grmIterator = globalReplacementMap2.constBegin(); grmIterator != globalReplacementMap2.constEnd(); ++grmIterator)
         {
-            QString sanstr(grmIterator.key());
             //if condition will avoid replacing images globally.
-            if(sanstr.isEmpty() || sanstr.length() == 1)
+            if(grmIterator.key().isEmpty() || grmIterator.key().length() == 1)
                 continue;
-            sanstr.replace("\(","\\(");sanstr.replace("\)","\\)");
-            QRegularExpression re(sanstr);
-            QString replacementString = grmIterator.value(); // \1 would be replace by the first paranthesis i.e. the \b  and \2 would be replaced by the second \b by QT Regex
-            std::string str = replacementString.toStdString();
-            QString::fromStdString(str).toUtf8();
-            replacementString1 = QString::fromStdString(str);
-            (*mapOfReplacements)[grmIterator.key()] = grmIterator.value().trimmed();
-            QTextCursor docCursor(doc);
-            docCursor.movePosition(QTextCursor::Start, QTextCursor::MoveAnchor);
-
-            int startPos = 0;
-            while (true) {
-                QTextCursor cur = doc->find(re, startPos, QTextDocument::FindWholeWords);
-                QTextCursor origCur(cur);
-                if (cur.isNull()) {
-                    break;
-                }
-                QTextCharFormat fmt;
-                startPos = cur.position() + 1;
-                int pos = cur.position(); //get the cursor position
-                int ancr = pos - replacementString.size() + 1; //anchor is now cursor position - length of old word to be replaced
-                if (pos < ancr) {
-                    cur.setPosition(pos, QTextCursor::MoveAnchor);
-                    cur.setPosition(ancr, QTextCursor::KeepAnchor);
-                }
-                fmt = cur.charFormat(); //get the QTextCharFormat of old word/phrase to be replaced
-                origCur.insertHtml("<span style = \"background-color:#ffff00;\">" + replacementString1 + "</span>");
-                pos = cur.position();
-                ancr = pos - replacementString1.size();//anchor is cursor position - new word/phrase length
-                cur.setPosition(pos, QTextCursor::MoveAnchor);
-                cur.setPosition(ancr, QTextCursor::KeepAnchor);
-                cur.mergeCharFormat(fmt); //apply the text properties captured earlier
-                tot_replaced += 1;
-            }
+            replacements[grmIterator.key()] = grmIterator.value().trimmed();
         }
+        tot_replaced = wordMatcher.replaceInDocument(doc, wordReplacements, true);
+    }
+    //! the page is written once, with its bboxes already in place
+    QString s1 = handleBbox.insertBboxes(doc->toHtml());
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        QTextStream out(&file);
+        out.setCodec("UTF-8");
+        out << s1;
+        out.flush();
+        file.close();
     }
-    s1 = doc->toHtml();
-    in << s1;
-    f.flush();
-    f.close();
-    handleBbox->insertBboxes(file);
     return tot_replaced;
 }
 
+/*!
+ * \fn GlobalReplaceWorker::replaceInPages
+ * \brief Runs writeGlobalCPairsToFiles() on every page of \a jobs on a thread pool of QThread::idealThreadCount() threads and merges the results.
+ * \details Each page is one task. While the pool works this thread reports the progress, scaled to [progressFrom, progressTo].
+ * The results are merged in the order of \a jobs, so r1, r2, files and mapOfReplacements end up the same as when the pages are processed one after the other.
+ * \param jobs
+ * \param progressFrom
+ * \param progressTo
+ */
+void GlobalReplaceWorker::replaceInPages(QVector<PageJob> &jobs, int progressFrom, int progressTo)
+{
+    int total = jobs.size();
+    if (total == 0)
+        return;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    QAtomicInt done(0);
+    for (int i = 0; i < total; i++) {
+        jobs[i].replaced = 0;
+        pool.start(new ReplacePageTask(this, &jobs[i], &done));
+    }
+
+    int perc = progressFrom; // percentage to be shown on progress bar
+    bool finished = false;
+    while (!finished) {
+        finished = pool.waitForDone(100);
+        int count = finished ? total : done.load();
+        int tempPerc = progressFrom + (count * (progressTo - progressFrom)) / total;
+        if (tempPerc > perc) {
+            perc = tempPerc;
+            emit changeProgressBarValue(perc);
+            int estimationTime = (total - count) * 1 / (60 * pool.maxThreadCount());
+            if (estimationTime > 0)
+                emit changeProgressText(estimationTime);
+        }
+    }
+
+    for (int i = 0; i < total; i++) {
+        *r1 = jobs[i].replaced;
+        *r2 = *r2 + *r1;
+        if (*r1 > 0)
+            (*files)++;
+        QMap<QString, QString>::const_iterator itr;
+        for (itr = jobs[i].replacements.constBegin(); itr != jobs[i].replacements.constEnd(); ++itr)
+            (*mapOfReplacements)[itr.key()] = itr.value();
+    }
+}
+
 /*!
  * \fn GlobalReplaceWorker::replaceWordsInFiles
  * \brief This function traverses the user role's dir and filters the html files and passes the required files to writeGlobalCPairsToFiles() function for replacing the required replacements. It also emits the signal for updating progress bar.
+ * \details The pages of a pass are collected first and then replaced in parallel by replaceInPages(). With more than one changed word the
+ * unedited pages pass (0-50%) finishes before the all pages pass (50-100%) starts, as the second pass may rewrite the same pages.
  */
 void GlobalReplaceWorker::replaceWordsInFiles()
 {
-    QTextDocument* doc = new QTextDocument();
-    QDirIterator dirIterator(currentFileDirectory, QDirIterator::Subdirectories);
     QDir currDir(currentFileDirectory);
     QString suffix;
     QString toolMode = currentFileDirectory.right(currentFileDirectory.size() - currentFileDirectory.lastIndexOf('/') - 1);
 
-
-
     if (toolMode == "CorrectorOutput" || toolMode == "VerifierOutput")
     {
         suffix = "*.html";
@@ -286,139 +294,52 @@ void GlobalReplaceWorker::replaceWordsInFiles()
     //Change -> to see number of html files
     qDebug()<<numberOfFiles;
 
-    int count = 0;
-    int perc = 0; // percentage to be shown on progress bar
-    int estimationTime = numberOfFiles * 1 / 60 ;
+    int estimationTime = numberOfFiles * 1 / (60 * QThread::idealThreadCount());
     emit changeProgressText(estimationTime);
 
-    if (numOfChangedWords == 1)
-    {
-        if (check == 0)
-        {
-            while (dirIterator.hasNext()) {
-                QString it_file_path = dirIterator.next();
-                bool isFileInEditedFilesLog = isStringInFile(editedFilesLogPath, it_file_path);
-                QString suff = dirIterator.fileInfo().completeSuffix();
-                if(!isFileInEditedFilesLog)
-                {
-                    (*filesChangedUsingGlobalReplace).append(it_file_path);
-                    if(suff == "html") {
-                        *r1 = writeGlobalCPairsToFiles(it_file_path, globalReplacementMap, doc);
-                        *r2 = *r2 + *r1;
-                        if(*r1 > 0)
-                            (*files)++;
-                    }
-                    else if(suff != "dict"){
-                        *x1 = writeGlobalCPairsToFiles(it_file_path, globalReplacementMap, doc);
-                    }
-                }
-                count++;
-                estimationTime = (numberOfFiles - count) * 1 / 60;
-                int tempPerc = (count * 100) / numberOfFiles;
-                if (tempPerc > perc) {
-                    perc = tempPerc;
-                    emit changeProgressBarValue(perc);
-                    if(estimationTime > numberOfFiles * 1 /120) {
-                        emit changeProgressText(estimationTime);
-                    }
-                }
+    //! Collects the pages of one pass; skipEdited leaves out the pages listed in the edited files log
+    auto collectPages = [&](const QMap<QString, QString> &map, bool skipEdited) {
+        QVector<PageJob> jobs;
+        QDirIterator dirIterator(currentFileDirectory, QDirIterator::Subdirectories);
+        while (dirIterator.hasNext()) {
+            QString it_file_path = dirIterator.next();
+            if (skipEdited && editedFiles.contains(it_file_path))
+                continue;
+            QString suff = dirIterator.fileInfo().completeSuffix();
+            (*filesChangedUsingGlobalReplace).append(it_file_path);
+            if (suff == "html") {
+                PageJob job;
+                job.path = it_file_path;
+                job.map = &map;
+                job.replaced = 0;
+                jobs.append(job);
+            }
+            else if (suff != "dict") {
+                *x1 = 0; // only html pages are replaced in
             }
         }
-        else if (check == 1)
+        return jobs;
+    };
+
+    if (numOfChangedWords == 1)
+    {
+        if (check == 0 || check == 1)
         {
-            while (dirIterator.hasNext()) {
-                QString it_file_path = dirIterator.next();
-                QString suff = dirIterator.fileInfo().completeSuffix();
-                (*filesChangedUsingGlobalReplace).append(it_file_path);
-                if(suff == "html") {
-                    *r1 = writeGlobalCPairsToFiles(it_file_path, globalReplacementMap, doc);
-                    *r2 = *r2 + *r1;
-                    if(*r1 > 0)
-                        (*files)++;
-                }
-                else if(suff != "dict"){
-                    *x1 = writeGlobalCPairsToFiles(it_file_path, globalReplacementMap, doc);
-                }
-                count++;
-                estimationTime = (numberOfFiles - count) * 1 / 60;
-
-                int tempPerc = (count * 100) / numberOfFiles;
-                if (tempPerc > perc) {
-                    perc = tempPerc;
-                    emit changeProgressBarValue(perc);
-                    if(estimationTime > numberOfFiles * 1 /120) {
-                        emit changeProgressText(estimationTime);
-                    }
-                }
-            }
+            QVector<PageJob> jobs = collectPages(globalReplacementMap, check == 0);
+            replaceInPages(jobs, 0, 100);
         }
     }
     else if (numOfChangedWords > 1)
     {
         //! Replacing in Unedited pages
-        while (dirIterator.hasNext())
-        {
-            QString it_file_path = dirIterator.next();
-            bool isFileInEditedFilesLog = isStringInFile(editedFilesLogPath, it_file_path);
-            QString suff = dirIterator.fileInfo().completeSuffix();
-            if (!isFileInEditedFilesLog)
-            {
-                (*filesChangedUsingGlobalReplace).append(it_file_path);
-                if(suff == "html") {
-                    *r1 = writeGlobalCPairsToFiles(it_file_path, replaceInUneditedPages_Map, doc);
-                    *r2 = *r2 + *r1;
-                    if(*r1 > 0)
-                        (*files)++;
-                }
-                else if(suff != "dict"){
-                    *x1 = writeGlobalCPairsToFiles(it_file_path, globalReplacementMap, doc);
-                }
-            }
-            count++;
-            estimationTime = (numberOfFiles - count) * 1 / 60;
-            int tempPerc = (count * 100) / numberOfFiles;
-            if ((tempPerc > perc) && (tempPerc < 50)) {
-                perc = tempPerc;
-                emit changeProgressBarValue(perc);
-                if(estimationTime > numberOfFiles * 1 /120) {
-                    emit changeProgressText(estimationTime);
-                }
-            }
-        }
+        QVector<PageJob> jobs = collectPages(replaceInUneditedPages_Map, true);
+        replaceInPages(jobs, 0, 50);
         emit changeProgressBarValue(50);
         emit changeProgressText(numberOfFiles * 1 /120);
-        count = 0;
-        perc = 0;
-
-        QDirIterator dirIterator_2(currentFileDirectory, QDirIterator::Subdirectories);
 
         //! Replacing in all pages
-        while (dirIterator_2.hasNext())
-        {
-            QString it_file_path = dirIterator_2.next();
-            QString suff = dirIterator_2.fileInfo().completeSuffix();
-            (*filesChangedUsingGlobalReplace).append(it_file_path);
-            if(suff == "html") {
-                *r1 = writeGlobalCPairsToFiles(it_file_path, replaceInAllPages_Map, doc);
-                *r2 = *r2 + *r1;
-                if(*r1 > 0)
-                    (*files)++;
-            }
-            else if(suff != "dict"){
-                *x1 = writeGlobalCPairsToFiles(it_file_path, globalReplacementMap, doc);
-            }
-
-            count++;
-            estimationTime = (numberOfFiles-count) * 5/60;
-            int tempPerc = (count * 100) / numberOfFiles;
-            if ((tempPerc > perc) && (tempPerc > 50)) {
-                perc = tempPerc;
-                emit changeProgressBarValue(perc);
-                if(estimationTime > 0 && estimationTime < numberOfFiles * 1 /120){
-                    emit changeProgressText(estimationTime);
-                }
-            }
-        }
+        jobs = collectPages(replaceInAllPages_Map, false);
+        replaceInPages(jobs, 50, 100);
     }
 
     emit changeProgressBarValue(100);
@@ -487,36 +408,6 @@ void GlobalReplaceWorker::writeLogs()
     emit finishedWritingLogs();
 }
 
-/*!
- * \fn GlobalReplaceWorker::isStringInFile
- * \brief Checks if a QString is in file at file_path
- * \param file_path
- * \param searchString
- * \return 0 if not present and 1 if it is present
- */
-bool GlobalReplaceWorker::isStringInFile(QString file_path, QString searchString)
-{
-    QFile fileToSearchIn(file_path);
-    bool textFound = false;
-
-    if(fileToSearchIn.open(QIODevice::ReadOnly | QIODevice::Text)){
-        QTextStream in(&fileToSearchIn);
-        QString line;
-
-        //! Check in everyline if string exists
-        do{
-            line = in.readLine();
-            if(line.contains(searchString)){
-                textFound = true;
-                break;
-            }
-        }while(!line.isNull());
-    }
-    fileToSearchIn.close();
-
-    return textFound;
-}
-
 /*!
  * \fn GlobalReplaceWorker::saveBboxInfo
  * \brief Saves the bbox info
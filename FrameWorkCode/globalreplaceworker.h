@@ -3,7 +3,10 @@
 
 #include <QObject>
 #include <QMap>
+#include <QVector>
+#include <QSet>
 #include "handlebbox.h"
+#include "wordmatcher.h"
 
 class QTextBrowser;
 
@@ -29,7 +32,8 @@ public:
             int *x1 = nullptr,
             int *files = nullptr,
             int pairMap = 1,
-            QString mRole ="Corrector"
+            QString mRole ="Corrector",
+            QSet<QString> editedFiles = {}
             );
     int pairMap;
 
@@ -41,16 +45,26 @@ private:
     QMap<QString, QString> *mapOfReplacements;
     QMap<QString, QString> replaceInAllPages_Map;
     QMap<QString, QString> replaceInUneditedPages_Map;
+    WordMatcher wordMatcher;
+    QStringList wordReplacements;
 
     QString currentFileDirectory;
     QString gDirTwoLevelUp;
     QString gCurrentPageName;
-    QString editedFilesLogPath;
+    QSet<QString> editedFiles;
     int numOfChangedWords, check, *r1, *r2, *x1, *files;
 
-    int writeGlobalCPairsToFiles(QString file_path, QMap <QString, QString> globalReplacementMap, QTextDocument* doc);
-    bool isStringInFile(QString file_path, QString searchString);
-    HandleBbox *handleBbox = nullptr;
+    //! One page of a replace pass, filled in by the task that processes it
+    struct PageJob {
+        QString path;
+        const QMap<QString, QString> *map;
+        int replaced;
+        QMap<QString, QString> replacements;
+    };
+    friend class ReplacePageTask;
+
+    int writeGlobalCPairsToFiles(QString file_path, const QMap <QString, QString> &globalReplacementMap, QTextDocument* doc, QMap<QString, QString> &replacements);
+    void replaceInPages(QVector<PageJob> &jobs, int progressFrom, int progressTo);
     QString mRole;
 
 public slots:
@@ -259,9 +259,9 @@ QTextDocument *HandleBbox::loadFileInDoc(QFile *f)
 //    cur.deleteChar();
 //    f->close();
 
+    storeBboxes(line);
     line = latex2png(line);
     cur.insertHtml(line);
-    storeBboxes(f);
     return doc;
 }
 
@@ -271,10 +271,8 @@ QTextDocument *HandleBbox::loadFileInDoc(QFile *f)
  * \brief Inserts the boxes into the file
  * \details
  * if file is not available for writing mode,function terminates
- * all the lines of file are read and stored in varaible(input)
- * If bbox is already present, move to next entry
- * tages for table, image are added
- * are successfull insertion the file is flushed and closed
+ * the file is read once, the bboxes are inserted by insertBboxes(const QString &)
+ * and the result is written back
  */
 void HandleBbox::insertBboxes(QFile *file)
 {
@@ -282,48 +280,74 @@ void HandleBbox::insertBboxes(QFile *file)
         qDebug() << "Cannot open file for writing";
         return;
     }
-    QString input = file->readAll();
+    QString input = insertBboxes(QString(file->readAll()));
+    file->close();
+
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "Cannot open file for writing";
+        return;
+    }
+
+    QTextStream out(file);
+    out.setCodec("utf-8");
+    out << input;
+    out.flush();
     file->close();
-    QRegularExpression regex_p("(<p[^>]*>|</p>|<img[^>]*>|<table[^>]*>|<td[^>]*>|</table>)");
-    QRegularExpressionMatchIterator itr = regex_p.globalMatch(input);
+}
+
+/*!
+ * \fn HandleBbox::insertBboxes
+ * \param html
+ * \brief Returns html with the stored bboxes put back as title attributes
+ * \details
+ * The tags are read in one pass from the start; the text between them is copied as it is into a buffer
+ * that is allocated once, so callers that have the html of a page can insert the bboxes before writing it.
+ * If bbox is already present, move to next entry
+ * tags for paragraphs, table, cells and image are given the next bbox
+ */
+QString HandleBbox::insertBboxes(const QString &html) const
+{
+    int extra = 0;
+    for (const auto &bbox : bboxes)
+        extra += bbox.second.size() + 9;    // title=""
+    QString output;
+    output.reserve(html.size() + extra);
 
     int i = 0;
     bool inTable = false;
     bool inPara = false;
-    int increment = 0;
     QString currentTag;
-    while (itr.hasNext() && i < bboxes.size()) {
-        QRegularExpressionMatch match = itr.next();
-        QString htmlTagData = match.captured(1);
-        int end = match.capturedEnd(1);
-
+    int copied = 0, from = 0, start, end;
+    while (i < bboxes.size() && (end = nextTag(html, from, &start)) != -1) {
+        from = end;
+        QStringRef htmlTagData = html.midRef(start, end - start);
 
-        if (htmlTagData.indexOf("title=\"bbox") != -1) {
+        if (htmlTagData.contains(QLatin1String("title=\"bbox"))) {
             i++;
             continue;
         }
 
-        if (htmlTagData.left(6) == "<table") {
+        if (htmlTagData.startsWith(QLatin1String("<table"))) {
             inTable = true;
             currentTag = "table";
-        } else if (htmlTagData.left(7) == "</table") {
+        } else if (htmlTagData.startsWith(QLatin1String("</table"))) {
             inTable = false;
             currentTag = "/table";
             continue;
-        } else if (htmlTagData.left(4) == "<img") {
+        } else if (htmlTagData.startsWith(QLatin1String("<img"))) {
             if (inPara) {
                 i--;
             }
             currentTag = "img";
-        } else if (htmlTagData.left(3) == "<td") {
+        } else if (htmlTagData.startsWith(QLatin1String("<td"))) {
             currentTag = "td";
-        } else if (htmlTagData.left(2) == "<p") {
+        } else if (htmlTagData.startsWith(QLatin1String("<p"))) {
             if (inTable) {
                 continue;
             }
             currentTag = "p";
             inPara = true;
-        } else if (htmlTagData.left(3) == "</p") {
+        } else if (htmlTagData.startsWith(QLatin1String("</p"))) {
             inPara = false;
             continue;
         }
@@ -331,64 +355,71 @@ void HandleBbox::insertBboxes(QFile *file)
         if (bboxes[i].first != currentTag) {
             qDebug() << "tags not matching at " << i;
         }
-        QString temp = " title=\"" + bboxes[i++].second + "\"";
-        increment += temp.length();
 
-        if (currentTag == "img") {
-            input.insert(end - 2, temp);
-        } else {
-            input.insert(end - 1, temp);
-        }
-
-        itr = regex_p.globalMatch(input, end + 1);
+        //! before the '>' of the tag, or before the "/>" of an image
+        int at = (currentTag == "img") ? end - 2 : end - 1;
+        output.append(html.midRef(copied, at - copied));
+        output.append(QLatin1String(" title=\"")).append(bboxes[i++].second).append(QLatin1Char('"'));
+        copied = at;
     }
+    output.append(html.midRef(copied));
+    return output;
+}
 
-    if (!file->open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Cannot open file for writing";
-        return;
+/*!
+ * \fn HandleBbox::nextTag
+ * \param html
+ * \param from
+ * \param start  position of the '<' of the tag found
+ * \brief Finds the next tag that can carry a bbox: <p..>, </p>, <img..>, <table..>, <td..> or </table>
+ * \return position after the '>' of the tag, -1 if there is no such tag left
+ */
+int HandleBbox::nextTag(const QString &html, int from, int *start)
+{
+    for (int pos = html.indexOf(QLatin1Char('<'), from); pos != -1; pos = html.indexOf(QLatin1Char('<'), pos + 1)) {
+        QStringRef rest = html.midRef(pos + 1);
+        if (rest.startsWith(QLatin1String("/p>"))) {
+            *start = pos;
+            return pos + 4;
+        }
+        if (rest.startsWith(QLatin1String("/table>"))) {
+            *start = pos;
+            return pos + 8;
+        }
+        if (rest.startsWith(QLatin1Char('p')) || rest.startsWith(QLatin1String("img"))
+                || rest.startsWith(QLatin1String("table")) || rest.startsWith(QLatin1String("td"))) {
+            int close = html.indexOf(QLatin1Char('>'), pos + 1);
+            if (close == -1)
+                return -1;      // no tag can end after this point
+            *start = pos;
+            return close + 1;
+        }
     }
-
-    QTextStream out(file);
-    out.setCodec("utf-8");
-    out << input;
-    out.flush();
-    file->close();
+    return -1;
 }
 
 /*!
  * \fn HandleBbox::storeBboxes
- * \param file
+ * \param html
  * \brief Stores the bboxes in the vector
  * \details
- * Function terminates if file is available for writing mode
- * text of the input file is read
+ * html is the content of the page as read by loadFileInDoc()
  * If bbox tag is not present,tags(variable) are set to null
- * loop itreates through the input file
+ * loop itreates through the tags of the page
  * several tags are check and stored inside bBox accordingly
  */
-void HandleBbox::storeBboxes(QFile *file)
+void HandleBbox::storeBboxes(const QString &html)
 {
-    if (!file->open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return;
-    }
-
-    QTextStream st(file);
-    QString initial = st.readAll();
-    file->close();
     bboxes.clear();
 
-    QRegularExpression rex("(<p[^>]*>|<img[^>]*>|<table[^>]*>|</table>|<td[^>]*>)");
-    QRegularExpressionMatchIterator itr;
-
-    itr = rex.globalMatch(initial);
-
     QString temp_tags;
     bool inTable = false;
 
-    while (itr.hasNext())
+    int from = 0, start, end;
+    while ((end = nextTag(html, from, &start)) != -1)
     {
-        QRegularExpressionMatch match = itr.next();
-        QString bbox_tags = match.captured(1);
+        from = end;
+        QString bbox_tags = html.mid(start, end - start);
 
         int first, last;
         first = bbox_tags.indexOf("bbox");
@@ -26,6 +26,7 @@ public:
 	~HandleBbox();
 	QTextDocument *loadFileInDoc(QFile *f);
 	void insertBboxes(QFile *f);
+	QString insertBboxes(const QString &html) const;
 	int blockCount = -1;
 	QVector<QPair<QString,QString> > bboxes;
 
@@ -33,7 +34,8 @@ private:
     QTextBlockFormat blockFormat;
 	QTextDocument *doc;
 	bool docIsPassed;
-	void storeBboxes(QFile *f);
+	void storeBboxes(const QString &html);
+	static int nextTag(const QString &html, int from, int *start);
     QString latex2png(QString);
 };
 
@@ -0,0 +1,497 @@
+/*!
+ * \class HtmlToText
+ * \brief Extracts the plain text of a saved page in one pass over its html, without building a QTextDocument
+ */
+#include "htmltotext.h"
+#include <QSet>
+
+//! Characters of &#128; to &#159;, read as windows-1252 like QTextDocument does
+static const ushort windowsLatin1ExtendedCharacters[0xA0 - 0x80] = {
+    0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021,
+    0x02c6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008d, 0x017d, 0x008f,
+    0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+    0x02dc, 0x2122, 0x0161, 0x203a, 0x0153, 0x009d, 0x017e, 0x0178
+};
+
+/*!
+ * \fn HtmlToText::toPlainText
+ * \param html
+ * \return
+ */
+QString HtmlToText::toPlainText(const QString &html)
+{
+    HtmlToText parser(html);
+    parser.parse();
+    return parser.text;
+}
+
+/*!
+ * \fn HtmlToText::HtmlToText
+ * \param html
+ */
+HtmlToText::HtmlToText(const QString &html)
+    : html(html), pos(0), blockUsed(false), blockHasText(false), blockClosed(false), removeWhiteSpace(true), afterBlockTag(false), textEndsWithNewline(false), afterTable(false), lastCellHasText(false), firstCell(false)
+{
+    text.reserve(html.size() / 4);
+}
+
+/*!
+ * \fn HtmlToText::parse
+ */
+void HtmlToText::parse()
+{
+    int len = html.size();
+    while (pos < len) {
+        if (html.at(pos) == QLatin1Char('<')) {
+            pos++;
+            parseTag();
+            continue;
+        }
+        int end = html.indexOf(QLatin1Char('<'), pos);
+        if (end < 0)
+            end = len;
+        appendText(end);
+    }
+}
+
+/*!
+ * \fn HtmlToText::startBlock
+ * \brief Ends the current block if it is part of the text, so what follows goes to a new line
+ * \details The empty block of an open element is shared with the blocks in it, like the block of a list item with its paragraph.
+ */
+void HtmlToText::startBlock()
+{
+    removeWhiteSpace = true;
+    if (afterTable) {
+        //! the block after a table is left empty when its last cell has text
+        if (lastCellHasText)
+            text += QLatin1Char('\n');
+        afterTable = false;
+        return;
+    }
+    if (!blockClosed && !blockHasText)
+        return;
+    if (blockHasText || blockUsed)
+        text += QLatin1Char('\n');
+    blockUsed = false;
+    blockHasText = false;
+    blockClosed = false;
+}
+
+/*!
+ * \fn HtmlToText::startFrameBlock
+ * \brief Starts the block after a table frame character, which is a line break of the text whether the block before it is empty or not
+ */
+void HtmlToText::startFrameBlock()
+{
+    text += QLatin1Char('\n');
+    blockUsed = false;
+    blockHasText = false;
+    blockClosed = false;
+    afterTable = false;
+    removeWhiteSpace = true;
+}
+
+/*!
+ * \fn HtmlToText::appendText
+ * \brief Adds the text up to \a end, collapsing the whitespace unless it is pre or pre-wrap
+ * \details Text after a closed block starts a new one, but whitespace alone stays in the closed block,
+ * and a single whitespace character like the newline between two paragraphs is dropped.
+ * \param end
+ */
+void HtmlToText::appendText(int end)
+{
+    int start = pos;
+    pos = end;
+    textEndsWithNewline = end > start && html.at(end - 1) == QLatin1Char('\n');
+    if (!elements.isEmpty() && elements.last().hidden)
+        return;
+    WhiteSpace whiteSpace = elements.isEmpty() ? Normal : elements.last().whiteSpace;
+
+    if (blockClosed) {
+        int i = start;
+        while (i < end && html.at(i).isSpace() && html.at(i) != QChar::Nbsp && html.at(i) != QChar::ParagraphSeparator)
+            i++;
+        if (i == end) {
+            if ((end - start > 1 || !afterBlockTag) && whiteSpace == Normal && !removeWhiteSpace) {
+                text += QLatin1Char(' ');
+                removeWhiteSpace = true;
+            }
+            return;
+        }
+        startBlock();
+    }
+
+    for (int i = start; i < end; i++) {
+        QChar c = html.at(i);
+        if (c == QLatin1Char('&')) {
+            QString entity = parseEntity(i + 1, end, &i);
+            for (QChar e : entity)
+                appendChar(e, whiteSpace);
+            if (i == end - 1)
+                textEndsWithNewline = entity == QLatin1String("\n");
+        }
+        else
+            appendChar(c, whiteSpace);
+    }
+}
+
+/*!
+ * \fn HtmlToText::appendChar
+ * \param c
+ * \param whiteSpace
+ */
+void HtmlToText::appendChar(QChar c, WhiteSpace whiteSpace)
+{
+    if (c.isSpace() && c != QChar::Nbsp && c != QChar::ParagraphSeparator) {
+        if (whiteSpace == Normal) {
+            if (removeWhiteSpace)
+                return;
+            removeWhiteSpace = true;
+            c = QLatin1Char(' ');
+        }
+        else if (c == QLatin1Char('\r') && whiteSpace == Pre)
+            return;
+    }
+    else
+        removeWhiteSpace = false;
+
+    blockHasText = true;
+    afterTable = false;
+    if (c == QChar::Nbsp)
+        c = QLatin1Char(' ');
+    else if (c == QChar::ParagraphSeparator || c == QChar::LineSeparator)
+        c = QLatin1Char('\n');
+    text += c;
+}
+
+/*!
+ * \fn HtmlToText::parseEntity
+ * \brief Reads the character reference starting at \a start, after '&'; an unknown one is kept as text
+ * \param start
+ * \param end end of the text it is in
+ * \param last set to its last character
+ * \return
+ */
+QString HtmlToText::parseEntity(int start, int end, int *last)
+{
+    int i = start;
+    int entityLen = 0;
+    bool closed = false;
+    while (i < end) {
+        QChar c = html.at(i++);
+        if (c.isSpace() || i - start > 9)
+            break;
+        if (c == QLatin1Char(';')) {
+            closed = true;
+            break;
+        }
+        ++entityLen;
+    }
+    //! the last entity of the html needs no ';'
+    if (i == html.size() && entityLen == i - start)
+        closed = true;
+
+    if (closed && entityLen > 0) {
+        *last = i - 1;
+        QString entity = html.mid(start, entityLen);
+        if (entity == QLatin1String("amp")) return QString(QLatin1Char('&'));
+        if (entity == QLatin1String("lt")) return QString(QLatin1Char('<'));
+        if (entity == QLatin1String("gt")) return QString(QLatin1Char('>'));
+        if (entity == QLatin1String("quot")) return QString(QLatin1Char('"'));
+        if (entity == QLatin1String("apos")) return QString(QLatin1Char('\''));
+        if (entity == QLatin1String("nbsp")) return QString(QChar(QChar::Nbsp));
+        if (entityLen > 1 && entity.at(0) == QLatin1Char('#')) {
+            entity = entity.mid(1);
+            int base = 10;
+            if (entity.at(0).toLower() == QLatin1Char('x')) {
+                entity = entity.mid(1);
+                base = 16;
+            }
+            bool ok = false;
+            uint uc = entity.toUInt(&ok, base);
+            if (ok) {
+                if (uc >= 0x80 && uc < 0xA0)
+                    uc = windowsLatin1ExtendedCharacters[uc - 0x80];
+                QString str;
+                if (QChar::requiresSurrogates(uc)) {
+                    str += QChar(QChar::highSurrogate(uc));
+                    str += QChar(QChar::lowSurrogate(uc));
+                }
+                else
+                    str += QChar(uc);
+                return str;
+            }
+        }
+    }
+    *last = start - 1;
+    return QString(QLatin1Char('&'));
+}
+
+/*!
+ * \fn HtmlToText::skipRawText
+ * \brief Skips the contents of an element like <style> up to its close tag
+ * \param tag
+ */
+void HtmlToText::skipRawText(const QString &tag)
+{
+    int end = html.indexOf(QLatin1String("</") + tag, pos, Qt::CaseInsensitive);
+    if (end < 0)
+        end = html.size();
+    if (tag == QLatin1String("style"))
+        readStyleSheet(html.mid(pos, end - pos));
+    pos = end;
+}
+
+/*!
+ * \fn HtmlToText::readStyleSheet
+ * \brief Keeps the white-space of the tags named in a style sheet, e.g. "p, li { white-space: pre-wrap; }" of the saved pages
+ * \param css
+ */
+void HtmlToText::readStyleSheet(const QString &css)
+{
+    for (const QString &rule : css.split(QLatin1Char('}'))) {
+        int open = rule.indexOf(QLatin1Char('{'));
+        if (open < 0)
+            continue;
+        QString declarations = rule.mid(open + 1).simplified().remove(QLatin1Char(' ')).toLower();
+        WhiteSpace whiteSpace;
+        if (declarations.contains(QLatin1String("white-space:pre-wrap")))
+            whiteSpace = PreWrap;
+        else if (declarations.contains(QLatin1String("white-space:pre")))
+            whiteSpace = Pre;
+        else if (declarations.contains(QLatin1String("white-space:normal")))
+            whiteSpace = Normal;
+        else
+            continue;
+        for (const QString &selector : rule.left(open).split(QLatin1Char(',')))
+            styleSheet.insert(selector.trimmed().toLower(), whiteSpace);
+    }
+}
+
+/*!
+ * \fn HtmlToText::parseWord
+ * \brief Reads a tag name or an attribute like QTextDocument does: in quotes, or up to a space, '=', '<', '>' or "/>"
+ * \return the word as it is written
+ */
+QString HtmlToText::parseWord()
+{
+    int len = html.size();
+    if (pos < len && (html.at(pos) == QLatin1Char('"') || html.at(pos) == QLatin1Char('\''))) {
+        int end = html.indexOf(html.at(pos), pos + 1);
+        if (end < 0)
+            end = len;
+        QString word = html.mid(pos + 1, end - pos - 1);
+        pos = end < len ? end + 1 : len;
+        return word;
+    }
+    int start = pos;
+    while (pos < len) {
+        QChar c = html.at(pos);
+        if (c == QLatin1Char('>') || c == QLatin1Char('<') || c == QLatin1Char('=') || c.isSpace()
+                || (c == QLatin1Char('/') && pos + 2 < len && html.at(pos + 1) == QLatin1Char('>')))
+            break;
+        pos++;
+    }
+    return html.mid(start, pos - start);
+}
+
+/*!
+ * \fn HtmlToText::closeElements
+ * \brief Closes the open elements from \a first on
+ * \param first
+ */
+void HtmlToText::closeElements(int first)
+{
+    while (elements.size() > first) {
+        Element e = elements.takeLast();
+        if (e.tag == QLatin1String("table")) {
+            //! text after the table goes to the block after its end of frame character
+            lastCellHasText = blockHasText;
+            startFrameBlock();
+            afterTable = true;
+        }
+        else if (e.block)
+            blockClosed = true;
+        afterBlockTag = afterBlockTag || e.block;
+    }
+}
+
+/*!
+ * \fn HtmlToText::parseTag
+ * \brief Reads a tag after '<' and starts or ends the blocks of the text accordingly
+ * \details Anything after '<' is read as a tag up to the next '>', as QTextDocument does, also in plain text given as html.
+ */
+void HtmlToText::parseTag()
+{
+    int len = html.size();
+    while (pos < len && html.at(pos).isSpace())
+        pos++;
+
+    //! comments, <!DOCTYPE ...>, and the whitespace after them
+    if (pos < len && html.at(pos) == QLatin1Char('!')) {
+        pos++;
+        if (pos + 2 < len && html.at(pos) == QLatin1Char('-')) {
+            int end = html.indexOf(QLatin1String("-->"), pos + 3);
+            pos = end < 0 ? len : end + 3;
+        }
+        else {
+            int end = html.indexOf(QLatin1Char('>'), pos);
+            pos = end < 0 ? len : end + 1;
+        }
+        if (elements.isEmpty() || elements.last().whiteSpace == Normal)
+            while (pos < len && html.at(pos).isSpace())
+                pos++;
+        return;
+    }
+
+    afterBlockTag = false;
+    bool endsWithNewline = textEndsWithNewline;
+    textEndsWithNewline = false;
+
+    bool close = false;
+    if (pos < len && html.at(pos) == QLatin1Char('/')) {
+        close = true;
+        pos++;
+    }
+    QString tag = parseWord().toLower();
+
+    //! attributes, only style matters
+    QString style;
+    if (!close && pos < len && html.at(pos).isSpace()) {
+        while (pos < len) {
+            while (pos < len && html.at(pos).isSpace())
+                pos++;
+            if (pos >= len || html.at(pos) == QLatin1Char('>') || html.at(pos) == QLatin1Char('/'))
+                break;
+            QString key = parseWord();
+            if (key.isEmpty())
+                break;
+            while (pos < len && html.at(pos).isSpace())
+                pos++;
+            if (pos < len && html.at(pos) == QLatin1Char('=')) {
+                pos++;
+                while (pos < len && html.at(pos).isSpace())
+                    pos++;
+                QString value = parseWord();
+                if (key.toLower() == QLatin1String("style"))
+                    style = value;
+            }
+        }
+    }
+    bool selfClosing = false;
+    while (pos < len && html.at(pos) != QLatin1Char('>')) {
+        if (html.at(pos) == QLatin1Char('/'))
+            selfClosing = true;
+        pos++;
+    }
+    pos++;
+
+    static const QSet<QString> blockTags = {
+        "p", "div", "h1", "h2", "h3", "h4", "h5", "h6", "li", "ul", "ol", "dl", "dt", "dd",
+        "blockquote", "pre", "center", "address", "table", "tr", "td", "th", "thead", "tbody", "tfoot", "caption"
+    };
+
+    if (close) {
+        tag = tag.trimmed();
+        for (int i = elements.size() - 1; i >= 0; i--) {
+            if (elements[i].tag != tag)
+                continue;
+            //! the newline before the end of a pre block is not a line of its own
+            if (endsWithNewline && elements[i].block && elements[i].whiteSpace != Normal && text.endsWith(QLatin1Char('\n')))
+                text.chop(1);
+            closeElements(i);
+            break;
+        }
+        return;
+    }
+
+    bool hidden = !elements.isEmpty() && elements.last().hidden;
+    if (tag == QLatin1String("br")) {
+        if (hidden || (!elements.isEmpty() && elements.last().emptyParagraph))
+            return;
+        if (blockClosed)
+            startBlock();
+        text += QLatin1Char('\n');
+        blockHasText = true;
+        afterTable = false;
+        removeWhiteSpace = true;
+        return;
+    }
+    if (tag == QLatin1String("img")) {
+        if (hidden)
+            return;
+        if (blockClosed)
+            startBlock();
+        text += QChar(QChar::ObjectReplacementCharacter);
+        blockHasText = true;
+        afterTable = false;
+        removeWhiteSpace = false;
+        return;
+    }
+    if (tag == QLatin1String("hr")) {
+        startBlock();
+        blockUsed = true;
+        blockClosed = true;
+        return;
+    }
+    if (tag == QLatin1String("style") || tag == QLatin1String("script") || tag == QLatin1String("title")) {
+        if (!selfClosing)
+            skipRawText(tag);
+        return;
+    }
+    if (tag == QLatin1String("meta") || tag == QLatin1String("link") || tag == QLatin1String("input"))
+        return;
+
+    Element e;
+    e.tag = tag;
+    e.block = blockTags.contains(tag);
+    afterBlockTag = e.block;
+    e.emptyParagraph = false;
+    e.hidden = tag == QLatin1String("head") || (!elements.isEmpty() && elements.last().hidden);
+    e.whiteSpace = elements.isEmpty() ? Normal : elements.last().whiteSpace;
+    if (tag == QLatin1String("pre"))
+        e.whiteSpace = Pre;
+    if (styleSheet.contains(tag))
+        e.whiteSpace = styleSheet.value(tag);
+    //! most styles only set colours
+    if (style.contains(QLatin1String("white-space")) || style.contains(QLatin1String("-qt-paragraph-type"))) {
+        QString declarations = style.simplified().remove(QLatin1Char(' ')).toLower();
+        if (declarations.contains(QLatin1String("white-space:pre-wrap")))
+            e.whiteSpace = PreWrap;
+        else if (declarations.contains(QLatin1String("white-space:pre")))
+            e.whiteSpace = Pre;
+        else if (declarations.contains(QLatin1String("white-space:normal")))
+            e.whiteSpace = Normal;
+        e.emptyParagraph = declarations.contains(QLatin1String("-qt-paragraph-type:empty"));
+    }
+
+    if (tag == QLatin1String("table")) {
+        //! the table and each of its cells start with a frame character, a cell is a line even when it is empty
+        startFrameBlock();
+        firstCell = true;
+    }
+    else if (tag == QLatin1String("td") || tag == QLatin1String("th")) {
+        if (!firstCell)
+            startFrameBlock();
+        firstCell = false;
+    }
+    else if (tag == QLatin1String("tr") || tag == QLatin1String("thead") || tag == QLatin1String("tbody") || tag == QLatin1String("tfoot")
+             || tag == QLatin1String("ul") || tag == QLatin1String("ol") || tag == QLatin1String("dl")) {
+        //! rows and lists are only made of their cells and items
+    }
+    else if (e.block) {
+        if (e.emptyParagraph && afterTable)
+            lastCellHasText = true;     // an empty paragraph never takes the block after a table
+        startBlock();
+        if (e.emptyParagraph)
+            blockUsed = true;
+    }
+    elements.append(e);
+
+    //! the newline after the start of a pre block is not a line of its own
+    if (e.block && e.whiteSpace != Normal && pos < len - 1 && html.at(pos) == QLatin1Char('\n'))
+        pos++;
+    if (selfClosing)
+        closeElements(elements.size() - 1);
+}
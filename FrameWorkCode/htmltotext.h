@@ -0,0 +1,68 @@
+#ifndef HTMLTOTEXT_H
+#define HTMLTOTEXT_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+
+/*
+ * Plain text of a saved page without a QTextDocument.
+ * QTextDocument::setHtml() builds the blocks, formats and layout of a page
+ * only for toPlainText() to throw them away, and it belongs to the GUI side.
+ * HtmlToText reads the html of a page once, tag by tag, and writes the text of
+ * its blocks the way toPlainText() returns them: one line per paragraph,
+ * <br /> as a line break, images as U+FFFC, &nbsp; as a space, and the
+ * whitespace of the elements whose white-space is pre or pre-wrap kept as it
+ * is. Equations are saved in the text of the page between $$, so they come out
+ * as they are written. Plain text given as html, like the OCR text of a page,
+ * is read the same way too, '<' and all. It only reads its argument and can
+ * run in any thread.
+ */
+class HtmlToText
+{
+public:
+    //! Same text as QTextDocument::setHtml(html) followed by toPlainText() for the pages the tool saves
+    static QString toPlainText(const QString &html);
+
+private:
+    enum WhiteSpace { Normal, Pre, PreWrap };
+
+    struct Element {
+        QString tag;
+        WhiteSpace whiteSpace;
+        bool block;
+        bool emptyParagraph;    // -qt-paragraph-type:empty, its <br /> is not text
+        bool hidden;            // in <head>
+    };
+
+    HtmlToText(const QString &html);
+
+    void parse();
+    void parseTag();
+    QString parseWord();
+    void closeElements(int first);
+    QString parseEntity(int start, int end, int *last);
+    void skipRawText(const QString &tag);
+    void readStyleSheet(const QString &css);
+    void appendText(int end);
+    void appendChar(QChar c, WhiteSpace whiteSpace);
+    void startBlock();
+    void startFrameBlock();
+
+    const QString &html;
+    int pos;
+    QString text;
+    QVector<Element> elements;
+    QHash<QString, WhiteSpace> styleSheet;   // white-space of the tags named in <style>
+    bool blockUsed;         // the current block has text or belongs to an element
+    bool blockHasText;
+    bool blockClosed;       // the element of the current block is closed, more text starts a new block
+    bool removeWhiteSpace;  // whitespace is collapsed into the space before it
+    bool afterBlockTag;     // the last tag opened or closed a block, a single whitespace character after it is dropped
+    bool textEndsWithNewline;    // the text since the last tag ends with a newline
+    bool afterTable;        // the current block is the empty one after a table
+    bool lastCellHasText;
+    bool firstCell;         // no cell of the open table was started yet
+};
+
+#endif // HTMLTOTEXT_H
@@ -6,6 +6,7 @@
 #include "ui_interndiffview.h"
 #include "zoom.h"
 #include "diff_match_patch.h"
+#include "htmltotext.h"
 #include <string>
 #include <qstring.h>
 #include <Project.h>
@@ -227,9 +228,7 @@ void InternDiffView::Load_comparePage(string page)
            }
        }
 
-       QTextDocument doc;
-       doc.setHtml(qs2);
-       qs2 = doc.toPlainText().replace(" \n", "\n");
+       qs2 = HtmlToText::toPlainText(qs2).replace(" \n", "\n");
 
        int l1,l2, DiffOcr_Corrector;
 
@@ -246,9 +245,6 @@ void InternDiffView::Load_comparePage(string page)
 
        QString title = "Compare Corrector Output " + QString::fromStdString(page) ;
        setWindowTitle(title);
-       doc.setHtml(qs1);
-       doc.setHtml(qs2);
-
        auto diffs = dmp.diff_main(qs1, qs2);
        auto html = dmp.diff_prettyHtml(diffs, "ffd13d");
        html1 = html[0];
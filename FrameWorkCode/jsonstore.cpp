@@ -0,0 +1,255 @@
+#include "jsonstore.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+QHash<QString, JsonStore *> JsonStore::stores;
+
+/*!
+ * \fn JsonStore::get
+ * \brief Returns the store of the json file at filePath. The store is opened on first use and stays open
+ * until closeAll(). If the file was written outside of the store since, e.g. by a merge, it is read again
+ * and the journal is replayed on top of it.
+ * \param filePath
+ * \return JsonStore
+ */
+JsonStore *JsonStore::get(const QString &filePath)
+{
+    QString path = QFileInfo(filePath).absoluteFilePath();
+    JsonStore *store = stores.value(path);
+    if (!store) {
+        store = new JsonStore(path);
+        stores.insert(path, store);
+        return store;
+    }
+
+    qint64 size, modified;
+    store->readFileStamp(&size, &modified);
+    if (size != store->fileSize || modified != store->fileModified)
+        store->load();
+    return store;
+}
+
+/*!
+ * \fn JsonStore::compactAll
+ * \brief Folds the journal of every open store into its file, so the files can be committed as they are
+ */
+void JsonStore::compactAll()
+{
+    for (JsonStore *store : stores)
+        store->compact();
+}
+
+/*!
+ * \fn JsonStore::closeAll
+ * \brief Compacts and deletes every open store
+ */
+void JsonStore::closeAll()
+{
+    compactAll();
+    qDeleteAll(stores);
+    stores.clear();
+}
+
+JsonStore::JsonStore(const QString &filePath)
+    : filePath(filePath)
+{
+    journal.setFileName(filePath + ".journal");
+    load();
+}
+
+JsonStore::~JsonStore()
+{
+    journal.close();
+}
+
+/*!
+ * \fn JsonStore::insert
+ * \brief Sets the value at path and appends the edit to the journal
+ * \param path  keys from the top level object down to the key of the value
+ * \param value
+ */
+void JsonStore::insert(const QStringList &path, const QJsonValue &value)
+{
+    if (path.isEmpty())
+        return;
+    apply(mainObj, path, 0, &value);
+    append(QJsonArray({ "set", QJsonArray::fromStringList(path), value }));
+}
+
+/*!
+ * \fn JsonStore::remove
+ * \brief Removes the value at path and appends the edit to the journal
+ * \param path
+ */
+void JsonStore::remove(const QStringList &path)
+{
+    if (path.isEmpty())
+        return;
+    apply(mainObj, path, 0, nullptr);
+    append(QJsonArray({ "del", QJsonArray::fromStringList(path) }));
+}
+
+/*!
+ * \fn JsonStore::setObject
+ * \brief Makes obj the content of the store. Only the top level keys whose value changed are journaled, so
+ * code that edits a copy of object() does not write the parts it left alone.
+ * \param obj
+ */
+void JsonStore::setObject(const QJsonObject &obj)
+{
+    for (auto it = obj.begin(); it != obj.end(); ++it) {
+        if (mainObj.value(it.key()) != it.value())
+            insert({ it.key() }, it.value());
+    }
+    for (const QString &key : mainObj.keys()) {
+        if (!obj.contains(key))
+            remove({ key });
+    }
+}
+
+/*!
+ * \fn JsonStore::compact
+ * \brief Writes the object to the file, in the format writeJsonFile() uses, and removes the journal.
+ * The file is replaced only once it is written completely; until then the old file and the journal hold the
+ * same content.
+ */
+void JsonStore::compact()
+{
+    if (journalEntries == 0)
+        return;
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Cannot write" << filePath;
+        return;
+    }
+    file.write(QJsonDocument(mainObj).toJson());
+    if (!file.commit()) {
+        qDebug() << "Cannot write" << filePath;
+        return;
+    }
+
+    journal.close();
+    journal.remove();
+    journalEntries = 0;
+    readFileStamp(&fileSize, &fileModified);
+}
+
+/*!
+ * \fn JsonStore::load
+ * \brief Reads the file and replays its journal. A journal that ends in a partial line, left by a crash in the
+ * middle of an append, is compacted right away so that the next append does not continue that line.
+ */
+void JsonStore::load()
+{
+    journal.close();
+    mainObj = QJsonObject();
+    journalEntries = 0;
+    readFileStamp(&fileSize, &fileModified);
+
+    QFile jsonFile(filePath);
+    if (jsonFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        mainObj = QJsonDocument::fromJson(jsonFile.readAll()).object();
+        jsonFile.close();
+    }
+
+    if (!journal.open(QIODevice::ReadOnly))
+        return;
+    bool torn = false;
+    while (!journal.atEnd()) {
+        QByteArray line = journal.readLine();
+        QJsonParseError error;
+        QJsonDocument entry = QJsonDocument::fromJson(line, &error);
+        if (!line.endsWith('\n') || error.error != QJsonParseError::NoError || !replay(entry.array())) {
+            qDebug() << "Dropping the end of" << journal.fileName();
+            torn = true;
+            break;
+        }
+        journalEntries++;
+    }
+    journal.close();
+
+    if (torn) {
+        journalEntries++;       // so compact() writes the file even if no line was read
+        compact();
+    }
+}
+
+/*!
+ * \fn JsonStore::append
+ * \brief Appends one edit to the journal as a line of compact json and compacts the store when the journal
+ * gets long
+ * \param entry  ["set", path, value] or ["del", path]
+ */
+void JsonStore::append(const QJsonArray &entry)
+{
+    if (!journal.isOpen() && !journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Cannot open" << journal.fileName();
+        return;
+    }
+    journal.write(QJsonDocument(entry).toJson(QJsonDocument::Compact) + '\n');
+    journal.flush();
+
+    if (++journalEntries > MAX_JOURNAL_ENTRIES)
+        compact();
+}
+
+/*!
+ * \fn JsonStore::replay
+ * \brief Applies an edit read from the journal
+ * \param entry
+ * \return false if the entry is not an edit
+ */
+bool JsonStore::replay(const QJsonArray &entry)
+{
+    QString op = entry.at(0).toString();
+    QStringList path;
+    for (const QJsonValue &key : entry.at(1).toArray())
+        path << key.toString();
+    if (path.isEmpty())
+        return false;
+
+    if (op == "set" && entry.size() == 3) {
+        QJsonValue value = entry.at(2);
+        apply(mainObj, path, 0, &value);
+        return true;
+    }
+    if (op == "del" && entry.size() == 2) {
+        apply(mainObj, path, 0, nullptr);
+        return true;
+    }
+    return false;
+}
+
+/*!
+ * \fn JsonStore::apply
+ * \brief Sets the value at path[depth..] in obj, or removes it if value is null
+ * \param obj
+ * \param path
+ * \param depth
+ * \param value
+ */
+void JsonStore::apply(QJsonObject &obj, const QStringList &path, int depth, const QJsonValue *value)
+{
+    const QString &key = path.at(depth);
+    if (depth == path.size() - 1) {
+        if (value)
+            obj.insert(key, *value);
+        else
+            obj.remove(key);
+        return;
+    }
+    QJsonObject child = obj.value(key).toObject();
+    apply(child, path, depth + 1, value);
+    obj.insert(key, child);
+}
+
+void JsonStore::readFileStamp(qint64 *size, qint64 *modified) const
+{
+    QFileInfo info(filePath);
+    *size = info.exists() ? info.size() : -1;
+    *modified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
@@ -0,0 +1,66 @@
+#ifndef JSONSTORE_H
+#define JSONSTORE_H
+
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+#include <QStringList>
+
+/*
+ * A json file of the Comments folder (comments, highlights, time log) kept in
+ * memory while the project is open. An edit changes the object in memory and
+ * is appended to <file>.journal as one line, so it costs the same however big
+ * the file has grown. The journal is replayed on top of the file when the store
+ * is opened and is folded back into the file, in the format it always had, once
+ * it grows long, before a commit and when the project is closed. The file is
+ * replaced atomically; a line cut short by a crash is dropped on replay.
+ * Edits are idempotent, so replaying a journal that was already folded into
+ * the file changes nothing. Stores are used from the GUI thread only.
+ */
+class JsonStore
+{
+public:
+    //! Store of the file, opened on first use and reloaded if the file was changed outside of the store (a merge)
+    static JsonStore *get(const QString &filePath);
+    //! Folds the journal of every open store into its file
+    static void compactAll();
+    //! Compacts and forgets every store, for a project that is closed
+    static void closeAll();
+
+    const QJsonObject &object() const { return mainObj; }
+
+    //! Sets the value at path, the objects on the way are created if missing
+    void insert(const QStringList &path, const QJsonValue &value);
+    void remove(const QStringList &path);
+    //! Journals the top level keys of obj that differ from the store
+    void setObject(const QJsonObject &obj);
+
+    void compact();
+
+private:
+    //! Journal lines after which the store is compacted
+    static const int MAX_JOURNAL_ENTRIES = 1000;
+
+    explicit JsonStore(const QString &filePath);
+    ~JsonStore();
+
+    void load();
+    void append(const QJsonArray &entry);
+    bool replay(const QJsonArray &entry);
+    static void apply(QJsonObject &obj, const QStringList &path, int depth, const QJsonValue *value);
+    void readFileStamp(qint64 *size, qint64 *modified) const;
+
+    QString filePath;
+    QFile journal;
+    QJsonObject mainObj;
+    int journalEntries = 0;
+    qint64 fileSize = -1;
+    qint64 fileModified = -1;
+
+    static QHash<QString, JsonStore *> stores;
+};
+
+#endif // JSONSTORE_H
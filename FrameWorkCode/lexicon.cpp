@@ -0,0 +1,265 @@
+/*!
+ * \class Lexicon
+ * \brief Flat hash table of word counts over a string pool
+ */
+#include "lexicon.h"
+#include <atomic>
+#include <cstring>
+
+const uint32_t Lexicon::npos;
+
+//! source of stamp(), shared by all lexicons so that no two of them have the same stamp
+static atomic<uint64_t> nextStamp(1);
+
+/*!
+ * \fn Lexicon::Lexicon
+ */
+Lexicon::Lexicon()
+{
+    clear();
+}
+
+/*!
+ * \fn Lexicon::clear
+ * \brief Releases all words
+ */
+void Lexicon::clear()
+{
+    string().swap(pool);
+    vector<Entry>().swap(entries);
+    slots.assign(16, 0);
+    maxLen = 0;
+    touch();
+}
+
+/*!
+ * \fn Lexicon::touch
+ * \brief Gives the lexicon a new stamp() after it changed
+ */
+void Lexicon::touch()
+{
+    stampValue = nextStamp++;
+}
+
+/*!
+ * \fn Lexicon::reserve
+ * \brief Sizes the table for n words so that loading does not rehash
+ * \param n
+ */
+void Lexicon::reserve(size_t n)
+{
+    entries.reserve(n);
+    size_t sz = slots.size();
+    while (sz < 2 * n) sz *= 2;
+    if (sz != slots.size()) rehash(sz);
+}
+
+/*!
+ * \fn Lexicon::hashOf
+ * \brief FNV-1a
+ * \param w
+ * \param len
+ * \return
+ */
+uint32_t Lexicon::hashOf(const char* w, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)w[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*!
+ * \fn Lexicon::find
+ * \param w
+ * \param len
+ * \param h hashOf(w, len)
+ * \return index of the entry of w, or npos
+ */
+uint32_t Lexicon::find(const char* w, size_t len, uint32_t h) const
+{
+    size_t mask = slots.size() - 1;
+    for (size_t s = h & mask; slots[s]; s = (s + 1) & mask) {
+        const Entry& e = entries[slots[s] - 1];
+        if (e.hash == h && e.length == len && memcmp(pool.data() + e.offset, w, len) == 0)
+            return slots[s] - 1;
+    }
+    return npos;
+}
+
+/*!
+ * \fn Lexicon::insert
+ * \brief Appends w, which must not be present yet, with a count of 0
+ * \param w
+ * \param h
+ * \return index of the new entry
+ */
+uint32_t Lexicon::insert(const string& w, uint32_t h)
+{
+    //! keep the load factor at or below one half
+    if (2 * (entries.size() + 1) > slots.size()) rehash(2 * slots.size());
+
+    Entry e;
+    e.offset = (uint32_t)pool.size();
+    e.length = (uint32_t)w.size();
+    e.hash = h;
+    e.value = 0;
+    pool += w;
+    entries.push_back(e);
+    if (w.size() > maxLen) maxLen = w.size();
+
+    size_t mask = slots.size() - 1;
+    size_t s = h & mask;
+    while (slots[s]) s = (s + 1) & mask;
+    slots[s] = (uint32_t)entries.size();
+    return (uint32_t)entries.size() - 1;
+}
+
+/*!
+ * \fn Lexicon::rehash
+ * \param slotCount power of two
+ */
+void Lexicon::rehash(size_t slotCount)
+{
+    slots.assign(slotCount, 0);
+    size_t mask = slotCount - 1;
+    for (size_t i = 0; i < entries.size(); i++) {
+        size_t s = entries[i].hash & mask;
+        while (slots[s]) s = (s + 1) & mask;
+        slots[s] = (uint32_t)i + 1;
+    }
+}
+
+/*!
+ * \fn Lexicon::count
+ * \param w
+ * \param len
+ * \return
+ */
+int Lexicon::count(const char* w, size_t len) const
+{
+    uint32_t i = find(w, len, hashOf(w, len));
+    return i == npos ? 0 : entries[i].value;
+}
+
+/*!
+ * \fn Lexicon::prefixCounts
+ * \brief Looks up every prefix of w, extending the FNV-1a hash by one byte per prefix
+ * \param w
+ * \param len
+ * \param counts resized to min(len, maxLength())
+ */
+void Lexicon::prefixCounts(const char* w, size_t len, vector<int>& counts) const
+{
+    size_t n = len < maxLen ? len : maxLen;
+    counts.assign(n, 0);
+    uint32_t h = 2166136261u;
+    for (size_t l = 1; l <= n; l++) {
+        h ^= (unsigned char)w[l - 1];
+        h *= 16777619u;
+        uint32_t i = find(w, l, h);
+        if (i != npos) counts[l - 1] = entries[i].value;
+    }
+}
+
+/*!
+ * \fn Lexicon::add
+ * \param w
+ * \param n
+ * \return
+ */
+int Lexicon::add(const string& w, int n)
+{
+    uint32_t h = hashOf(w.data(), w.size());
+    uint32_t i = find(w.data(), w.size(), h);
+    if (i == npos) i = insert(w, h);
+    touch();
+    return entries[i].value += n;
+}
+
+/*!
+ * \fn Lexicon::set
+ * \param w
+ * \param value
+ */
+void Lexicon::set(const string& w, int value)
+{
+    uint32_t h = hashOf(w.data(), w.size());
+    uint32_t i = find(w.data(), w.size(), h);
+    if (i == npos) i = insert(w, h);
+    entries[i].value = value;
+    touch();
+}
+
+/*!
+ * \fn Lexicon::memoryUsage
+ * \return bytes held by the pool and the tables
+ */
+size_t Lexicon::memoryUsage() const
+{
+    return sizeof(*this) + pool.capacity() + entries.capacity() * sizeof(Entry) + slots.capacity() * sizeof(uint32_t);
+}
+
+/*!
+ * \fn Lexicon::write
+ * \brief Appends the pool, the entries and the slot table in native byte order
+ * \param out
+ */
+void Lexicon::write(string& out) const
+{
+    uint64_t header[3] = { pool.size(), entries.size(), slots.size() };
+    out.append((const char*)header, sizeof(header));
+    out += pool;
+    out.append((const char*)entries.data(), entries.size() * sizeof(Entry));
+    out.append((const char*)slots.data(), slots.size() * sizeof(uint32_t));
+}
+
+/*!
+ * \fn Lexicon::read
+ * \brief Restores a lexicon stored by write() by copying its pool and tables, without inserting a word or
+ * rebuilding the slot table. The hash of every entry is computed again from the pool to check the copied tables
+ * before they are used, so a damaged buffer is rejected.
+ * \param p start of the stored lexicon, advanced past it on success
+ * \param end
+ * \return false if the buffer does not hold a valid lexicon, the lexicon is left empty then
+ */
+bool Lexicon::read(const char*& p, const char* end)
+{
+    clear();
+
+    uint64_t header[3];
+    if ((size_t)(end - p) < sizeof(header)) return false;
+    memcpy(header, p, sizeof(header));
+    uint64_t poolSize = header[0], n = header[1], nSlots = header[2];
+    if (poolSize >= npos || n >= npos || nSlots < 16 || nSlots >= npos || (nSlots & (nSlots - 1)) || 2 * n > nSlots) return false;
+    if ((uint64_t)(end - p) < sizeof(header) + poolSize + n * sizeof(Entry) + nSlots * sizeof(uint32_t)) return false;
+
+    const char* q = p + sizeof(header);
+    string newPool(q, poolSize); q += poolSize;
+    vector<Entry> newEntries(n);
+    vector<uint32_t> newSlots(nSlots);
+    memcpy(newEntries.data(), q, n * sizeof(Entry)); q += n * sizeof(Entry);
+    memcpy(newSlots.data(), q, nSlots * sizeof(uint32_t)); q += nSlots * sizeof(uint32_t);
+
+    size_t used = 0, newMaxLen = 0;
+    for (size_t i = 0; i < n; i++) {
+        const Entry& e = newEntries[i];
+        if ((uint64_t)e.offset + e.length > poolSize || e.hash != hashOf(newPool.data() + e.offset, e.length)) return false;
+        if (e.length > newMaxLen) newMaxLen = e.length;
+    }
+    for (size_t s = 0; s < nSlots; s++) {
+        if (newSlots[s] > n) return false;
+        if (newSlots[s]) used++;
+    }
+    if (used != n) return false;
+
+    pool.swap(newPool);
+    entries.swap(newEntries);
+    slots.swap(newSlots);
+    maxLen = newMaxLen;
+    touch();
+    p = q;
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef LEXICON_H
+#define LEXICON_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+/*
+ * Word -> count table used for Dict, GBook, IBook, PWords and the confusion maps.
+ * Keys are kept in one string pool and indexed by an open addressing hash with
+ * linear probing. Lookups take a pointer and length, so substrings can be looked
+ * up without building a string, and never insert: a missing word counts as 0.
+ * Words are only added through add() and set().
+ */
+class Lexicon
+{
+public:
+    Lexicon();
+
+    void clear();
+
+    void reserve(size_t n);
+
+    size_t size() const { return entries.size(); }
+
+    bool empty() const { return entries.empty(); }
+
+    //! Count stored for w, 0 if w is not in the lexicon
+    int count(const char* w, size_t len) const;
+
+    int count(const string& w) const { return count(w.data(), w.size()); }
+
+    bool contains(const char* w, size_t len) const { return find(w, len, hashOf(w, len)) != npos; }
+
+    bool contains(const string& w) const { return contains(w.data(), w.size()); }
+
+    //! Length of the longest word
+    size_t maxLength() const { return maxLen; }
+
+    //! counts[l - 1] = count(w, l) for l = 1 .. min(len, maxLength()), hashing w only once
+    void prefixCounts(const char* w, size_t len, vector<int>& counts) const;
+
+    //! Adds n to the count of w, inserting w if needed, and returns the new count
+    int add(const string& w, int n = 1);
+
+    void set(const string& w, int value);
+
+    //! Entries in insertion order, for i in [0, size())
+    string key(size_t i) const { return pool.substr(entries[i].offset, entries[i].length); }
+
+    int value(size_t i) const { return entries[i].value; }
+
+    size_t memoryUsage() const;
+
+    //! Changes whenever a word is added or set and when the lexicon is cleared or read, and is not shared with any other lexicon
+    uint64_t stamp() const { return stampValue; }
+
+    //! Binary form of the pool and the tables, used by DictSnapshot
+    void write(string& out) const;
+
+    bool read(const char*& p, const char* end);
+
+private:
+    struct Entry {
+        uint32_t offset, length, hash;
+        int value;
+    };
+
+    static const uint32_t npos = 0xFFFFFFFFu;
+
+    string pool;
+    vector<Entry> entries;
+    vector<uint32_t> slots;     // entry index + 1, 0 for an empty slot
+    size_t maxLen;
+    uint64_t stampValue;
+
+    static uint32_t hashOf(const char* w, size_t len);
+    uint32_t find(const char* w, size_t len, uint32_t h) const;
+    uint32_t insert(const string& w, uint32_t h);
+    void rehash(size_t slotCount);
+    void touch();
+};
+
+#endif // LEXICON_H
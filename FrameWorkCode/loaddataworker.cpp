@@ -1,4 +1,5 @@
 #include "loaddataworker.h"
+#include "dictsnapshot.h"
 
 /*!
  * \fn LoadDataWorker::LoadDataWorker
@@ -30,12 +31,12 @@ LoadDataWorker::LoadDataWorker(
         QString mFilename,
         QString mFilename1,
         map<string, string>* LSTM,
-        std::map<string, set<string> >* CPairs,
-        map<string, int>* Dict,
-        map<string, int>* GBook,
-        map<string, int>* IBook,
-        map<string, int>* PWords,
-        map<string, int>* ConfPmap,
+        CorrectionPairs* CPairs,
+        Lexicon* Dict,
+        Lexicon* GBook,
+        Lexicon* IBook,
+        Lexicon* PWords,
+        Lexicon* ConfPmap,
         vector<string>* vGBook,
         vector<string>* vIBook,
         trie* TDict,
@@ -71,15 +72,55 @@ LoadDataWorker::LoadDataWorker(
 /*!
  * \fn LoadDataWorker::LoadData
  * \brief This function calls specific functions to load specific data.
+ * \details Data whose source files in Dicts/ are unchanged since the last open is read back from the
+ *          binary snapshot. Everything else is parsed from the text files and stored in the snapshot again.
+ * \sa DictSnapshot
  */
 void LoadDataWorker::LoadData()
 {
-    on_actionLoadDict_triggered();
+    trieEditDis trie;
+    DictSnapshot snapshot((*mProject).GetDir().absolutePath());
+
+    if (snapshot.loadDict(*Dict, *TDict)) cout << "Dict " << (*Dict).size() << " loaded from snapshot" << endl;
+    else {
+        on_actionLoadDict_triggered();
+        trie.loadmaptoTrie(*TDict, *Dict);
+        snapshot.storeDict(*Dict, *TDict);
+    }
     //!GEROCR IEROCR PWords and CPair files are loaded and reflected in terminal
-    on_actionLoadOCRWords_triggered();
-    on_actionLoadDomain_triggered();
-    on_actionLoadSubPS_triggered();
-    on_actionLoadConfusions_triggered();
+    if (snapshot.loadOCR(*GBook, *IBook, *PWords, *vGBook, *vIBook, *TGBook, *TGBookP, *TPWords, *TPWordsP))
+        cout << (*GBook).size() << " " << (*IBook).size() << " OCR words loaded from snapshot" << endl;
+    else {
+        on_actionLoadOCRWords_triggered();
+        on_actionLoadDomain_triggered();
+        loadOCRTries();
+        snapshot.storeOCR(*GBook, *IBook, *PWords, *vGBook, *vIBook, *TGBook, *TGBookP, *TPWords, *TPWordsP);
+    }
+    if (snapshot.loadCPairs(*CPairs)) cout << "CPairs " << (*CPairs).size() << " loaded from snapshot" << endl;
+    else {
+        on_actionLoadSubPS_triggered();
+        snapshot.storeCPairs(*CPairs);
+    }
+    if (snapshot.loadLSTM(*LSTM)) cout << (*LSTM).size() << " LSTM Pairs loaded from snapshot" << endl;
+    else {
+        loadLSTM();
+        snapshot.storeLSTM(*LSTM);
+    }
+    if (snapshot.loadConfusions(*ConfPmap)) cout << (*ConfPmap).size() << " confusions loaded from snapshot" << endl;
+    else {
+        on_actionLoadConfusions_triggered();
+        snapshot.storeConfusions(*ConfPmap);
+    }
+    snapshot.save();
+
+    //! footprint of the suggestion tries, once per load whether they were built or read from the snapshot
+    size_t trieNodes = 0, trieBytes = 0;
+    for (const trie *t : { TDict, TGBook, TGBookP, TPWords, TPWordsP }) {
+        trieNodes += t->nodeCount();
+        trieBytes += t->memoryUsage();
+    }
+    cout << "Tries: " << trieNodes << " nodes, " << trieBytes / 1024 << " KB" << endl;
+
     QString filepath = (*mProject).GetDir().absolutePath() + "/Dicts/synonyms.csv" ;
     slpNPatternDict slnp;
     slnp.loadFileCSV(*synonym, *synrows, filepath.toUtf8().constData());
@@ -154,19 +195,23 @@ void LoadDataWorker::on_actionLoadDomain_triggered()
  * \fn LoadDataWorker::on_actionLoadSubPS_triggered
  * \brief Load CPair files
  * \details The path of the CPair files are fetched and the files are returned in the map which is returned to load the suggestions.
- * \sa loadmaptoTrie(), loadPwordsPatternstoTrie(), loadCPair()
+ * \sa loadCPair()
  */
 void LoadDataWorker::on_actionLoadSubPS_triggered()
 {
     slpNPatternDict slnp;
-    trieEditDis trie;
-    size_t count = trie.loadPWordsPatternstoTrie(*TPWordsP, *PWords);// justsubstrings not patterns exactly // PWordsP,
     QString localmFilename1 = (*mProject).GetDir().absolutePath() + "/Dicts/" + "Corrector_CPair";
 
     slnp.loadCPairs(localmFilename1.toUtf8().constData(), *CPairs, *Dict, *PWords);
-    localmFilename1 = mFilename1;
+}
 
-    localmFilename1 = (*mProject).GetDir().absolutePath() + "/Dicts/" + "LSTM";
+/*!
+ * \fn LoadDataWorker::loadLSTM
+ * \brief Loads the LSTM suggestion pairs
+ */
+void LoadDataWorker::loadLSTM()
+{
+    QString localmFilename1 = (*mProject).GetDir().absolutePath() + "/Dicts/" + "LSTM";
     ifstream myfile(localmFilename1.toUtf8().constData());
     if (myfile.is_open())
     {
@@ -178,10 +223,18 @@ void LoadDataWorker::on_actionLoadSubPS_triggered()
         }
     }
     cout << (*LSTM).size() << "LSTM Pairs Loaded";
-    localmFilename1 = mFilename1;
+}
 
+/*!
+ * \fn LoadDataWorker::loadOCRTries
+ * \brief Builds the tries searched for suggestions from the OCR words and PWords
+ * \sa loadmaptoTrie(), loadPwordsPatternstoTrie()
+ */
+void LoadDataWorker::loadOCRTries()
+{
+    trieEditDis trie;
+    trie.loadPWordsPatternstoTrie(*TPWordsP, *PWords);// justsubstrings not patterns exactly // PWordsP,
     trie.loadmaptoTrie(*TPWords, *PWords);
-    trie.loadmaptoTrie(*TDict, *Dict);
     trie.loadmaptoTrie(*TGBook, *GBook);
     trie.loadPWordsPatternstoTrie(*TGBookP, *GBook);
 }
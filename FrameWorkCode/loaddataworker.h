@@ -16,12 +16,12 @@ public:
             QString mFilename = "",
             QString mFilename1 = "",
             map<string, string>* LSTM = nullptr,
-            std::map<string, set<string> >* CPairs = nullptr,
-            map<string, int>* Dict = nullptr,
-            map<string, int>* GBook = nullptr,
-            map<string, int>* IBook = nullptr,
-            map<string, int>* PWords = nullptr,
-            map<string, int>* ConfPmap = nullptr,
+            CorrectionPairs* CPairs = nullptr,
+            Lexicon* Dict = nullptr,
+            Lexicon* GBook = nullptr,
+            Lexicon* IBook = nullptr,
+            Lexicon* PWords = nullptr,
+            Lexicon* ConfPmap = nullptr,
             vector<string>* vGBook = nullptr,
             vector<string>* vIBook = nullptr,
             trie* TDict = nullptr,
@@ -34,8 +34,8 @@ public:
             );
 private:
     map<string, string>* LSTM;
-    map<string, set<string> >* CPairs;
-    map<string, int> *Dict, *GBook, *IBook, *PWords, *ConfPmap;
+    CorrectionPairs* CPairs;
+    Lexicon *Dict, *GBook, *IBook, *PWords, *ConfPmap;
     vector<string> *vGBook, *vIBook;
     trie *TDict, *TGBook, *TGBookP, *TPWords, *TPWordsP;
     Project *mProject;
@@ -48,6 +48,8 @@ private:
     void on_actionLoadOCRWords_triggered();
     void on_actionLoadDomain_triggered();
     void on_actionLoadSubPS_triggered();
+    void loadLSTM();
+    void loadOCRTries();
     void on_actionLoadConfusions_triggered();
 
 public slots:
@@ -67,6 +67,9 @@
 #include <editdistance.h>
 #include <QRegularExpressionMatch>
 #include "undoglobalreplace.h"
+#include "wordmatcher.h"
+#include "suggestionservice.h"
+#include "spellcheckhighlighter.h"
 #include "globalreplacepreview.h"
 #include "qtextdocumentfragment.h"
 #include <QColorDialog>
@@ -75,10 +78,15 @@
 #include "verifyset.h"
 #include "loaddataworker.h"
 #include "globalreplaceworker.h"
+#include "accuracylogworker.h"
+#include "projectscanworker.h"
+#include "htmltotext.h"
+#include "jsonstore.h"
 #include "customtextbrowser.h"
 #include "pdfrangedialog.h"
 #include <dashboard.h>
 #include "printworker.h"
+#include "scanimageitem.h"
 #include <QRadioButton>
 #include <equationeditor.h>
 #include <QThread>
@@ -110,10 +118,10 @@ QT_CHARTS_USE_NAMESPACE
 
 
 map<string, string> LSTM;
-map<string, int> Dict, GBook, IBook, PWords, PWordsP,ConfPmap,ConfPmapFont,CPairRight;
+Lexicon Dict, GBook, IBook, PWords, ConfPmap, ConfPmapFont;
+map<string, int> PWordsP, CPairRight;
 trie TDict,TGBook,TGBookP, newtrie,TPWords,TPWordsP;
 vector<string> vGBook,vIBook;
-QImage imageOrig;
 QString gDirOneLevelUp,gDirTwoLevelUp,gCurrentPageName, gCurrentDirName, gCurrentBookName;
 QString gCurrentOpenPage;
 map<QString, QString> gInitialTextHtml;
@@ -123,7 +131,7 @@ QMap<QString, QJsonArray> newTimeLog;
 vector<QString> vs; vector<int> vx, vy, vw, vh, vright;
 map<string, vector<string>> SRules;
 map<string, string> TopConfusions;
-map<string, int> TopConfusionsMask;
+Lexicon TopConfusionsMask;
 map<string, int> TimeLog;
 string TimeLogLocation = "../Logs/log.txt";
 string alignment = "left";
@@ -131,7 +139,7 @@ bool prevTRig = 0;
 map<string, vector<int>> synonym;
 vector<vector<string>> synrows;
 map<string, string> CPair;
-std::map<string, set<string> > CPairs;
+CorrectionPairs CPairs;
 bool highlightchecked = false;
 map<int, QString> commentdict;
 map<int, vector<int>> commentederrors;
@@ -185,6 +193,10 @@ QDialog *tableDialog;
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),ui(new Ui::MainWindow)
 {
     ui->setupUi(this);
+    pageImages = new PageImageCache(this);
+    suggestionTimer.setSingleShot(true);
+    suggestionTimer.setInterval(800);
+    connect(&suggestionTimer, SIGNAL(timeout()), this, SLOT(requestPendingSuggestions()));
     QMenuBar *menubar = this->menuBar();
     QIcon icon = QIcon(":/Images/Resources/user_login.png");
     ui->pushButton_5->setIcon(icon);
@@ -697,6 +709,8 @@ bool MainWindow::setRole()
  */
 MainWindow::~MainWindow()
 {
+    resetSuggestions();
+    JsonStore::closeAll();
     delete ui;
 }
 
@@ -747,24 +761,29 @@ int gSeconds;
 /*!
  * \fn MainWindow::SaveTimeLog
  * \brief This function saves the time of changes commit into the log json file.
- * \sa writeJsonFile()
+ * \details Only the entry of the current page is timed by myTimer, so only that entry is written; the
+ * entries of the other pages keep the time they were saved with.
+ * \sa JsonStore
  */
 void MainWindow::SaveTimeLog()
 {
-    QJsonObject mainObj;
+    if (!mProject.isProjectOpen() || gTimeLogLocation.isEmpty())
+        return;
+    QString currentVersion = mProject.get_version();
+    if(mRole == "Verifier" && mRole != currentVersion)
+        currentVersion = QString::number(currentVersion.toInt() - 1);
+    QString directory = mRole +":"+ gCurrentPageName +":V-"+ currentVersion;
+    if (!newTimeLog.contains(directory))
+        return;
+
     QJsonObject page;
 
     int nMilliseconds = myTimer.elapsed();
     int sec = nMilliseconds / 1000;
-    //! Iterating over newTimeLog and and assinging time details into the page and finally inserting page into json object.
-    for (auto i = newTimeLog.begin(); i != newTimeLog.end(); i++)
-    {
-        page["directory"] = i.key();
-        page["seconds"] = i.value().at(0).toInt()+sec;
-        page["Date/Time"] = i.value().at(1).toString();
-        mainObj.insert(i.key(), page);
-    }
-    writeJsonFile(gTimeLogLocation, mainObj);
+    page["directory"] = directory;
+    page["seconds"] = newTimeLog.value(directory).at(0).toInt()+sec;
+    page["Date/Time"] = newTimeLog.value(directory).at(1).toString();
+    JsonStore::get(gTimeLogLocation)->insert({ directory }, page);
 }
 
 /*!
@@ -826,6 +845,118 @@ vector<string> vBest;
 bool RightclickFlag = 0;
 string selectedStr ="";
 
+/*!
+ * \fn cPairCorrection
+ * \brief The correction a word is marked purple for by the spell check: its CPair entry, if it is in neither Dict nor PWords
+ * \details Reads Dict, PWords and CPair, so the caller holds suggestionDataLock for reading.
+ * \param s1 SLP1
+ * \return the SLP1 correction, empty if there is none
+ */
+static string cPairCorrection(const string& s1)
+{
+    if (Dict.count(s1) > 0 || PWords.count(s1) > 0) return "";
+    map<string, string>::const_iterator cp = CPair.find(s1);
+    return cp != CPair.end() ? cp->second : "";
+}
+
+/*!
+ * \fn rankSuggestions
+ * \brief Ranked right click suggestions of a word, used by the context menu and by the background SuggestionService
+ * \details Reads the dictionaries, the tries, PWords and CPairs, so the caller holds suggestionDataLock for reading.
+ * Suggestions come from CPairs and, when useConfiguration is set, from the primary OCR, the secondary OCR and PWords
+ * entries nearest by confusions, the confusion pair suggestion and the samAsa correction; they are ranked by their
+ * edit distance to the word.
+ * \param selectedStr
+ * \param useConfiguration the configuration of the project is "True"
+ * \return
+ * \sa print5NearestEntries(), print2OCRSugg(), loadWConfusionsNindex1(), editDistBatch()
+ */
+static SuggestionService::Suggestions rankSuggestions(const string& selectedStr, bool useConfiguration)
+{
+    slpNPatternDict slnp;
+    trieEditDis trie;
+    SuggestionService::Suggestions sugg;
+    if (selectedStr.empty()) return sugg;
+
+    vector<string> Alligned = trie.print5NearestEntries(TGBookP, selectedStr, trieEditDis::SUGGESTION_MAX_EDIT_DISTANCE);
+    //! the suggestion menu needs an aligned entry, so fall back to the unbounded search
+    if (Alligned.empty()) Alligned = trie.print5NearestEntries(TGBookP, selectedStr);
+    if (Alligned.empty()) return sugg;
+    sugg.aligned = true;
+
+    //! as for Alligned, words further than the bound from every entry still get the nearest entries
+    vector<string>  Words1 = trie.print5NearestEntries(TGBook, selectedStr, trieEditDis::SUGGESTION_MAX_EDIT_DISTANCE);
+    if (Words1.empty()) Words1 = trie.print5NearestEntries(TGBook, selectedStr);
+    vector<string> PWords1 = trie.print5NearestEntries(TPWords, selectedStr, trieEditDis::SUGGESTION_MAX_EDIT_DISTANCE);
+    if (PWords1.empty()) PWords1 = trie.print5NearestEntries(TPWords, selectedStr);
+    string PairSugg = slnp.print2OCRSugg(selectedStr, Alligned[0], ConfPmap, Dict); // map<string,int>&
+    vector<string>  Words = trie.print1OCRNearestEntries(slnp.toslp1(selectedStr), vIBook);
+
+    //! find nearest confirming to OCR Sugg from Book
+    string nearestCOnfconfirmingSuggvec;
+    int min = 100;
+    for (size_t t = 0; t < Words1.size(); t++)
+    {
+        vector<string> wordConfusions; vector<int> wCindex;
+        int minFactor = slnp.loadWConfusionsNindex1(selectedStr, Words1[t], ConfPmap, wordConfusions, wCindex);
+        if (minFactor < min) { min = minFactor; nearestCOnfconfirmingSuggvec = Words1[t]; }
+    }
+
+    //! find nearest confirming to OCR Sugg from PWords
+    string nearestCOnfconfirmingSuggvec1;
+    min = 100;
+    for (size_t t = 0; t < PWords1.size(); t++) {
+        vector<string> wordConfusions; vector<int> wCindex;
+        int minFactor = slnp.loadWConfusionsNindex1(selectedStr, PWords1[t], ConfPmap, wordConfusions, wCindex);
+        if (minFactor < min) { min = minFactor; nearestCOnfconfirmingSuggvec1 = PWords1[t]; }
+    }
+
+    map<string, int> mapSugg;
+    vector<string> out;
+    string slpStr = slnp.toslp1(selectedStr);
+    //! CPairs is keyed by SLP1, one lookup instead of transliterating every key
+    if (const set<string>* pairs = CPairs.find(slpStr))
+    {
+        for (set<string>::const_iterator set_it = pairs->begin(); set_it != pairs->end(); ++set_it)
+        {
+            out.push_back(*set_it);
+        }
+    }
+    for (size_t ksugg1 = 0; ksugg1 < 6; ksugg1++)
+    {
+        if (out.size() > ksugg1)  mapSugg[slnp.toslp1(out[ksugg1])]++;
+    }
+
+    if(useConfiguration)
+    {
+        if (Words.size() > 0)  mapSugg[slnp.toslp1(Words[0])]++;
+        if (Words1.size() > 0) mapSugg[slnp.toslp1(nearestCOnfconfirmingSuggvec)]++;
+        if (PWords1.size() > 0) mapSugg[slnp.toslp1(nearestCOnfconfirmingSuggvec1)]++;
+        if (PairSugg.size() > 0) mapSugg[slnp.toslp1(PairSugg)]++;
+        mapSugg[trie.SamasBreakLRCorrect(slpStr, Dict, PWords, TPWords, TPWordsP)]++;
+    }
+
+    eddis e;
+    vector<string> suggSlp;
+    vector<size_t> suggDist;
+    for (map<string, int>::const_iterator eptr = mapSugg.begin(); eptr != mapSugg.end(); eptr++)
+    {
+        suggSlp.push_back(slnp.toslp1(eptr->first));
+    }
+    e.editDistBatch(slpStr, suggSlp, suggDist);
+    vector<pair<int, string>> vecSugg;
+    size_t suggi = 0;
+    for (map<string, int>::const_iterator eptr = mapSugg.begin(); eptr != mapSugg.end(); eptr++, suggi++)
+    {
+        vecSugg.push_back(make_pair(suggDist[suggi], eptr->first));
+    }
+    sort(vecSugg.begin(), vecSugg.end());
+
+    for (size_t i = 0; i < vecSugg.size(); i++)
+        sugg.words.push_back(vecSugg[i].second);
+    return sugg;
+}
+
 /*!
  * \fn MainWindow::mousePressEvent
  * \param ev
@@ -1082,8 +1213,26 @@ void MainWindow::mousePressEvent(QMouseEvent *ev)
             connect(gtrans, SIGNAL(triggered()), this, SLOT(GoogleTranslation()));
             connect(insertImage, SIGNAL(triggered()), this, SLOT(insertImageAction()));
             QString str = QString::fromStdString(selectedStr);
-            vector<string> Alligned = trie.print5NearestEntries(TGBookP, selectedStr);
-            if (!selectedStr.empty() && !Alligned.empty()) {
+            SuggestionService::Suggestions sugg;
+            //! suggestions of the words of the page are usually ready, computed in the background when it was loaded
+            if (!suggestionService || !suggestionService->lookup(selectedStr, sugg)) {
+                {
+                    QReadLocker locker(&suggestionDataLock);
+                    sugg = rankSuggestions(selectedStr, mProject.get_configuration()=="True");
+                }
+                if (suggestionService) suggestionService->insert(selectedStr, sugg);
+            }
+            //! the spell check only colours a word with a CPair correction purple, the correction is offered here first
+            string correction;
+            {
+                QReadLocker locker(&suggestionDataLock);
+                correction = cPairCorrection(slnp.toslp1(selectedStr));
+            }
+            if (!correction.empty()) {
+                sugg.words.erase(remove(sugg.words.begin(), sugg.words.end(), correction), sugg.words.end());
+                sugg.words.insert(sugg.words.begin(), correction);
+            }
+            if (sugg.aligned || !correction.empty()) {
 
 
                 spell_menu = new QMenu("suggestions", this);
@@ -1092,134 +1241,9 @@ void MainWindow::mousePressEvent(QMouseEvent *ev)
 
 
                 QAction* act;
-                vector<string>  Words1 = trie.print5NearestEntries(TGBook, selectedStr);
-                // if (Words1.empty()) return;
-
-
-                //if (Alligned.empty()) return;
-
-                vector<string> PWords1 = trie.print5NearestEntries(TPWords, selectedStr);
-                // if (PWords1.empty()) return;
-
-                string PairSugg = slnp.print2OCRSugg(selectedStr, Alligned[0], ConfPmap, Dict); // map<string,int>&
-                //  if (PairSugg.empty())return;
-
-                vector<string>  Words = trie.print1OCRNearestEntries(slnp.toslp1(selectedStr), vIBook);
-                //  if (Words.empty())return;
-
-
-                //! find nearest confirming to OCR Sugg from Book
-                string nearestCOnfconfirmingSuggvec;
-                vector<string> vec = Words1;
-                int min = 100;
-                for (size_t t = 0; t < vec.size(); t++)
-                {
-                    vector<string> wordConfusions; vector<int> wCindex;
-                    int minFactor = slnp.loadWConfusionsNindex1(selectedStr, vec[t], ConfPmap, wordConfusions, wCindex);
-                    wordConfusions.clear(); wCindex.clear();
-                    if (minFactor < min) { min = minFactor; nearestCOnfconfirmingSuggvec = vec[t]; }
-                }
-
-                //! find nearest confirming to OCR Sugg from PWords
-                string nearestCOnfconfirmingSuggvec1;
-                vector<string> vec1 = PWords1;
-                min = 100;
-                for (size_t t = 0; t < vec1.size(); t++) {
-                    vector<string> wordConfusions; vector<int> wCindex;
-                    int minFactor = slnp.loadWConfusionsNindex1(selectedStr, vec1[t], ConfPmap, wordConfusions, wCindex);
-                    wordConfusions.clear(); wCindex.clear();
-                    if (minFactor < min) { min = minFactor; nearestCOnfconfirmingSuggvec1 = vec1[t]; }
-                }
-
-                vector<pair<int, string>> vecSugg, vecSugg1;
-                map<string, int> mapSugg;
-
-                vector<string> out;
-                map<string, set<string>>::iterator itr;
-                set<string>::iterator set_it;
-
-                for (itr = CPairs.begin(); itr != CPairs.end(); ++itr)
+                for (uint bitarrayi = 0; bitarrayi < sugg.words.size(); bitarrayi++)
                 {
-                    if(slnp.toslp1(itr->first) == slnp.toslp1(selectedStr))
-                    {
-                        for (set_it = itr->second.begin(); set_it != itr->second.end(); ++set_it)
-                        {
-                            out.push_back(slnp.toslp1(*set_it));
-                        }
-                    }
-                }
-
-                cout<<"From CPairs: ";
-                for(auto& it : out){
-                    cout << slnp.toslp1(it) << endl;
-                }
-                for (size_t ksugg1 = 0; ksugg1 < 6; ksugg1++)
-                {
-                    if (out.size() > ksugg1)  mapSugg[slnp.toslp1(out[ksugg1])]++;
-                }
-
-                if(mProject.get_configuration()=="True")
-                {
-                    if (Words.size() > 0)  mapSugg[slnp.toslp1(Words[0])]++;
-                    if (Words1.size() > 0) mapSugg[slnp.toslp1(nearestCOnfconfirmingSuggvec)]++;
-                    if (PWords1.size() > 0) mapSugg[slnp.toslp1(nearestCOnfconfirmingSuggvec1)]++;
-                    if (PairSugg.size() > 0) mapSugg[slnp.toslp1(PairSugg)]++;
-                    mapSugg[trie.SamasBreakLRCorrect(slnp.toslp1(selectedStr), Dict, PWords, TPWords, TPWordsP)]++;
-                    string s1 = slnp.toslp1(selectedStr);
-                    string nearestCOnfconfirmingSuggvecFont = "";
-                    min = 100;
-                    for (size_t t = 0; t < vec.size(); t++)
-                    {
-                        vector<string> wordConfusions; vector<int> wCindex;
-                        int minFactor = slnp.loadWConfusionsNindex1(s1, vec[t], ConfPmapFont, wordConfusions, wCindex);
-                        wordConfusions.clear(); wCindex.clear();
-                        if (minFactor < min) { min = minFactor; nearestCOnfconfirmingSuggvecFont = vec[t]; }
-                    }
-                    //if (nearestCOnfconfirmingSuggvecFont.size() > 0) mapSugg[nearestCOnfconfirmingSuggvecFont]++;
-
-                    string PairSuggFont = "";
-                    if (Alligned.size() > 0) PairSuggFont = slnp.print2OCRSugg(s1, Alligned[0], ConfPmap, Dict);
-                    //if (PairSuggFont.size() > 0) mapSugg[PairSuggFont]++;
-
-                    string sugg9 = "";
-                    sugg9 = slnp.generatePossibilitesNsuggest(s1, TopConfusions, TopConfusionsMask, Dict, SRules);
-                    //if (sugg9.size() > 0) mapSugg[sugg9]++;
-
-                    cout<<"selected string: "<<slnp.toslp1(selectedStr)<<endl;
-                    cout<<"Mapped Suggestion 0: "<<endl; //(string,int) Words, last no. of occuring, create single entry for single same word
-
-                    cout<<"From Primary OCR: ";
-                    for(auto& it : Words){
-                        for(uint i = 0;i<it.size();i++){
-                            cout << it[i];
-                        }
-                        cout<<"\n";
-                    }
-                    cout<<"Nearest confirming from Secondary OCR "<<nearestCOnfconfirmingSuggvec<<endl;
-                    cout<<"Nearest confirming from PWords "<<nearestCOnfconfirmingSuggvec1<<endl;
-                    cout<<"One suggestion from ConfusionPair and secondary OCR Trie Pattern Data "<<slnp.toslp1(PairSugg)<<endl;
-                    cout<<"One suggestion from Pwords which is present in Dict "<<trie.SamasBreakLRCorrect(slnp.toslp1(selectedStr), Dict, PWords, TPWords, TPWordsP)<<endl;
-                    //                cout<<"Nearest confirming from Secondary OCR by converting the string in English "<<nearestCOnfconfirmingSuggvecFont<<endl;
-                    //                cout<<"One suggestion from ConfusionPair and secondary OCR Trie Pattern Data by converting the string in English "<<toslp1(PairSuggFont)<<endl;
-                    //                cout<<"One suggestion from TopConfusion and SandhiRules by converting the string in English "<<sugg9<<endl;
-                }
-                eddis e;
-                for (map<string, int>::const_iterator eptr = mapSugg.begin(); eptr != mapSugg.end(); eptr++)
-                {
-                    vecSugg.push_back(make_pair(e.editDist(slnp.toslp1(eptr->first), slnp.toslp1(selectedStr)), eptr->first));
-                }
-
-                sort(vecSugg.begin(), vecSugg.end());
-
-                cout << "\nVector Suggestions 0\n";
-                cout << "MappingNum\t vector_int\t Word\n";
-                for (uint i = 0; i < vecSugg.size(); i++){
-                    cout<<mapSugg[vecSugg[i].second]<<"\t"<<vecSugg[i].first<<"\t"<<slnp.toDev(vecSugg[i].second)<<endl;
-                }
-
-                for (uint bitarrayi = 0; bitarrayi < vecSugg.size(); bitarrayi++)
-                {
-                    act = new QAction(QString::fromStdString(slnp.toDev(vecSugg[bitarrayi].second)), spell_menu);
+                    act = new QAction(QString::fromStdString(slnp.toDev(sugg.words[bitarrayi])), spell_menu);
                     spell_menu->addAction(act);
                 }
 
@@ -1311,8 +1335,12 @@ void MainWindow::menuSelection(QAction* action)
         cursor.removeSelectedText();
 
         string target = (action->text().toUtf8().constData());
-        CPair[slnp.toslp1(selectedStr)] = slnp.toslp1(target);
-        PWords[slnp.toslp1(target)]++;
+        {
+            QWriteLocker locker(&suggestionDataLock);
+            CPair[slnp.toslp1(selectedStr)] = slnp.toslp1(target);
+            PWords.add(slnp.toslp1(target));
+        }
+        if (suggestionService) suggestionService->invalidate(selectedStr);
         cursor.insertText(action->text());     //inserting into the page
 
         cursor.endEditBlock();
@@ -1406,10 +1434,6 @@ void MainWindow::on_actionEnglish_triggered()
 void MainWindow::on_actionOpen_Project_triggered() { //Version Based
     //QString ProjFile;
 
-    QThread* workerThread = new QThread();
-
-    int totalFileCountInDir = 0;
-    QMap<QString, int> fileCountInDir;
     //to choose between recent three files
     if(isRecentProjclick == true && proj_flag == '0')
     {
@@ -1448,9 +1472,7 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
     }
 
 
-        correct.clear();
-        verify.clear();
-        markForReview.clear();
+        pageStatus.close();
 
 
     if (result != 0) {
@@ -1520,145 +1542,34 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
         //!To lookout for changes in CorrectorOutput and VerifierOutput directory
         watcher.addPath(str1);
         watcher.addPath(str2);
-        qDebug() << "Starting workerThread";
-        qDebug() << "Current Thread ID:" << QThread::currentThreadId();
-
-
-        QObject::connect(workerThread, &QThread::started, [&](){
-            qDebug() << "Inside the workerThread";
-            qDebug() << "Current Thread ID:" << QThread::currentThreadId();
-
-            //!To Display tree view for Document
-            QDir cdir(str1);
-
-            Filter * filter = mProject.getFilter("CorrectorOutput");
-            //!Adds each file present in CorrectorOutput directory to treeView
-            auto list = cdir.entryList(QDir::Filter::Files);
-            QString t;
-            QStringList x;
-            for (auto f : list)
-            {
-                x = f.split(QRegExp("[.]"));
-                t = str1 + "/" + f;
-                if(x[1]=="html") {
-                    QFile f2(t);
-                    totalFileCountInDir++;
-                    mProject.AddTemp(filter,f2,"");
-                }
-                corrector_set.insert(f);
-            }
-            totalPages = totalFileCountInDir;
-            fileCountInDir["Corrector"] = totalFileCountInDir;
-            totalFileCountInDir = 0;
-
-
-
-            //!Adds each file present in VerifierOutput directory to treeView
-            cdir.setPath(str2);
-
-            filter = mProject.getFilter("VerifierOutput");
-            list = cdir.entryList(QDir::Filter::Files);
-            for (auto f : list)
-            {
-                x= f.split(QRegExp("[.]"));
-                t= str2 + "/" + f;
-                if(x[1]=="html") {
-                    QFile f2(t);
-                    totalFileCountInDir++;
-                    mProject.AddTemp(filter, f2, "");
-                }
-                verifier_set.insert(f);
-            }
-            fileCountInDir["Verifier"] = totalFileCountInDir;
-            totalFileCountInDir = 0;
-
-            filter = mProject.getFilter("Document");
-            //!Adds the files from inds folder to treeView
-            cdir.setPath(str3);
-
-            list = cdir.entryList(QDir::Filter::Files);
-            for (auto f : list)
-            {
-                t = str3 + "/" + f;
-                QFile f2(t);
-                totalFileCountInDir++;
-                mProject.AddTemp(filter, f2, "");
-            }
-            fileCountInDir["Inds"] = totalFileCountInDir;
-            totalFileCountInDir = 0;
-
-            //!To Display treeView for Image
-            filter = mProject.getFilter("Image");
-
-            //!Adds the files from Image folder to treeView
-            cdir.setPath(str4);
-
-            list = cdir.entryList(QDir::Filter::Files);
-            for (auto f : list) {
-                t= str4 + "/" + f;
-                QFile f2(t);
-                totalFileCountInDir++;
-                mProject.AddTemp(filter, f2, "");
-            }
-            fileCountInDir["Image"] = totalFileCountInDir;
-            totalFileCountInDir = 0; // Resetting variable to 0
-            qDebug() << "workerThread work done!";
-            workerThread->quit();
-        });
-
-        QObject::connect(workerThread, &QThread::finished, workerThread, &QThread::deleteLater);
-        workerThread->start();
-        workerThread->wait();
-
-        // Resizing scroll bar for project window
-
-        qDebug() << "Resuming the main thread!";
-        qDebug() << "Current Thread ID:" << QThread::currentThreadId();
-
-        int maxFilesInDir = 0;
-        for (auto fileCount : fileCountInDir.values())
-        {
-            if (fileCount > maxFilesInDir)
-                maxFilesInDir = fileCount;
-        }
-
-        QString heightValue;
-        if (maxFilesInDir < 50) {
-            heightValue = "200px";
-        }
-        else if (maxFilesInDir < 200) {
-            heightValue = "60px";
-        }
-        else {
-            heightValue = "50px";
-        }
-
-        QString projectWindowStylesheet = ui->treeView->styleSheet();
-
-
-        int indexOfScrollBarProp = projectWindowStylesheet.indexOf("QScrollBar::handle:vertical");
-        int heightProp = projectWindowStylesheet.indexOf("height:", indexOfScrollBarProp);
-
-        if (heightProp != -1) {
-            int startIndex = heightProp + 7; // here, 7 is the length of "height:" string
-            int endIndex;
-            for (int i = startIndex; projectWindowStylesheet[i] != ';'; i++)
-                endIndex = i;
-            int replaceSize = endIndex - startIndex + 1;
-            projectWindowStylesheet.replace(startIndex, replaceSize, heightValue);
-        }
-        else {
-            int insertHeightProp = projectWindowStylesheet.indexOf("{", indexOfScrollBarProp) + 1;
-            projectWindowStylesheet.insert(insertHeightProp, "height:" + heightValue);
-        }
-
-        ui->treeView->setStyleSheet(projectWindowStylesheet);
+        //!List the folders in the background, the tree fills in batch by batch while the project opens
+        projectScanId++;
+        fileCountInDir.clear();
+        scannedDirectories.clear();
+        openRecentPageAfterScan = false;
+        QMap<QString, QString> directories;
+        directories["CorrectorOutput"] = str1;
+        directories["VerifierOutput"] = str2;
+        directories["Document"] = str3;
+        directories["Image"] = str4;
+        ProjectScanWorker *scanWorker = new ProjectScanWorker(nullptr, projectScanId, directories);
+        QThread *scanThread = new QThread;
+
+        connect(scanThread, SIGNAL(started()), scanWorker, SLOT(scanProject()));
+        connect(scanWorker, SIGNAL(filesFound(int,QString,QString,QStringList)), this, SLOT(addProjectFiles(int,QString,QString,QStringList)));
+        connect(scanWorker, SIGNAL(directoryScanned(int,QString)), this, SLOT(projectDirectoryScanned(int,QString)));
+        connect(scanWorker, SIGNAL(finishedScanning(int)), this, SLOT(projectScanFinished(int)));
+        connect(scanWorker, SIGNAL(finishedScanning(int)), scanThread, SLOT(quit()));
+        connect(scanWorker, SIGNAL(finishedScanning(int)), scanWorker, SLOT(deleteLater()));
+        connect(scanThread, SIGNAL(finished()), scanThread, SLOT(deleteLater()));
+        scanWorker->moveToThread(scanThread);
+        scanThread->start();
 
         UpdateFileBrekadown();    //Reset the current file and dir levels
 
         //!Get the elapsed time in Timelog.json file under Comments folder
         gTimeLogLocation = gDirTwoLevelUp + "/Comments/"+mRole+"_Timelog.json";     //Navigate to Timelog.json uder Comments folder
-        QJsonObject mainObj =  readJsonFile(gTimeLogLocation);
+        QJsonObject mainObj =  JsonStore::get(gTimeLogLocation)->object();
 
         //!Get the seconds elapsed for their file name in json file
         foreach(const QJsonValue &val, mainObj)
@@ -1721,19 +1632,23 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
     QStringList list = gDirTwoLevelUp.split('/');
     gCurrentBookName = list[list.size()-1];
 
+    openPageStatus();
+    showPageStatusCounts();
     if(mRole == "Corrector"){
-        read_corrected_pages();
-        customDelegate = new customTreeviewItem(ui->treeView, correct, ui->treeView->model());
+        customDelegate = new customTreeviewItem(ui->treeView, &pageStatus, PageStatusIndex::Corrected, ui->treeView->model());
         ui->treeView->setItemDelegate(customDelegate);
     }
     else if(mRole == "Verifier"){
-        read_verified_pages();
-        customDelegate = new customTreeviewItem(ui->treeView, verify, ui->treeView->model());
+        customDelegate = new customTreeviewItem(ui->treeView, &pageStatus, PageStatusIndex::Verified, ui->treeView->model());
         ui->treeView->setItemDelegate(customDelegate);
     }
 
+    //! The last page is opened once the output folders are in the tree, see projectDirectoryScanned()
     if(ProjFile == stored_project || ProjFile == stored_project2 || ProjFile == stored_project3){
-        RecentPageInfo();
+        if(scannedDirectories.contains("CorrectorOutput") && scannedDirectories.contains("VerifierOutput"))
+            RecentPageInfo();
+        else
+            openRecentPageAfterScan = true;
     }
 
     //    //<<<<<<Change
@@ -1741,11 +1656,11 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
 
     readCommentLogs();
 
-    QMessageBox::information(0, "Success", "Project opened successfully.");
-
     // Enabling the buttons again after a project is opened
     e_d_features(true);
     //Reset loadData flag
+    resetSuggestions();
+    QWriteLocker locker(&suggestionDataLock);
     LoadDataFlag = 1;
     //reset data
 //    mFilename.clear();
@@ -1766,6 +1681,7 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
     TPWordsP.clear();
     synonym.clear();
     synrows.clear();
+    locker.unlock();
 
     ui->pushButton->setDisabled(false);
     ui->pushButton_2->setDisabled(false);
@@ -1777,8 +1693,115 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
     ui->checkBox->setEnabled(true);
     ui->addDictionary->setEnabled(true);
     ui->lineEdit_5->setVisible(true);
+
+    QMessageBox::information(0, "Success", "Project opened successfully.");
+}
+
+/*!
+ * \fn MainWindow::addProjectFiles
+ * \brief Adds a batch of files found by the ProjectScanWorker to the project tree
+ * \details Only the html files of CorrectorOutput and VerifierOutput go to the tree, but all of their files are
+ * remembered for directoryChanged(). Batches of an earlier open of a project are ignored.
+ * \param scanId
+ * \param filterName
+ * \param dirPath
+ * \param files
+ */
+void MainWindow::addProjectFiles(int scanId, QString filterName, QString dirPath, QStringList files)
+{
+    if (scanId != projectScanId || !mProject.isProjectOpen())
+        return;
+
+    QStringList treeFiles;
+    for (auto f : files)
+    {
+        if (filterName == "CorrectorOutput" || filterName == "VerifierOutput")
+        {
+            if (filterName == "CorrectorOutput")
+                corrector_set.insert(f);
+            else
+                verifier_set.insert(f);
+            QStringList x = f.split(QRegExp("[.]"));
+            if (x.size() < 2 || x[1] != "html")
+                continue;
+        }
+        treeFiles << f;
+    }
+    mProject.AddFiles(mProject.getFilter(filterName), dirPath, treeFiles);
+    fileCountInDir[filterName] += treeFiles.size();
+    if (filterName == "CorrectorOutput")
+        totalPages = fileCountInDir[filterName];
+}
+
+/*!
+ * \fn MainWindow::projectDirectoryScanned
+ * \brief Opens the last opened page of the project as soon as both output folders are in the tree
+ * \param scanId
+ * \param filterName
+ */
+void MainWindow::projectDirectoryScanned(int scanId, QString filterName)
+{
+    if (scanId != projectScanId || !mProject.isProjectOpen())
+        return;
+
+    scannedDirectories.insert(filterName);
+    if (openRecentPageAfterScan && scannedDirectories.contains("CorrectorOutput") && scannedDirectories.contains("VerifierOutput"))
+    {
+        openRecentPageAfterScan = false;
+        RecentPageInfo();
+    }
 }
 
+/*!
+ * \fn MainWindow::projectScanFinished
+ * \brief Sizes the scroll bar of the project window for the largest folder once all of them are listed
+ * \param scanId
+ */
+void MainWindow::projectScanFinished(int scanId)
+{
+    if (scanId != projectScanId || !mProject.isProjectOpen())
+        return;
+
+    // Resizing scroll bar for project window
+    int maxFilesInDir = 0;
+    for (auto fileCount : fileCountInDir.values())
+    {
+        if (fileCount > maxFilesInDir)
+            maxFilesInDir = fileCount;
+    }
+
+    QString heightValue;
+    if (maxFilesInDir < 50) {
+        heightValue = "200px";
+    }
+    else if (maxFilesInDir < 200) {
+        heightValue = "60px";
+    }
+    else {
+        heightValue = "50px";
+    }
+
+    QString projectWindowStylesheet = ui->treeView->styleSheet();
+
+
+    int indexOfScrollBarProp = projectWindowStylesheet.indexOf("QScrollBar::handle:vertical");
+    int heightProp = projectWindowStylesheet.indexOf("height:", indexOfScrollBarProp);
+
+    if (heightProp != -1) {
+        int startIndex = heightProp + 7; // here, 7 is the length of "height:" string
+        int endIndex;
+        for (int i = startIndex; projectWindowStylesheet[i] != ';'; i++)
+            endIndex = i;
+        int replaceSize = endIndex - startIndex + 1;
+        projectWindowStylesheet.replace(startIndex, replaceSize, heightValue);
+    }
+    else {
+        int insertHeightProp = projectWindowStylesheet.indexOf("{", indexOfScrollBarProp) + 1;
+        projectWindowStylesheet.insert(insertHeightProp, "height:" + heightValue);
+    }
+
+    ui->treeView->setStyleSheet(projectWindowStylesheet);
+}
 
 /*!
  * \fn MainWindow::AddRecentProjects
@@ -1936,7 +1959,11 @@ void MainWindow::SaveFile_GUI_Postprocessing()
     QFile sFile(localFilename);
     QString output = curr_browser->toHtml();
 
-    if(sFile.open(QFile::WriteOnly))
+    //! pages are written in text mode, as insertBboxes() wrote them
+    QIODevice::OpenMode mode = QFile::WriteOnly;
+    if(tempPageName.endsWith(".html"))
+        mode |= QFile::Text;
+    if(sFile.open(mode))
     {
         QTextStream out(&sFile);
         out.setCodec("UTF-8");          //!Sets the codec for this stream
@@ -1981,12 +2008,12 @@ void MainWindow::SaveFile_GUI_Postprocessing()
         } else if ((inputDataIndex = output.indexOf("</head>")) != -1) {
             output.insert(inputDataIndex - 1, "<style>\nbody { width: 21cm; height: 29.7cm; margin: 30mm 45mm 30mm 45mm; }\n</style>");
         }
+        if(tempPageName.endsWith(".html"))
+            output = handleBbox->insertBboxes(output);
         out << output;
         sFile.flush();      //!Flushes any buffered data waiting to be written in the \a sFile
         sFile.close();      //!Closing the file
-
-        if(tempPageName.endsWith(".html"))
-            handleBbox->insertBboxes(&sFile);
+        mProject.markForCommit(localFilename);
     }
     if(initialSave == true){
         initialSave = false;
@@ -2184,11 +2211,85 @@ void MainWindow::on_actionSave_As_triggered()
 
 //map<string, int> wordLineIndex;
 
+/*!
+ * \fn spellCheckMarks
+ * \brief Spell check colours of a word: gray in PWords, purple with a CPair correction (offered first in the context
+ *        menu), otherwise its dictionary parts
+ *        alternately blue and green and the rest red, the colours findDictEntries() gave the html. Words of the secondary
+ *        OCR are not coloured and go to PWords.
+ * \details Reads Dict, GBook, PWords and CPair, so the caller holds suggestionDataLock for reading.
+ * \param word
+ * \return
+ * \sa findDictEntryParts(), hasM40PerAsci()
+ */
+static SpellCheckHighlighter::Marks spellCheckMarks(const QString &word)
+{
+    slpNPatternDict slnp;
+    SpellCheckHighlighter::Marks marks;
+    string word1 = word.toUtf8().constData();
+    string s1 = slnp.toslp1(word1);
+    SpellCheckHighlighter::Span span;
+    span.start = 0;
+    span.length = word.size();
+
+    if (slnp.hasM40PerAsci(word1))
+        return marks;
+    if (GBook.count(s1) > 0) {
+        marks.pword = s1;
+        return marks;
+    }
+    if (PWords.count(s1) > 0) {
+        span.color = QColor("gray");
+        marks.spans.append(span);
+        return marks;
+    }
+    if (!cPairCorrection(s1).empty()) {
+        span.color = QColor("purple");
+        marks.spans.append(span);
+        return marks;
+    }
+
+    vector<pair<size_t, bool> > parts;
+    slnp.findDictEntryParts(s1, Dict, PWords, parts);
+    //! Offsets of the parts in the word: the Devanagari of the SLP1 before a part, less the virama of a
+    //! last consonant when the part starts with a vowel, which is then a matra of that consonant
+    const string vowels = "aAiIuUfFxXeEoO";
+    size_t slp = 0;
+    int dev = 0, known = 0;
+    for (size_t k = 0; k < parts.size(); k++) {
+        size_t end = slp + parts[k].first;
+        int devEnd = word.size();
+        if (end < s1.size()) {
+            QString prefix = QString::fromStdString(slnp.toDev(s1.substr(0, end)));
+            devEnd = prefix.size();
+            if (prefix.endsWith(QChar(0x094D)) && vowels.find(s1[end]) != string::npos) devEnd--;
+        }
+        if (devEnd < dev || devEnd > word.size()) {
+            //! the word does not map back part by part, colour it as a whole
+            marks.spans.clear();
+            bool allKnown = true;
+            for (size_t t = 0; t < parts.size(); t++) allKnown = allKnown && parts[t].second;
+            span.color = QColor(allKnown ? "blue" : "red");
+            marks.spans.append(span);
+            return marks;
+        }
+        span.start = dev;
+        span.length = devEnd - dev;
+        span.color = QColor(!parts[k].second ? "red" : (known++ % 2 == 0 ? "blue" : "green"));
+        if (span.length > 0) marks.spans.append(span);
+        slp = end;
+        dev = devEnd;
+    }
+    return marks;
+}
+
 /*!
  * \fn MainWindow::on_actionSpell_Check_triggered
- * \brief Converts the whole html page to the original text page in orange color
+ * \brief Colours the words of the page by the dictionaries, or converts the page to Devanagari after it was saved
+ * \details The colours are formats of a SpellCheckHighlighter on the page, so the text and the saved html are not
+ *        changed; its words are classified in the background and only the edited blocks are checked again.
  * \note works on the basis of a pre-defined flag which helps to always convert the text to Devanagari
- * \sa findDictEntries(), find_and_replace_oddInstancesblue(), find_and_replace_oddInstancesorange(),hasM40PerAsci()
+ * \sa spellCheckMarks(), addSpellCheckPWords(), hasM40PerAsci()
  */
 void MainWindow::on_actionSpell_Check_triggered()
 {
@@ -2196,6 +2297,19 @@ void MainWindow::on_actionSpell_Check_triggered()
     if(!curr_browser || curr_browser->isReadOnly())
         return;
 
+    if(!ConvertSlpDevFlag)
+    {
+        SpellCheckHighlighter *highlighter = curr_browser->document()->findChild<SpellCheckHighlighter*>();
+        if (highlighter)
+            highlighter->recheck();
+        else
+        {
+            highlighter = new SpellCheckHighlighter(curr_browser->document(), spellCheckMarks);
+            connect(highlighter, SIGNAL(foundPWords(QStringList)), this, SLOT(addSpellCheckPWords(QStringList)));
+        }
+        return;
+    }
+
     QTextCharFormat fmt;
     curr_browser->moveCursor(QTextCursor::Start);
     QTextCursor cursor =curr_browser->textCursor(); //get the cursor
@@ -2210,50 +2324,16 @@ void MainWindow::on_actionSpell_Check_triggered()
 
             string selectedString = str1.toUtf8().constData();
             string wordNext;
-            if(ConvertSlpDevFlag)
-            {
-                string word1 = selectedString;
-                selectedString = slnp.toslp1(selectedString);
-
-                if(slnp.hasM40PerAsci(word1))
-                {
-                    wordNext = word1;
-                }
-                else
-                {
-                    wordNext = slnp.toDev(selectedString);
-                }
+            string word1 = selectedString;
+            selectedString = slnp.toslp1(selectedString);
 
+            if(slnp.hasM40PerAsci(word1))
+            {
+                wordNext = word1;
             }
             else
             {
-                string word1 = selectedString;
-                selectedString = slnp.toslp1(selectedString);
-                //string wordNext;
-                //! checks if the word exists in the English language, Seconday OCR, Pwords, Dict and CPair; convert its color coding
-                if(slnp.hasM40PerAsci(word1))
-                    wordNext = word1;
-
-                else if(GBook[(selectedString)] > 0 )
-                {
-                    wordNext = slnp.toDev(selectedString);
-                    PWords[selectedString]++;
-                }
-
-                else if(PWords[selectedString] > 0)
-                {
-                    wordNext = "<font color=\'gray\'>" + slnp.toDev(selectedString) + "</font>";
-                }
-                else if((Dict[selectedString] ==0) && (PWords[selectedString] == 0) && (CPair[selectedString].size() > 0))
-                {
-                    wordNext = "<font color=\'purple\'>" + slnp.toDev(CPair[selectedString]) + "</font>";
-                }
-                else
-                {
-                    wordNext = slnp.findDictEntries(slnp.toslp1(selectedString),Dict,PWords, selectedString.size());     //replace m1 with m2,m1 for combined search
-                    wordNext = slnp.find_and_replace_oddInstancesblue(wordNext);
-                    wordNext = slnp.find_and_replace_oddInstancesorange(wordNext);
-                }
+                wordNext = slnp.toDev(selectedString);
             }
             cursor.mergeCharFormat(fmt);
             cursor.insertHtml(QString::fromStdString(wordNext));
@@ -2269,6 +2349,18 @@ void MainWindow::on_actionSpell_Check_triggered()
 
 }
 
+/*!
+ * \fn MainWindow::addSpellCheckPWords
+ * \brief Adds the words of the secondary OCR found by the spell check to PWords
+ * \param words SLP1
+ */
+void MainWindow::addSpellCheckPWords(const QStringList &words)
+{
+    QWriteLocker locker(&suggestionDataLock);
+    for (const QString &w : words)
+        PWords.add(w.toUtf8().constData());
+}
+
 
 int isProjectOpen = 0;
 
@@ -2484,12 +2576,16 @@ void MainWindow::on_actionLoadGDocPage_triggered()
             out << curr_browser->toHtml(); //toPlainText(); //Modified
             sFile.flush();
             sFile.close();
+            mProject.markForCommit(str1);
         }
 
         /*! Load PWord and Top Confusion Words*/
+        //! every cached suggestion may change, drop them before the data is changed
+        if (suggestionService) suggestionService->cancel();
+        QWriteLocker locker(&suggestionDataLock);
         slnp.loadMap(str1.toUtf8().constData(), PWords, "PWords");
 
-        map<string, int> PWordspage;
+        Lexicon PWordspage;
         slnp.loadMap(str1.toUtf8().constData(), PWordspage, "PWordspage");
         trie.loadmaptoTrie(TPWords, PWordspage);
 
@@ -2504,6 +2600,8 @@ void MainWindow::on_actionLoadGDocPage_triggered()
         TopConfusions.clear();
         TopConfusionsMask.clear();
         slnp.loadTopConfusions(ConfPmap, TopConfusions, TopConfusionsMask);
+        locker.unlock();
+        if (curr_browser) requestSuggestions(curr_browser->toPlainText());
     }
 }
 
@@ -2536,6 +2634,104 @@ void MainWindow::WordCount()
     }
 }
 
+/*!
+ * \fn MainWindow::requestSuggestions
+ * \brief Asks the suggestion service for the words of text that are neither in Dict nor in PWords
+ * \details Called with the text of a page when it is loaded, and with the edited blocks when it changes,
+ * so that the right click menu finds the suggestions of the page ready. Does nothing until the data is loaded.
+ * \param text
+ * \sa requestChangedSuggestions(), rankSuggestions()
+ */
+void MainWindow::requestSuggestions(const QString &text)
+{
+    if (!suggestionService || LoadDataFlag)
+        return;
+    slpNPatternDict slnp;
+    vector<string> words;
+    set<string> seen;
+    int n = text.size();
+    for (int i = 0; i < n; ) {
+        if (!WordMatcher::isWordChar(text.at(i))) { i++; continue; }
+        int start = i;
+        while (i < n && WordMatcher::isWordChar(text.at(i))) i++;
+        string word = text.mid(start, i - start).toUtf8().constData();
+        if (!seen.insert(word).second)
+            continue;
+        string slp = slnp.toslp1(word);
+        if (Dict.count(slp) == 0 && PWords.count(slp) == 0)
+            words.push_back(word);
+    }
+    suggestionService->request(words);
+}
+
+/*!
+ * \fn MainWindow::requestChangedSuggestions
+ * \brief Records the range touched by an edit of the page and restarts suggestionTimer
+ * \details The words of the range are requested by requestPendingSuggestions() once the typing pauses, so
+ * a word is queued when it is finished and not once for every prefix typed.
+ * \param position
+ * \param charsRemoved
+ * \param charsAdded
+ */
+void MainWindow::requestChangedSuggestions(int position, int charsRemoved, int charsAdded)
+{
+    if (!suggestionService || !curr_browser)
+        return;
+    QTextDocument *document = curr_browser->document();
+    if (changedDocument && changedDocument != document)
+        requestPendingSuggestions();
+
+    if (changedFrom < 0) {
+        changedFrom = position;
+        changedTo = position + charsAdded;
+    }
+    else {
+        //! the part of the range after the edit moves with it
+        if (changedTo >= position)
+            changedTo = qMax(changedTo + charsAdded - charsRemoved, position + charsAdded);
+        else
+            changedTo = position + charsAdded;
+        changedFrom = qMin(changedFrom, position);
+    }
+    changedDocument = document;
+    suggestionTimer.start();
+}
+
+/*!
+ * \fn MainWindow::requestPendingSuggestions
+ * \brief Requests the suggestions of the words in the blocks edited since the last request
+ */
+void MainWindow::requestPendingSuggestions()
+{
+    suggestionTimer.stop();
+    QTextDocument *document = changedDocument;
+    int from = changedFrom, to = changedTo;
+    changedDocument = nullptr;
+    changedFrom = changedTo = -1;
+    if (!document || from < 0)
+        return;
+
+    QTextBlock block = document->findBlock(from);
+    QTextBlock last = document->findBlock(qMin(to, document->characterCount() - 1));
+    QString text;
+    for (; block.isValid(); block = block.next()) {
+        text += block.text() + "\n";
+        if (block == last)
+            break;
+    }
+    requestSuggestions(text);
+}
+
+/*!
+ * \fn MainWindow::resetSuggestions
+ * \brief Stops the background suggestions and drops the cache, before the data they are computed from is cleared or reloaded
+ */
+void MainWindow::resetSuggestions()
+{
+    delete suggestionService;
+    suggestionService = nullptr;
+}
+
 /*!
  * \fn MainWindow::on_actionLoadData_triggered
  * \brief Loads the dictionary files only once
@@ -2601,6 +2797,13 @@ void MainWindow::on_actionLoadData_triggered()
 
             ui->lineEdit->setText(initialText);
             LoadDataFlag = 0;
+
+            //! Suggestions of the open page and of every page loaded from now on are computed in the background
+            bool useConfiguration = mProject.get_configuration()=="True";
+            suggestionService = new SuggestionService([useConfiguration](const string& word) {
+                return rankSuggestions(word, useConfiguration);
+            });
+            if (curr_browser) requestSuggestions(curr_browser->toPlainText());
             qDebug() << "done loading ....";
             QMessageBox messageBox;
             messageBox.information(0, "Load Data", "Data has been loaded.");
@@ -2663,145 +2866,36 @@ void MainWindow::on_actionFind_and_Replace_triggered()
 /*!
  * \fn MainWindow::on_actionAccuracyLog_triggered
  * \brief Logs various accuracies to AccuracyLog.csv
- * \details Stores the following values in the csv:
- * Page Name
- * Percent Difference in Corrector and Verifier Text
- * Percent Character Level Accuracy (Corrector)
- * Percent Word Level Accuracy (Corrector)
- * Percent Change made by Corrector wrt OCR Text
- * Percent Word Errors
- * Percent Accuracy of OCR
- * \sa diff_match_patch::diff_main(),  Project::LevenshteinWithGraphemes(), Project::GetGraphemesCount()
+ * \details The pages of the folder of the chosen file are compared on a thread pool by AccuracyLogWorker, which writes the rows
+ * in page order while the progress bar is shown, and computes again only the pages changed since the last log.
+ * \sa AccuracyLogWorker::computePage()
 */
 void MainWindow::on_actionAccuracyLog_triggered()
 {
-    QString qs1="", qs2="",qs3="";
-
     file = QFileDialog::getOpenFileName(this,"Open File from VerifierOutput Folder"); //open file
+    if(file.isEmpty())
+        return;
     int loc =  file.lastIndexOf("/");
     QString folder = file.mid(0,loc);      //fetch parent tdirectory
 
     QDir directory(folder);
     QStringList textFiles = directory.entryList((QStringList()<<"*.txt", QDir::Files)); //fetch all files in the parent directory
 
-    int loc1 = folder.lastIndexOf("/");
-    QString qcsvfolder =  folder.mid(0,loc1) +"/AccuracyLog.csv";
-    string csvfolder = qcsvfolder.toUtf8().constData();
-
-    std::ofstream csvFile(csvfolder);
-    csvFile<<"Page Name,"<<"Errors (Word level),"<<"Errors (Character-Level),"<< "Accuracy of Corrector (Word level),"<<"Accuracy of Corrector (Character-Level)," <<"Changes made by Corrector(%)," <<"OCR Accuracy(w.rt. Verified Text)"<<"\n";
-
-    foreach(QString fileName, textFiles)
-    {
-
-        string pageName = fileName.toUtf8().constData();
-        fileName = folder + "/" + fileName;
-
-        QString verifierText = fileName;
-        QString correctorText = fileName.replace("VerifierOutput","CorrectorOutput"); //CAN CHANGE ACCORDING TO FILE STRUCTURE
-        QString ocrText = fileName.replace("CorrectorOutput","Inds"); //CAN CHANGE ACCORDING TO FILE STRUCTURE
-        ocrText.replace(".html",".txt");
-        ocrText.replace("V1_", "");
-        ocrText.replace("V2_", "");
-        ocrText.replace("V3_", "");
-
-        if(!ocrText.isEmpty())
-        {
-            QFile sFile(ocrText);
-            if(sFile.open(QFile::ReadOnly | QFile::Text))
-            {
-                QTextStream in(&sFile);
-                in.setCodec("UTF-8");
-                qs1 = in.readAll().simplified();
-            }
-
-        }
-        if(!correctorText.isEmpty())
-        {
-            QFile sFile(correctorText);
-            if(sFile.open(QFile::ReadOnly | QFile::Text))
-            {
-                QTextStream in(&sFile);
-                in.setCodec("UTF-8");
-                qs2 = in.readAll().simplified();
-            }
-
-        }
-        if(!verifierText.isEmpty())
-        {
-            QFile sFile(verifierText);
-            if(sFile.open(QFile::ReadOnly | QFile::Text))
-            {
-                QTextStream in(&sFile);
-                in.setCodec("UTF-8");
-                qs3 = in.readAll().simplified();
-                sFile.close();
-            }
-
-        }
-        int l1,l2,l3, DiffOcr_Corrector,DiffCorrector_Verifier,DiffOcr_Verifier; float correctorChangesPerc,verifierChangesPerc,ocrErrorPerc;
-
-
-        QTextDocument doc;
-
-        doc.setHtml(qs2);
-        qs2 = doc.toPlainText().replace(" \n","\n");
-
-        doc.setHtml(qs3);
-        qs3 = doc.toPlainText().replace(" \n","\n");
-
-        l1 = mProject.GetGraphemesCount(qs1); l2 = mProject.GetGraphemesCount(qs2); l3 = mProject.GetGraphemesCount(qs3);
-        if(qs1=="" | qs2 == "" | qs3 == "")
-        {
-            continue;
-        }
-
-        diff_match_patch dmp;
-
-        auto diffs1 = dmp.diff_main(qs1,qs2);
-        DiffOcr_Corrector = mProject.LevenshteinWithGraphemes(diffs1);
-        correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l2)*100;
-        if(correctorChangesPerc>100)
-            correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l1)*100;
-        correctorChangesPerc = (((float)lround(correctorChangesPerc*100))/100);
-
-        auto diffs2 = dmp.diff_main(qs2,qs3);
-        DiffCorrector_Verifier = mProject.LevenshteinWithGraphemes(diffs2);
-        verifierChangesPerc = ((float)(DiffCorrector_Verifier)/(float)l3)*100;
-        if(verifierChangesPerc>100)
-            verifierChangesPerc = ((float)(DiffCorrector_Verifier)/(float)l2)*100;
-        verifierChangesPerc = (((float)lround(verifierChangesPerc*100))/100);
-        float correctorCharAcc =100- (((float)lround(verifierChangesPerc*100))/100); //Corrector accuracy = 100-changes mabe by Verfier
-
-        auto diffs3 = dmp.diff_main(qs1,qs3);
-        DiffOcr_Verifier = mProject.LevenshteinWithGraphemes(diffs3);
-        ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l3)*100;
-        if(ocrErrorPerc>100)
-            ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l1)*100;
-        float ocrAcc = 100 - (((float)lround(ocrErrorPerc*100))/100);
-
-
-        auto a = dmp.diff_linesToChars(qs2, qs3); //LinesToChars modifed for WordstoChar in diff_match_patch.cpp
-        auto lineText1 = a[0].toString();
-        auto lineText2 = a[1].toString();
-        auto lineArray = a[2].toStringList();
-        int wordCount2 = qs2.simplified().count(" ");
-        int wordCount3 = qs3.simplified().count(" ");
-        auto diffs = dmp.diff_main(lineText1, lineText2);
-        int worderrors = dmp.diff_levenshtein(diffs);
-        dmp.diff_charsToLines(diffs, lineArray);
-
-        float correctorwordaccuracy = (float)(worderrors)/(float)wordCount3*100;
-        if(correctorwordaccuracy>100)
-            correctorwordaccuracy = (float)(worderrors)/(float)wordCount2*100;
-        correctorwordaccuracy = (((float)lround(correctorwordaccuracy*100))/100);
-
-        csvFile<<pageName<<","<<worderrors<<","<<DiffCorrector_Verifier<<","<< correctorwordaccuracy<<","<<correctorCharAcc<<"," <<correctorChangesPerc<<","<<ocrAcc<<"\n";
-
-    }
-
-    csvFile.close();
+    AccuracyLogWorker *alWorker = new AccuracyLogWorker(nullptr, &mProject, folder, textFiles);
+    QThread *thread = new QThread;
+    connect(thread, SIGNAL(started()), alWorker, SLOT(writeAccuracyLog()));
+    connect(alWorker, SIGNAL(finishedWritingAccuracyLog()), thread, SLOT(quit()));
+    connect(alWorker, SIGNAL(finishedWritingAccuracyLog()), alWorker, SLOT(deleteLater()));
+    connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+    connect(alWorker, SIGNAL(finishedWritingAccuracyLog()), this, SLOT(closeProgressBar()));
+    connect(alWorker, SIGNAL(changeProgressBarValue(int)), this, SLOT(setProgressBarPerc(int)));
+    alWorker->moveToThread(thread);
+    thread->start();
 
+    progressBarDialog = new ProgressBarDialog(this);
+    progressBarDialog->setMessage("Writing accuracy log...");
+    progressBarDialog->setModal(false);
+    progressBarDialog->exec();
 }
 
 /*!
@@ -2820,7 +2914,7 @@ void MainWindow::on_actionViewAverageAccuracies_triggered()
 
     float avgcharacc = 0, avgwordacc = 0, avgrating = 0; int avgcharerrors = 0, avgworderrors = 0;
 
-    QJsonObject mainObj = readJsonFile(commentFilename);
+    QJsonObject mainObj = JsonStore::get(commentFilename)->object();
 
     avgcharacc = mainObj["AverageCharAccuracy"].toDouble();
     avgwordacc = mainObj["AverageWordAccuracy"].toDouble();
@@ -3023,6 +3117,7 @@ void MainWindow::on_actionAllFontProperties_triggered()
             out.setCodec("UTF-8");
             out << fileText;
             file.close();
+            mProject.markForCommit(filename);
         }
 
     }
@@ -3220,7 +3315,7 @@ void MainWindow::on_actionHighlight_triggered()
  * \fn MainWindow::LogHighlights
  * \param QString text
  * \brief Stores highlight metadata to JSON files
- * \sa writeJsonFile()
+ * \sa JsonStore
  * \note Meta data includes: Word highlighted, timestamp, time elapsed, page name
 */
 void MainWindow::LogHighlights(QString word) //Verifier Only
@@ -3234,8 +3329,6 @@ void MainWindow::LogHighlights(QString word) //Verifier Only
     pagename.replace(".txt", "");                                                 // remove extension from file name to use it as a key
     pagename.replace(".html", "");
 
-    QJsonObject mainObj = readJsonFile(highlightsFilename);                       // read JSON file into mainObj
-    QJsonObject page = mainObj.value(pagename).toObject();                        // set values for page name
     QJsonObject highlights;                                                       // make a new JSON object to store new metadata
 
     int nMilliseconds = myTimer.elapsed();
@@ -3247,12 +3340,7 @@ void MainWindow::LogHighlights(QString word) //Verifier Only
     highlights["Time Elapsed (s)"] = secs;
     highlights["Page Name"] = pagename;
 
-    page.remove(time);
-    page.insert(time, highlights);
-    mainObj.remove(pagename);
-    mainObj.insert(pagename, page);
-
-    writeJsonFile(highlightsFilename, mainObj);
+    JsonStore::get(highlightsFilename)->insert({ pagename, time }, highlights);   // append the entry to the highlights log
 }
 
 /*!
@@ -4470,7 +4558,6 @@ bool MainWindow::eventFilter(QObject *object, QEvent *event)
             {
                 QMouseEvent *mEvent = static_cast<QMouseEvent*>(event);
                 QPointF pos =  ui->graphicsView->mapToScene( mEvent->pos()); //Capturing the coordinates values according to the image.
-                QRgb rgb = imageOrig.pixel( ( int )pos.x(), ( int )pos.y());
 
                 x1 = ( int )pos.x();      //left coordinate value
                 y1 = ( int )pos.y();      //top coordinate value
@@ -4539,7 +4626,6 @@ bool MainWindow::eventFilter(QObject *object, QEvent *event)
 
                     QMouseEvent *mEvent = static_cast<QMouseEvent*>(event);
                     QPointF pos =  ui->graphicsView->mapToScene( mEvent->pos() );
-                    QRgb rgb = imageOrig.pixel( ( int )pos.x(), ( int )pos.y() );
 
                     x2 = ( int )pos.x();         //right coordinate value
                     y2 = ( int )pos.y();         //bottom coordinate value
@@ -4557,8 +4643,7 @@ bool MainWindow::eventFilter(QObject *object, QEvent *event)
                     int height = y2 - y1;
                     crop_rect->setRect(x1, y1, width, height);       //set final coordinates for rectangular region
                     QRect rect(x1, y1, width, height);              //set QRect
-                    QPixmap image = QPixmap::fromImage(imageOrig);       //set QPixmap image
-                    QPixmap cropped1 = image.copy(rect);                   //get cropped image according to coordinates
+                    QPixmap cropped1 = QPixmap::fromImage(pageImages->region(scanImagePath, rect));     //get cropped image according to coordinates, read from the scan at full resolution
 
                     if(width >= 710){
                         width = 600;
@@ -4670,7 +4755,6 @@ bool MainWindow::eventFilter(QObject *object, QEvent *event)
             {
                 //statusBar()->showMessage(QString("Mouse move (%1,%2)").arg(mEvent->pos().x()).arg(mEvent->pos().y()));
                 QPointF position =  ui->graphicsView->mapToScene( mEvent->pos() );
-                QRgb rgb = imageOrig.pixel( ( int )position.x(), ( int )position.y() );
 
                 QColor blue40 = Qt::blue;
                 blue40.setAlphaF( 0.4 );
@@ -4750,6 +4834,7 @@ void MainWindow::saveImageRegion(QPixmap cropped, QString a, QString s1,int z, i
             QString path = "/Cropped_Images/figures/Figure"+a+"-"+QString::number(z)+".jpg";
 
             cropped.save(gDirTwoLevelUp+path,"JPG",100);       //100 is storing the image in uncompressed high resolution
+            mProject.markForCommit(gDirTwoLevelUp+path);
 
             QString src = ".."+path;
             QString html = QString("\n <img src='%1' width='%2' height='%3'>").arg(src).arg(w).arg(h); //Creating an img tag for image resize in latek
@@ -4761,6 +4846,7 @@ void MainWindow::saveImageRegion(QPixmap cropped, QString a, QString s1,int z, i
             QString path = "/Cropped_Images/tables/Table"+a+"-"+QString::number(z)+".jpg";
 
             cropped.save(gDirTwoLevelUp+path,"JPG", 100);
+            mProject.markForCommit(gDirTwoLevelUp+path);
 
             QString src = ".."+path;
 
@@ -4774,6 +4860,7 @@ void MainWindow::saveImageRegion(QPixmap cropped, QString a, QString s1,int z, i
             QString path = "/Cropped_Images/equations/Equation"+a+"-"+QString::number(z)+".jpg";
 
             cropped.save(gDirTwoLevelUp+path,"JPG",100);
+            mProject.markForCommit(gDirTwoLevelUp+path);
 
             QString src = ".."+path;
             QString html = QString("\n <img src='%1' width='%2' height='%3'>").arg(src).arg(w).arg(h);
@@ -4828,9 +4915,9 @@ void MainWindow::on_viewComments_clicked()
         float wordAccuracy=100, charAccuracy=100, avgCharAcc = 100;
         QString version = mProject.get_version();
 
-        QJsonObject mainObj = readJsonFile(commentFilename);
-        QJsonObject pages = mainObj.value("pages").toObject();
-        QJsonObject page = pages.value(pageName).toObject();
+        JsonStore *commentStore = JsonStore::get(commentFilename);
+        QJsonObject mainObj = commentStore->object();
+        QJsonObject page = mainObj.value("pages").toObject().value(pageName).toObject();
 
         if( !mainObj.isEmpty() )
         {
@@ -4911,12 +4998,8 @@ void MainWindow::on_viewComments_clicked()
         page["wordaccuracy"] = wordAccuracy;
         page["pagename"] = pageName;
 
-        pages.remove(pageName);
-        pages.insert(pageName, page);
-        mainObj.remove("pages");
-        mainObj.insert("pages",pages);
-
-        mainObj = getAverageAccuracies(mainObj);
+        commentStore->insert({ "pages", pageName }, page);
+        mainObj = getAverageAccuracies(commentStore->object());
 
         if(mProject.get_stage() != mRole)
             rating = mainObj["Rating-V"+ QString::number(mProject.get_version().toInt() - 1)].toInt();
@@ -4925,7 +5008,7 @@ void MainWindow::on_viewComments_clicked()
         avgCharAcc = mainObj["AverageCharAccuracy"].toDouble();
         avgAcc = QString::number((((float)lround(avgCharAcc*100))/100)) + "%";
 
-        writeJsonFile(commentFilename, mainObj);
+        commentStore->setObject(mainObj);
 
         if(!gSaveTriggered)
         {
@@ -5015,69 +5098,21 @@ void MainWindow::on_compareVerifierOutput_clicked() //Verifier-Version
 
 //Global CPair Starts
 
-/*!
- * \fn MainWindow::dumpStringToFile
- * \brief Writes given QString to file at file_path
- * \param file_path
- * \param string
- */
-void MainWindow::dumpStringToFile(QString file_path, QString string){
-    QFile file(file_path);
-    if(file.open(QIODevice::WriteOnly | QIODevice::Append)){
-        QTextStream outputStream(&file);
-        outputStream << string << endl;
-    }
-    file.close();
-}
-
-/*!
- * \fn MainWindow::isStringInFile
- * \brief Checks if a QString is in file at file_path
- * \param file_path
- * \param searchString
- * \return 0 if not present and 1 if it is present
- */
-bool MainWindow::isStringInFile(QString file_path, QString searchString){
-
-    QFile fileToSearchIn(file_path);
-    bool textFound = false;
-
-    if(fileToSearchIn.open(QIODevice::ReadOnly | QIODevice::Text)){
-        QTextStream in(&fileToSearchIn);
-        QString line;
-
-        //! Check in everyline if string exists
-        do{
-            line = in.readLine();
-            if(line.contains(searchString)){
-                textFound = true;
-                break;
-            }
-        }while(!line.isNull());
-    }
-    fileToSearchIn.close();
-
-    return textFound;
-
-}
-
 /*!
  * \fn MainWindow::addCurrentlyOpenFileToEditedFilesLog
  * \brief adds currently opened file in editor in .EditedFiles.txt to mark it as dirty
+ * \sa Project::addEditedFile()
  */
 void MainWindow::addCurrentlyOpenFileToEditedFilesLog(){
-    QString editedFilesLogPath = gDirTwoLevelUp + "/Dicts/." +mRole+ "_EditedFiles.txt";
     QString currentFilePath = gDirTwoLevelUp + "/" + gCurrentDirName+ "/" + gCurrentPageName;
 
-    bool fileFound = isStringInFile(editedFilesLogPath, currentFilePath);
-
-    if(fileFound)
+    if(mProject.isFileEdited(mRole, currentFilePath))
         qDebug() << gCurrentPageName <<" already found in Edited Files Log. No need to update.";
     else
     {
         qDebug() << gCurrentPageName <<" not found in Edited Files Log."<<endl;
         qDebug()<< "Writing " <<currentFilePath << " to file." << endl;
-        dumpStringToFile(editedFilesLogPath, currentFilePath);
+        mProject.addEditedFile(mRole, currentFilePath);
     }
 }
 
@@ -5086,9 +5121,7 @@ void MainWindow::addCurrentlyOpenFileToEditedFilesLog(){
  * \brief Deletes .EditedFiles.txt which stores the edited files list
  */
 void MainWindow::deleteEditedFilesLog(){
-    QString editedFilesLogPath = gDirTwoLevelUp + "/Dicts/." + mRole+"_EditedFiles.txt";
-    QFile file(editedFilesLogPath);
-    file.remove();
+    mProject.clearEditedFiles(mRole);
 }
 
 /*!
@@ -5110,7 +5143,7 @@ int MainWindow::writeGlobalCPairsToFiles(QString file_path, QMap <QString, QStri
     f->close();
     f->open(QIODevice::WriteOnly);
 
-    int replaced = 0, tot_replaced = 0;
+    int tot_replaced = 0;
 
     //create new text browser for html files(such that replacement works on text instead of html)
     CustomTextBrowser * browser = new CustomTextBrowser();
@@ -5123,49 +5156,16 @@ int MainWindow::writeGlobalCPairsToFiles(QString file_path, QMap <QString, QStri
     browser->setFont(font);
     browser->setHtml(s1);
 
-    //!Replacing words by iterating the map
+    //!Replacing all the words of the map in one pass
+    QStringList words, replacementStrings;
     for (grmIterator = globalReplacementMap.begin(); grmIterator != globalReplacementMap.end(); ++grmIterator)
     {
-        QString grmItrKey = grmIterator.key();
-        QString pattern = ("(\\b)")+grmItrKey.trimmed()+("(\\b)"); // \b is word boundary, for cpp compilers an extra \ is required before \b, refer to QT docs for details
-        QRegExp re(pattern);
-        QString replacementString = re.cap(1) + grmIterator.value() + re.cap(2); // \1 would be replace by the first paranthesis i.e. the \b  and \2 would be replaced by the second \b by QT Regex
-        //   if(!mapOfReplacements.contains(grmIterator.key()))
-        string str = replacementString.toStdString();
-        QString::fromStdString(str).toUtf8();
-        QString replacementString1 = QString::fromStdString(str).trimmed();
+        words << grmIterator.key().trimmed();
+        replacementStrings << grmIterator.value().trimmed();
         mapOfReplacements[grmIterator.key()] = grmIterator.value().trimmed();
-
-        browser->moveCursor(QTextCursor::Start);
-        while(browser->find(re))
-        {
-            QTextCursor cursor = browser->textCursor(); //get the cursor
-            QTextCharFormat fmt;
-            int pos = cursor.position(); //get the cursor position
-            int ancr = pos - replacementString.size() + 1; //anchor is now cursor position - length of old word to be replaced
-            //qDebug()<<"pos : ancr"<<pos<<ancr;
-            if (pos < ancr) {
-                cursor.setPosition(pos, QTextCursor::MoveAnchor);
-                cursor.setPosition(ancr, QTextCursor::KeepAnchor);
-            }
-            fmt = cursor.charFormat(); //get the QTextCharFormat of old word/phrase to be replaced
-            browser->textCursor().insertText(replacementString1);
-            cursor = browser->textCursor(); //get new cursor position after old word is replaced by new one
-
-            pos = cursor.position();
-            ancr = pos - replacementString1.size();//anchor is cursor position - new word/phrase length
-            cursor.setPosition(pos, QTextCursor::MoveAnchor);
-            cursor.setPosition(ancr, QTextCursor::KeepAnchor);
-            //qDebug()<<"pos : ancr"<<pos<<ancr;
-            cursor.mergeCharFormat(fmt); //apply the text properties captured earlier
-
-            tot_replaced = tot_replaced + 1;
-        }
-        //qDebug()<<"word ="<<grmIterator.key()+":"+replacementString1;
-        //        s1.replace(re, replacementString1);
-        //        replaced = s1.count(replacementString1);
-        //        tot_replaced = tot_replaced + replaced;
     }
+    WordMatcher matcher(words);
+    tot_replaced = matcher.replaceInDocument(browser->document(), replacementStrings, false);
 
     s1 = browser->toHtml();
     in << s1;
@@ -5174,6 +5174,8 @@ int MainWindow::writeGlobalCPairsToFiles(QString file_path, QMap <QString, QStri
     browser->close();
     GlobalReplaceWorker grw;
     grw.bboxInsertion(file_path);
+    if(tot_replaced > 0)
+        mProject.markForCommit(file_path);
     return tot_replaced;
 }
 
@@ -5486,8 +5488,6 @@ void MainWindow::runGlobalReplace(QString currentFileDirectory , QVector <QStrin
     */
     QVector<int> replaceInAllPages;
 
-    QString editedFilesLogPath = gDirTwoLevelUp + "/Dicts/." + mRole+"_EditedFiles.txt";
-
     int noOfChangedWords = changedWords.size();
     int files = 0;
     int r1 = 0, r2 = 0;
@@ -5587,7 +5587,8 @@ void MainWindow::runGlobalReplace(QString currentFileDirectory , QVector <QStrin
                     &x1,
                     &files,
                     pairMap,
-                    mRole
+                    mRole,
+                    mProject.getEditedFiles(mRole)
                     );
 
         QThread *thread = new QThread;
@@ -5607,6 +5608,12 @@ void MainWindow::runGlobalReplace(QString currentFileDirectory , QVector <QStrin
         progressBarDialog->setModal(false);
         progressBarDialog->exec();
 
+        for (const QString &changedFile : filesChangedUsingGlobalReplace) {
+            mProject.markForCommit(changedFile);
+            //! and the bbox file GlobalReplaceWorker::saveBboxInfo() writes beside it
+            QString bboxFile = changedFile;
+            mProject.markForCommit(bboxFile.replace(".html", ".bbox").replace("CorrectorOutput", "bboxf"));
+        }
     }
     map<string, string> new_cpair;
     QMapIterator<QString, QString>i(globalReplacementMap);
@@ -5633,6 +5640,12 @@ void MainWindow::runGlobalReplace(QString currentFileDirectory , QVector <QStrin
     QThread *thread = new QThread;
 
     connect(thread, SIGNAL(started()), worker, SLOT(addCpair()));
+    //! the replaced words have new CPairs entries, their cached suggestions are recomputed when asked for
+    connect(worker, &Worker::finished, this, [this, new_cpair]() {
+        if (!suggestionService) return;
+        for (auto &elem : new_cpair)
+            suggestionService->invalidate(elem.first);
+    });
     worker->moveToThread(thread);
     thread->start();
     QString msg  = QString::fromStdString(std::to_string(globalReplacementMap.values().length()) + " words changed" + "\n" + std::to_string(r2) + " instances replaced" + "\n" + std::to_string(files) + " files modified");
@@ -5696,7 +5709,7 @@ void MainWindow::globalReplacePreviewfn(QMap <QString, QString> previewMap , QVe
 
         if(previewMap.size() >= 1)
         {
-            QString editedFilesLogPath = gDirTwoLevelUp + "/Dicts/." + mRole+"_EditedFiles.txt";
+            const QSet<QString> &editedFiles = mProject.getEditedFiles(mRole);
             QString currentFileDirectory =gDirTwoLevelUp + "/" + gCurrentDirName;;
             QDirIterator dirIterator(currentFileDirectory, QDirIterator::Subdirectories);
             QMap<QString,QStringList> lines;
@@ -5705,7 +5718,7 @@ void MainWindow::globalReplacePreviewfn(QMap <QString, QString> previewMap , QVe
             {
                 QString it_file_path = dirIterator.next();
 
-                bool isFileInEditedFilesLog = isStringInFile(editedFilesLogPath, it_file_path);
+                bool isFileInEditedFilesLog = editedFiles.contains(it_file_path);
                 QString suff = dirIterator.fileInfo().completeSuffix();
                 if (!isFileInEditedFilesLog)
                 {
@@ -5799,76 +5812,74 @@ void MainWindow::globalReplacePreviewfn(QMap <QString, QString> previewMap , QVe
  * Then it runs a for loop wherein we loop through the global replace word map and otain the key and value and
  * store them as oldword and newword respectively
  *
- * We run a regex which will allow us to get handful of words before and after the replaced word which will be
- * shown in the preview dialog box.
- *
- * We run the regex for occurances wherein we capture the matched pattern and replace the old word with the new word,
- * and return both the sentences along with the file name.
+ * All the old words are found in one pass over the plain text of the page by a WordMatcher, the same whole word
+ * matching that global replace uses.
  *
+ * For every occurrence we take the sentence (the part of the line between two dandas) around it and replace the
+ * old word with the new word in it, and return both the sentences along with the file name.
+ * A sentence is listed once per old word even if the word occurs in it several times.
  *
  * \param fPath
  * \param globalReplacementMap
  */
 QMap<QString,QStringList> MainWindow::getBeforeAndAfterWords(QString fPath,QMap <QString, QString> globalReplacementMap)
 {
-    //qDebug()<<"grm:"<<globalReplacementMap;
     QStringList sentences;
     QMap <QString, QString>::iterator grmIterator;
-    QFile *f = new QFile(fPath);
+    QFile f(fPath);
     QMap <QString, QStringList> previewPagesMap;
 
-    f->open(QIODevice::ReadOnly);
-    QTextStream in(f);
+    f.open(QIODevice::ReadOnly);
+    QTextStream in(&f);
     in.setCodec("UTF-8");
     QString s1 = in.readAll();
-    QTextDocumentFragment fragment;
-    QString plain = fragment.fromHtml(s1).toPlainText();
-    f->close();
+    QString plain = HtmlToText::toPlainText(s1);
+    f.close();
 
+    QStringList oldWords, newWords;
     for (grmIterator = globalReplacementMap.begin(); grmIterator != globalReplacementMap.end(); ++grmIterator)
     {
-        QString oldWord = grmIterator.key();
-        QString newWord = grmIterator.value();
+        oldWords << grmIterator.key().trimmed();
+        newWords << grmIterator.value();
+    }
+    WordMatcher matcher(oldWords);
+    QVector<WordMatcher::Match> matches = matcher.findAll(plain);
 
-        QRegularExpression rx(".*"+oldWord+"*"); //"[^.]*"+oldWord+"[^.]*\."
-        for(int i=0;i<rx.captureCount()+1;++i)
+    const QChar danda(0x0964);
+    QSet<QPair<int,int> > listed; // (sentence start, old word) already in the preview
+    for (int i = 0; i < matches.size(); i++)
+    {
+        const WordMatcher::Match &m = matches[i];
+        int lineStart = plain.lastIndexOf('\n', m.position - 1) + 1;
+        int lineEnd = plain.indexOf('\n', m.position);
+        if (lineEnd < 0)
+            lineEnd = plain.size();
+        int start = std::max(lineStart, plain.lastIndexOf(danda, m.position - 1) + 1);
+        int end = plain.indexOf(danda, m.position + m.length);
+        if (end < 0 || end > lineEnd)
+            end = lineEnd;
+        if (listed.contains(qMakePair(start, m.pattern)))
+            continue;
+        listed.insert(qMakePair(start, m.pattern));
+
+        //! replace every occurrence of this old word in the sentence, last one first
+        QString matched = plain.mid(start, end - start);
+        QString newSentence = matched;
+        int last = i;
+        while (last + 1 < matches.size() && matches[last + 1].position < end)
+            last++;
+        for (int j = last; j >= i; j--)
         {
-            QRegularExpressionMatchIterator match = rx.globalMatch(plain);
-            while(match.hasNext())
-            {
-                QRegularExpressionMatch Extmatch = match.next();
-                QString matched = Extmatch.captured(i);
-                //qDebug()<<"Matched:"<<matched;
-                string no_dn[]={"०","१","२","३","४","५","६","७","८","९","॥","।","–","—"};
-                QStringList list = matched.split(QString::fromStdString(no_dn[11]), QString::SkipEmptyParts);
-                //qDebug()<<"list:"<<list;
-                for(i=0;i<list.size();i++)
-                {
-                    if(list[i].contains(oldWord))
-                    {
-                        matched = list[i];
-                        break;
-                    }
-                }
-                QString newSentence = matched;
-                //qDebug()<<oldWord<<newWord;
-                oldWord = oldWord.trimmed();
-                newSentence = newSentence.replace(oldWord,newWord,Qt::CaseSensitive);
-                QTextCursor cursor;
-                QTextCharFormat fmt;
-                fmt.setBackground(Qt::blue);
-                cursor.mergeCharFormat(fmt);
-                QString finalSentence = matched + "==>" + newSentence;
-                //              qDebug() << "Final Sentence" << finalSentence;
-                if(newSentence.length() >0 )
-                {
-                    sentences << finalSentence;
-                }
-            }
+            if (matches[j].pattern == m.pattern && matches[j].position + matches[j].length <= end)
+                newSentence.replace(matches[j].position - start, matches[j].length, newWords.at(m.pattern));
+        }
+        QString finalSentence = matched + "==>" + newSentence;
+        if(newSentence.length() >0 )
+        {
+            sentences << finalSentence;
         }
     }
-    QFile file(fPath);
-    QFileInfo fileInfo(file);
+    QFileInfo fileInfo(f);
     QString fileName = fileInfo.fileName();
 
     previewPagesMap[fileName] = sentences;
@@ -6196,7 +6207,7 @@ QJsonObject MainWindow::getAverageAccuracies(QJsonObject mainObj)
  * \fn MainWindow::updateAverageAccuracies
  * \brief The function updates accuracy and error on word and charater level to
  * the files named comments.json and AverageAccuracies.csv
- * \sa readJsonFile(), writeJsonFile()
+ * \sa JsonStore
  */
 void MainWindow::updateAverageAccuracies() //Verifier only
 {
@@ -6211,7 +6222,8 @@ void MainWindow::updateAverageAccuracies() //Verifier only
     csvFile<<"Page Name,"<< "Word-Level Accuracy,"<<"Character-Level Accuracy," <<"Word-Level Errors,"<<"Character-Level Errors"<<"\n";
 
     //!Read the Json Objects and terminates functions if the file is empty
-    QJsonObject mainObj = readJsonFile(commentFilename);
+    JsonStore *commentStore = JsonStore::get(commentFilename);
+    QJsonObject mainObj = commentStore->object();
     if(mainObj.isEmpty())
         return;
     float totalcharacc=0, totalwordacc = 0; int totalcharerrors = 0, totalworderrors = 0, count = 0, rating = 0;
@@ -6264,7 +6276,7 @@ void MainWindow::updateAverageAccuracies() //Verifier only
         //!Calculate and update the value of accuracy and error to csv on Character and Word level
         csvFile<<" ,"<< "Average Accuracy (Word level),"<<"Average Accuracy (Character-Level)," <<"Average Errors (Word level),"<<"Average Errors (Character-Level),"<<"\n";
         csvFile <<" " <<"," << totalwordacc/count << "," << totalcharacc/count << "," << totalworderrors/count<< "," << totalcharerrors/count<<"\n";
-        writeJsonFile(commentFilename, mainObj);
+        commentStore->setObject(mainObj);
 
     }
 }
@@ -6302,6 +6314,7 @@ void MainWindow::on_actionAdd_Image_triggered()
                 QFileInfo finfo(destinationFileName);
             }
             QFile::copy(file, destinationFileName);
+            mProject.markForCommit(destinationFileName);
             copiedFileName = QDir::current().relativeFilePath(destinationFileName);
 
             //QUrl Uri ( QString ( "file://%1" ).arg ( file ) );
@@ -6582,6 +6595,7 @@ void MainWindow::LoadDocument(QFile * f, QString ext, QString name)
                     out << input;
                     out.flush();
                     f->close();
+                    mProject.markForCommit(f->fileName());
 
                     if (handleBbox != nullptr) {
                         delete handleBbox;
@@ -6654,6 +6668,7 @@ QScrollBar::sub-line:vertical {
                     })";
                 curr_browser->setDocument(b->document()->clone(curr_browser));
                 curr_browser->document()->clearUndoRedoStacks();
+                connect(curr_browser->document(), SIGNAL(contentsChange(int,int,int)), this, SLOT(requestChangedSuggestions(int,int,int)));
 
                 QFileInfo info(*f);
                 currentTabPageName = info.fileName();
@@ -6758,6 +6773,7 @@ QScrollBar::sub-line:vertical {
                 delete b;
                 myTimer.start();
                 WordCount();     //for counting no of words in the document
+                requestSuggestions(curr_browser->toPlainText());
                 readSettings();
                 if(danFlag == 1){
                     initialSave = true;
@@ -6818,8 +6834,7 @@ QScrollBar::sub-line:vertical {
 
     QSettings settings("IIT-B", "OpenOCRCorrect");
     if(mRole == "Corrector"){
-        QStringList pageNames = correct.keys();
-        if(pageNames.contains(name)){
+        if(pageStatus.has(name, PageStatusIndex::Corrected)){
             ui->corrected->setChecked(true);
             on_corrected_stateChanged(2);
         }
@@ -6829,8 +6844,7 @@ QScrollBar::sub-line:vertical {
         }
     }
     else if(mRole == "Verifier"){
-        QStringList pageNames = verify.keys();
-        if(pageNames.contains(name)){
+        if(pageStatus.has(name, PageStatusIndex::Verified)){
             ui->verified->setChecked(true);
             on_verified_stateChanged(2);
         }
@@ -6989,6 +7003,7 @@ QScrollBar::sub-line:vertical {
         out << input;
         out.flush();
         f->close();
+        mProject.markForCommit(f->fileName());
 
         if (handleBbox != nullptr) {
             delete handleBbox;
@@ -7061,6 +7076,7 @@ QScrollBar::sub-line:vertical {
                     })";
     curr_browser->setDocument(b->document()->clone(curr_browser));
     curr_browser->document()->clearUndoRedoStacks();
+    connect(curr_browser->document(), SIGNAL(contentsChange(int,int,int)), this, SLOT(requestChangedSuggestions(int,int,int)));
 
     QFileInfo info(*f);
     currentTabPageName = info.fileName();
@@ -7165,6 +7181,7 @@ QScrollBar::sub-line:vertical {
     delete b;
     myTimer.start();
     WordCount();     //for counting no of words in the document
+    requestSuggestions(curr_browser->toPlainText());
     readSettings();
     if(danFlag == 1){
         initialSave = true;
@@ -7199,6 +7216,9 @@ QScrollBar::sub-line:vertical {
  * \fn MainWindow::LoadImageFromFile
  * \brief This functions loads the image file in the image tab and provides all the functionality
  *        like zoom , cut and resize on that image file.
+ * \details The scan is shown by a ScanImageItem: only a preview at the size of the view is decoded here, usually
+ * prefetched already, and the tiles for higher zoom levels are decoded in the background when they are needed.
+ * The scene keeps the pixel coordinates of the full scan.
  * \param f
  */
 void MainWindow::LoadImageFromFile(QFile * f)
@@ -7209,10 +7229,13 @@ void MainWindow::LoadImageFromFile(QFile * f)
     ui->horizontalSlider->setValue(100);
     ui->zoom_level_value->setText("100%");
 
-    imageOrig.load(localFileName);
+    pageImages->cancelTiles();
+    scanImagePath = localFileName;
+    QSize fullSize = PageImageCache::imageSize(localFileName);
+    QImage preview = pageImages->preview(localFileName, scanPreviewSize());
     if (graphic)delete graphic;
     graphic = new QGraphicsScene(this);
-    graphic->addPixmap(QPixmap::fromImage(imageOrig));
+    graphic->addItem(new ScanImageItem(pageImages, localFileName, fullSize, preview));
     ui->graphicsView->setScene(graphic);
     ui->graphicsView->fitInView(graphic->itemsBoundingRect(), Qt::KeepAspectRatio);
     if (z)delete z;
@@ -7230,6 +7253,8 @@ void MainWindow::LoadImageFromFile(QFile * f)
     ui->graphicsView->setMouseTracking(true);
     ui->graphicsView->viewport()->installEventFilter(this);
 
+    prefetchNeighbourImages();
+
     // Zooming upto currentZoomLevel
     if (currentZoomLevel == z->zoom_level) {
         return;
@@ -7243,6 +7268,64 @@ void MainWindow::LoadImageFromFile(QFile * f)
     z->gentle_zoom(factor_to_be_applied);
 }
 
+/*!
+ * \fn MainWindow::scanPreviewSize
+ * \brief Size the previews of the scans are decoded at: twice the view, so zooming up to 200% needs no tiles
+ * \return QSize
+ */
+QSize MainWindow::scanPreviewSize()
+{
+    QSize viewSize = ui->graphicsView->viewport()->size() * ui->graphicsView->devicePixelRatioF();
+    return viewSize.expandedTo(QSize(512, 512)) * 2;
+}
+
+/*!
+ * \fn MainWindow::imageFileForPage
+ * \brief Finds the scan of a page in the Images folder of the set
+ * \param pageName
+ * \return path of the scan, empty if there is none
+ */
+QString MainWindow::imageFileForPage(const QString &pageName)
+{
+    QString base = mProject.GetDir().absolutePath() + "/Images/" + QFileInfo(pageName).completeBaseName();
+    const QStringList extensions = { ".jpeg", ".png", ".jpg" };
+    for (const QString &ext : extensions) {
+        if (QFile::exists(base + ext))
+            return base + ext;
+    }
+    return QString();
+}
+
+/*!
+ * \fn MainWindow::prefetchNeighbourImages
+ * \brief Decodes the previews of the scans of the next and previous pages in the background, so that
+ *        on_actionLoad_Next_Page_triggered() and on_actionLoad_Prev_Page_triggered() do not wait for the decoder
+ * \details The neighbours are found in the tree view the same way those two functions find them.
+ */
+void MainWindow::prefetchNeighbourImages()
+{
+    if (!ui->treeView->model())
+        return;
+    QModelIndex parentIndex = ui->treeView->selectionModel()->currentIndex().parent();
+    auto model = ui->treeView->model();
+    int rowCount = model->rowCount(parentIndex);
+    QSize size = scanPreviewSize();
+
+    for (int i = 0; i < rowCount; i++) {
+        if (model->index(i, 0, parentIndex).data(Qt::DisplayRole).toString() != currentTabPageName)
+            continue;
+        QStringList neighbours;
+        neighbours << model->index((i + 1) % rowCount, 0, parentIndex).data(Qt::DisplayRole).toString();
+        neighbours << model->index((i + rowCount - 1) % rowCount, 0, parentIndex).data(Qt::DisplayRole).toString();
+        for (const QString &page : neighbours) {
+            QString imageFile = imageFileForPage(page);
+            if (!imageFile.isEmpty())
+                pageImages->prefetch(imageFile, size);
+        }
+        break;
+    }
+}
+
 /*!
  * \fn MainWindow::file_click
  * \brief This function checks for the type of file user clicked in the tree view then loads that file into
@@ -7763,17 +7846,7 @@ void MainWindow::closeEvent (QCloseEvent *event)
         }
     }
 
-    if(mRole == "Corrector"){
-        write_corrected_pages();
-    }
-    else if(mRole == "Verifier") {
-        write_verified_pages();
-    }
-
-    correct.clear();
-    verify.clear();
-    markForReview.clear();
-    recorrect.clear();
+    pageStatus.close();
 
     while (clipboardHistory.size() > 3)
     {
@@ -7890,7 +7963,8 @@ void MainWindow::highlight(CustomTextBrowser *b , QString input)
  * folder is opened and we scan the html contents of only html files in the folder.
  *
  * We then print the html contents using QPrinter and output it in the project set folder with the
- * name "Bookset.pdf".
+ * name "Bookset.pdf". PrintWorker prints the pages one after the other, so memory use does not grow with
+ * the number of pages.
  */
 void MainWindow::on_actionas_PDF_triggered()
 {
@@ -7910,17 +7984,7 @@ void MainWindow::on_actionas_PDF_triggered()
 
     //! Set count of files in directory
 
-    QString html_contents=""; // Final HTML Content
-    QString mainHtml;
     int count = dir.entryList(QStringList("*.html"), QDir::Files | QDir::NoDotAndDotDot).count();
-    int counter=0;
-
-    //    int stIndex, startFrom = 0;
-
-    //    //! Set the background of the pdf to be printed to be white
-    //    QString searchString = "background-color:#"; // string to be searched
-    //    int l = searchString.length();
-    //    QString whiteColor = "ffffff";
 
     int itr = 0;
     PdfRangeDialog *pdfRangeDialog = new PdfRangeDialog(this, count, 100);
@@ -7935,13 +7999,14 @@ void MainWindow::on_actionas_PDF_triggered()
 
         qDebug() << startPage << " : " << endPage;
 
-
-        //! Loop through all files
+        //! Only the names of the pages are collected here, PrintWorker reads and prepares them while it prints.
+        //! Blank pages are skipped by the worker and do not count in the range, so all the pages after the
+        //! start page are passed.
+        QStringList pageFiles;
         foreach(auto a, dir.entryList())
         {
             QString x = currentDirAbsolutePath + a;
 
-            //        startFrom = 0; // The position from which searchString will be scanned
             //! if condition makes sure we extract only html files for PDF Processing
             //! (folder has hocr, dict, htranslate, and other such files)
             if(x.contains("."))
@@ -7955,90 +8020,7 @@ void MainWindow::on_actionas_PDF_triggered()
                         itr++;
                         continue;
                     }
-
-                    QFile file(x);
-                    if (!file.open(QIODevice::ReadOnly)) qDebug() << "Error reading file main.html";
-                    QTextStream stream(&file);
-                    stream.setCodec("UTF-8");
-
-                    //! Read the file
-
-                    mainHtml=stream.readAll();
-                    mainHtml.replace("background-color:","Background-colour:");
-                    //                mainHtml.remove("background-color:");
-                    //                mainHtml.remove("background-color:#ffff00");
-                    //                //! Changing the text background to white by setting the background to #fffff
-                    //                while (true){
-                    //                    stIndex = mainHtml.indexOf(searchString, startFrom);
-                    //                    if (stIndex == -1)
-                    //                        break;
-                    //                    stIndex += l; // increment line
-                    //                    mainHtml.replace(stIndex, 6, whiteColor); // Here, 6 is used because length of whiteColor is 6
-                    //                    startFrom = stIndex + 6;
-                    //                }
-                    //! append counter when one file is fully scanned
-                    counter++;
-                    if(pdfRangeDialog->on_checkBox_clicked())
-                    {
-                        QTextDocument doc;
-                        doc.setHtml(mainHtml);
-                        QString s1 = doc.toPlainText();
-                        if(s1.count() == 0)
-                            continue;
-                    }
-
-                    //! Search for Latex code in html files and replace it by corresponding png images
-                    //! We save latext for mathematical equations in html, and show png in our tool as our tool can't render Latex
-                    if(mainHtml.contains("$$")){
-
-                        QRegularExpression rex_lat("<a(.*?)</a>",QRegularExpression::DotMatchesEverythingOption);
-                        QRegularExpressionMatchIterator itr_lat;
-                        itr_lat = rex_lat.globalMatch(mainHtml);
-                        while(itr_lat.hasNext()){
-
-                            QRegularExpressionMatch match = itr_lat.next();
-                            QString text = match.captured(1);
-
-                            if(text.contains("Equations_"))
-                            {
-                                int sindex = match.capturedStart(1);
-                                int l_index = match.capturedEnd(1);
-                                std::string inputText_ = text.toStdString();
-                                int ind = inputText_.find("/");
-                                int lindex = inputText_.find(".tex");
-
-                                std::string str = inputText_.substr(ind,lindex-ind);
-                                QString path = QString::fromStdString(str) + ".png";
-                                QString html = "<img src=\""+path+"\">";
-                                text = "<a"+text+"</a>";
-                                mainHtml.replace(text,html);
-                            }
-
-                        }
-                        mainHtml = mainHtml.replace("$$","dne_nqe"); //where dne_nqe is a random string used as end delimiter here.
-                        //Note that this string should not appear as an original text - else it will cause parsing issues.
-                        QRegularExpression rex_dollar("dne_nqe(.*?)dne_nqe",QRegularExpression::DotMatchesEverythingOption);
-                        mainHtml = mainHtml.remove(rex_dollar);
-                    }
-
-                    //! Once page html is extracted ... before we move to next page we add html tag
-                    //! for page break so that the PDF printer separates the pages
-                    //! We do this till all pages done
-                    if(counter<count){
-                        mainHtml+="<P style=\"page-break-before: always\"></P>";
-                    }
-                    file.close();
-                    html_contents.append(mainHtml);
-                    itr++;
-
-                    if (itr == endPage) {
-                        break;
-                    }
-
-                }
-                //! if file is not html
-                else {
-                    continue;
+                    pageFiles << x;
                 }
             }
         }
@@ -8056,7 +8038,7 @@ void MainWindow::on_actionas_PDF_triggered()
         QPrintDialog printDialog(&printer, this);
 
         if (printDialog.exec() == QDialog::Accepted) {
-            PrintWorker *workerPrint = new PrintWorker(nullptr, html_contents);
+            PrintWorker *workerPrint = new PrintWorker(nullptr, pageFiles, endPage - startPage, pdfRangeDialog->on_checkBox_clicked());
             QThread *thread = new QThread;
             workerPrint->printer = printDialog.printer(); // Assigning the printer for printing (VERY IMPORTANT)
 
@@ -8064,14 +8046,15 @@ void MainWindow::on_actionas_PDF_triggered()
             connect(workerPrint, SIGNAL(finishedPrintingPDF()), thread, SLOT(quit()));
             connect(workerPrint, SIGNAL(finishedPrintingPDF()), workerPrint, SLOT(deleteLater()));
             connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
-            connect(workerPrint, SIGNAL(finishedPrintingPDF()), this, SLOT(stopSpinning()));
+            connect(workerPrint, SIGNAL(finishedPrintingPDF()), this, SLOT(closeProgressBar()));
+            connect(workerPrint, SIGNAL(changeProgressBarValue(int)), this, SLOT(setProgressBarPerc(int)));
 
             workerPrint->moveToThread(thread);
             thread->start();
-            spinner = new LoadingSpinner(this);
-            spinner->SetMessage("Printing PDF...", "Printing...");
-            spinner->setModal(false);
-            spinner->exec();
+            progressBarDialog = new ProgressBarDialog(this);
+            progressBarDialog->setMessage("Printing PDF...");
+            progressBarDialog->setModal(false);
+            progressBarDialog->exec();
 
 
             QMessageBox::information(this, "Print Successful", "Printed PDF successfully", QMessageBox::Ok, QMessageBox::Ok);
@@ -8846,14 +8829,12 @@ void MainWindow::RecentPageInfo()
     }
 
     if(mRole == "Corrector"){
-        QStringList pageNames = correct.keys();
-        if(pageNames.contains(var1)){
+        if(pageStatus.has(var1, PageStatusIndex::Corrected)){
             ui->corrected->setChecked(true);
         }
     }
     else if (mRole == "Verifier"){
-        QStringList pageNames = verify.keys();
-        if(pageNames.contains(var1)){
+        if(pageStatus.has(var1, PageStatusIndex::Verified)){
             ui->verified->setChecked(true);
         }
     }
@@ -9227,6 +9208,7 @@ void MainWindow::bboxInsertion(QFile *f){
             out2 << text;
             file->flush();      //!Flushes any buffered data waiting to be written in the \a sFile
             file->close();      //!Closing the file
+            mProject.markForCommit(file->fileName());
         }
         bbox_list.clear();bbox_list_.clear();
     }
@@ -9421,6 +9403,7 @@ void MainWindow::insertImageAction()
     if(!QDir("../Inserted_Images").exists())
         QDir().mkdir("../Inserted_Images");
     QFile::copy(imgFilePath,copiedImgFilePath);
+    mProject.markForCommit(copiedImgFilePath);
     qDebug()<<imgFilePath<<"\n"<<copiedImgFilePath;
     //    int height =0;
     //    int width = 0;
@@ -9655,17 +9638,7 @@ void MainWindow::on_actionClose_project_triggered()
 
     AddRecentProjects();
 
-    if(mRole == "Corrector"){
-        write_corrected_pages();
-    }
-    else if(mRole == "Verifier") {
-        write_verified_pages();
-    }
-
-    correct.clear();
-    verify.clear();
-    markForReview.clear();
-    recorrect.clear();
+    pageStatus.close();
 
     ui->corrected->setVisible(false);
     ui->verified->setVisible(false);
@@ -9691,9 +9664,13 @@ void MainWindow::on_actionClose_project_triggered()
         // opened or not
     }
     mProject.setProjectOpen(false);
+    projectScanId++;    // batches of the project scan still on their way are dropped
+    JsonStore::closeAll();      // the comment and log files of the project are written out in full
     //disableing the buttons after project is closed
     e_d_features(false);
     //Reset loadData flag
+    resetSuggestions();
+    QWriteLocker locker(&suggestionDataLock);
     LoadDataFlag = 1;
     //reset data
     mFilename.clear();
@@ -9716,6 +9693,7 @@ void MainWindow::on_actionClose_project_triggered()
     TPWordsP.clear();
     synonym.clear();
     synrows.clear();
+    locker.unlock();
 
     if(ui->lineEdit_3->text()!="" && ui->lineEdit_3->text()!="Words 0" && ui->lineEdit_3->text()!="0 Words"){
         curr_browser->clear();
@@ -9866,17 +9844,7 @@ void MainWindow::on_actionEdit_Equation_triggered()
  */
 void MainWindow::on_actionExit_triggered()
 {
-    if(mRole == "Corrector"){
-        write_corrected_pages();
-    }
-    else if(mRole == "Verifier") {
-        write_verified_pages();
-    }
-
-    markForReview.clear();
-    correct.clear();
-    verify.clear();
-    recorrect.clear();
+    pageStatus.close();
     QSettings settings("IIT-B", "OpenOCRCorrect");
     settings.beginGroup("login");
     QString email = settings.value("email").toString();
@@ -10219,14 +10187,7 @@ void MainWindow::cloud_save(){
     messageTimer();
     QString date = QDate::currentDate().toString();
     QString corrected_count = gDirTwoLevelUp + "/Comments/"+mRole+"_count.json";
-    QJsonObject mainObj, parObj;
-    parObj = readJsonFile(corrected_count);
-    mainObj = parObj[date].toObject();
-    //    QString Verifier = mainObj["Verifier"].toString();
-    mainObj.insert(mRole, gCurrentPageName);
-    //    mainObj.insert("Verifier", Verifier);
-    parObj.insert(date, mainObj);
-    writeJsonFile(corrected_count, parObj);
+    JsonStore::get(corrected_count)->insert({ date, mRole }, gCurrentPageName);
     QNetworkAccessManager* manager = new QNetworkAccessManager();
     QUrl url_("https://translate.udaanproject.org/udaan/email/");
 
@@ -11047,6 +11008,7 @@ void MainWindow::insertImage(QImage img)
     QString count = QString::number(dir.count() +1);
     QString file_name = "../Inserted_Images/"+count+".png";
     img.save(file_name);
+    mProject.markForCommit(file_name);
     QString html = "<img src=\""+file_name+"\">";
     QTextCursor cursor = curr_browser->textCursor();
     cursor.insertHtml(html);
@@ -11970,20 +11932,20 @@ void MainWindow::on_mark_review_clicked()
         return;
     }
 
-    if(ui->mark_review->checkState() == Qt::Checked && correct[currentFile] != 0){
-        markForReview[currentFile] = 1;
+    if(ui->mark_review->checkState() == Qt::Checked && pageStatus.has(currentFile, PageStatusIndex::Corrected)){
+        pageStatus.set(currentFile, PageStatusIndex::MarkedForReview);
         ui->mark_review->setChecked(true);
         ui->verified->setEnabled(false);
         ui->status->setText("Marked For Review");
     }
-    else if(correct[currentFile] != 0){
-        markForReview[fileName] = 0;
+    else if(pageStatus.has(currentFile, PageStatusIndex::Corrected)){
+        pageStatus.set(fileName, PageStatusIndex::MarkedForReview, false);
         ui->status->setText("Corrected");
         ui->verified->setEnabled(true);
         ui->mark_review->setEnabled(true);
     }
     else{
-        markForReview[fileName] = 0;
+        pageStatus.set(fileName, PageStatusIndex::MarkedForReview, false);
         //ui->verified->setChecked(false);
         ui->verified->setEnabled(false);
         ui->mark_review->setEnabled(false);
@@ -11992,63 +11954,44 @@ void MainWindow::on_mark_review_clicked()
 }
 
 /*!
- * \fn MainWindow::write_corrected_pages
- * \brief This function will write the entries to QSettings from the QMap
+ * \fn MainWindow::openPageStatus
+ * \brief Opens the page status index of the set for the current role, in logs/<role>_page_status.dat
+ * \details Each role has its own index so that the corrector and the verifier never change the same file. A set
+ * opened for the first time since the index was introduced gets the corrected or verified pages that were stored in
+ * QSettings. Marked for review and recorrected only last for a session, as before.
  */
-void MainWindow::write_corrected_pages(){
-    QSettings settings("IIT-B", "OpenOCRCorrect");
-    settings.beginGroup("CorrectedPages");
-
-    QStringList pageNames = correct.keys();
-    settings.setValue(gCurrentBookName + "/pages", pageNames);
-    settings.endGroup();
-}
+void MainWindow::openPageStatus(){
+    QString indexPath = gDirTwoLevelUp + "/logs/" + mRole + "_page_status.dat";
+    if(pageStatus.open(indexPath)){
+        pageStatus.clear(PageStatusIndex::MarkedForReview);
+        pageStatus.clear(PageStatusIndex::Recorrected);
+        return;
+    }
 
-/*!
- * \fn MainWindow::read_corrected_pages
- * \brief This function will read the entries from the QSettings and store it in the QMap
-*/
-void MainWindow::read_corrected_pages(){
     QSettings settings("IIT-B", "OpenOCRCorrect");
-    settings.beginGroup("CorrectedPages");
-
+    PageStatusIndex::Status status = PageStatusIndex::Corrected;
+    if(mRole == "Verifier"){
+        settings.beginGroup("VerifiedPages");
+        status = PageStatusIndex::Verified;
+    }
+    else {
+        settings.beginGroup("CorrectedPages");
+    }
     QStringList pageNames = settings.value(gCurrentBookName + "/pages").toStringList();
+    settings.endGroup();
 
     foreach(const QString &pageName, pageNames){
-        correct[pageName] = 1;
+        pageStatus.set(pageName, status);
     }
-
-    settings.endGroup();
 }
 
 /*!
- * \fn MainWindow::write_verified_pages
- * \brief This function will write the entries to QSettings from the QMap
+ * \fn MainWindow::showPageStatusCounts
+ * \brief Shows the number of corrected and verified pages of the set in the tooltips of their checkboxes
  */
-void MainWindow::write_verified_pages(){
-    QSettings settings("IIT-B", "OpenOCRCorrect");
-    settings.beginGroup("VerifiedPages");
-
-    QStringList pageNames = verify.keys();
-    settings.setValue(gCurrentBookName + "/pages", pageNames);
-    settings.endGroup();
-}
-
-/*!
- * \fn MainWindow::read_verified_pages
- * \brief This function will read the entries from the QSettings and store it in the QMap
-*/
-void MainWindow::read_verified_pages(){
-    QSettings settings("IIT-B", "OpenOCRCorrect");
-    settings.beginGroup("VerifiedPages");
-
-    QStringList pageNames = settings.value(gCurrentBookName + "/pages").toStringList();
-
-    foreach(const QString &pageName, pageNames){
-        verify[pageName] = 1;
-    }
-
-    settings.endGroup();
+void MainWindow::showPageStatusCounts(){
+    ui->corrected->setToolTip(QString::number(pageStatus.count(PageStatusIndex::Corrected)) + " pages corrected");
+    ui->verified->setToolTip(QString::number(pageStatus.count(PageStatusIndex::Verified)) + " pages verified");
 }
 
 /*!
@@ -12065,7 +12008,7 @@ void MainWindow::read_review_pages(){
     while(!in.atEnd()) {
         QString line = in.readLine();
         if(!line.contains(".html"))continue;
-        markForReview[line] = 1;
+        pageStatus.set(line, PageStatusIndex::MarkedForReview);
     }
     f.close();
 }
@@ -12096,20 +12039,13 @@ void MainWindow::write_review_pages(){
             QString line = "";
             while(!in.atEnd()) {
                 line = in.readLine(20);
-                if(markForReview[line] != 0) markForReview[line] = 0;
+                pageStatus.set(line, PageStatusIndex::MarkedForReview, false);
             }
 
             QTextStream outputStream(&f);
-            QString string;
-            QMapIterator<QString , int>i(markForReview);
-
-            while(i.hasNext()){
-                i.next();
-                string = i.key();
-                correct[string] = 0;
-                if(i.value() != 0){
-                    outputStream << string << endl;
-                }
+            foreach(const QString &string, pageStatus.pages(PageStatusIndex::MarkedForReview)){
+                pageStatus.set(string, PageStatusIndex::Corrected, false);
+                outputStream << string << endl;
             }
             f.close();
         }
@@ -12130,7 +12066,7 @@ void MainWindow::read_recorrected_pages(){
     while(!in.atEnd()) {
         QString line = in.readLine();
         if(!line.contains(".html"))continue;
-        recorrect[line] = 1;
+        pageStatus.set(line, PageStatusIndex::Recorrected);
     }
     f.close();
 }
@@ -12156,15 +12092,8 @@ void MainWindow::write_recorrected_pages(){
 
     if(f.open(QIODevice::WriteOnly)){
         QTextStream outputStream(&f);
-        QString string;
-        QMapIterator<QString , int>i(recorrect);
-        while(i.hasNext()){
-            i.next();
-            string = i.key();
-
-            if(i.value() != 0){
-                outputStream << string << endl;
-            }
+        foreach(const QString &string, pageStatus.pages(PageStatusIndex::Recorrected)){
+            outputStream << string << endl;
         }
         f.close();
     }
@@ -12214,22 +12143,22 @@ void MainWindow::on_actionJustified_triggered()
 void MainWindow::pageStatusHandler(){
     if(mRole == "Corrector"){
         ui->corrected->setEnabled(true);
-        if(verify[gCurrentPageName] != 0){
+        if(pageStatus.has(gCurrentPageName, PageStatusIndex::Verified)){
             ui->status->setText("Verified");
             ui->corrected->setChecked(true);
             ui->corrected->setEnabled(false);
             if(curr_browser) curr_browser->setReadOnly(true);
         }
         else {
-            if(recorrect[gCurrentPageName] != 0){
+            if(pageStatus.has(gCurrentPageName, PageStatusIndex::Recorrected)){
                 ui->status->setText("Corrected");
                 ui->corrected->setChecked(true);
             }
-            else if(markForReview[gCurrentPageName] != 0){
+            else if(pageStatus.has(gCurrentPageName, PageStatusIndex::MarkedForReview)){
                 ui->status->setText("Marked For Review");
                 ui->corrected->setChecked(false);
             }
-            else if(correct[gCurrentPageName] != 0){
+            else if(pageStatus.has(gCurrentPageName, PageStatusIndex::Corrected)){
                 ui->status->setText("Corrected");
                 ui->corrected->setChecked(true);
             }
@@ -12241,36 +12170,36 @@ void MainWindow::pageStatusHandler(){
         }
     }
     if(mRole == "Verifier"){
-        if(correct[gCurrentPageName] != 0){
+        if(pageStatus.has(gCurrentPageName, PageStatusIndex::Corrected)){
             ui->verified->setEnabled(true);
             ui->mark_review->setEnabled(true);
 
-            if(verify[gCurrentPageName] != 0){
+            if(pageStatus.has(gCurrentPageName, PageStatusIndex::Verified)){
                 ui->status->setText("Verified");
 //                ui->verified->setChecked(true);
                 ui->mark_review->setChecked(false);
                 ui->mark_review->setEnabled(false);
             }
-            else if(recorrect[gCurrentPageName] != 0){
+            else if(pageStatus.has(gCurrentPageName, PageStatusIndex::Recorrected)){
                 ui->status->setText("Corrected");
                 ui->mark_review->setChecked(true);
                 ui->verified->setChecked(false);
                 ui->verified->setEnabled(false);
             }
-            else if(markForReview[gCurrentPageName] != 0){
+            else if(pageStatus.has(gCurrentPageName, PageStatusIndex::MarkedForReview)){
                 ui->status->setText("Marked For Review");
                 ui->mark_review->setChecked(true);
                 ui->verified->setChecked(false);
                 ui->mark_review->setEnabled(true);
                 ui->verified->setEnabled(false);
             }
-            else if(correct[gCurrentPageName] != 0){
+            else if(pageStatus.has(gCurrentPageName, PageStatusIndex::Corrected)){
                 ui->status->setText("Corrected");
                 ui->mark_review->setChecked(false);
                 ui->verified->setChecked(false);
             }
         }
-        else if(markForReview[gCurrentPageName] != 0){
+        else if(pageStatus.has(gCurrentPageName, PageStatusIndex::MarkedForReview)){
             ui->status->setText("Marked For Review");
             ui->mark_review->setChecked(true);
             ui->mark_review->setEnabled(true);
@@ -12498,6 +12427,7 @@ void MainWindow::on_pushButton_7_clicked()
                 // Clear the file contents and write the updated JSON data back to the file
                 jsonFile.resize(0);
                 jsonFile.write(doc.toJson());
+                mProject.markForCommit(dictFilename);
             }
             else
             {
@@ -12673,7 +12603,6 @@ void MainWindow::handleOCR(QEvent* event, int& x1, int& y1, int& x2, int& y2)
     if(event->type() == QEvent::MouseButtonPress && shouldIOCR){
         QMouseEvent *mEvent = static_cast<QMouseEvent*>(event);
         QPointF pos =  ui->graphicsView->mapToScene( mEvent->pos());
-        QRgb rgb = imageOrig.pixel( ( int )pos.x(), ( int )pos.y());
 
         x1 = ( int )pos.x();
         y1 = ( int )pos.y();
@@ -12694,7 +12623,6 @@ void MainWindow::handleOCR(QEvent* event, int& x1, int& y1, int& x2, int& y2)
 
             QMouseEvent *mEvent = static_cast<QMouseEvent*>(event);
             QPointF pos =  ui->graphicsView->mapToScene( mEvent->pos());
-            QRgb rgb = imageOrig.pixel( ( int )pos.x(), ( int )pos.y());
 
             x2 = ( int )pos.x();
             y2 = ( int )pos.y();
@@ -12708,8 +12636,7 @@ void MainWindow::handleOCR(QEvent* event, int& x1, int& y1, int& x2, int& y2)
             int height = y2 - y1;
             crop_rect->setRect(x1, y1, width, height);
             QRect rect(x1, y1, width, height);
-            QPixmap image = QPixmap::fromImage(imageOrig);
-            QPixmap cropped = image.copy(rect);
+            QPixmap cropped = QPixmap::fromImage(pageImages->region(scanImagePath, rect));
 
             QMessageBox messageBox;
             messageBox.setWindowTitle("Do you want to OCR");
@@ -12857,11 +12784,6 @@ void MainWindow::on_actionRecentProject_triggered()
     }
     on_action1_triggered();
 
-    //correct.clear();
-    //verify.clear();
-    markForReview.clear();
-    recorrect.clear();
-
 }
 
 
@@ -12878,11 +12800,11 @@ void MainWindow::readCommentLogs(){
     QString dir = mProject.GetDir().absolutePath();
 
     QString commentFilename = gDirTwoLevelUp + "/Comments/" + jsonFile;
-    QJsonObject correctorComments = readJsonFile(commentFilename);
+    QJsonObject correctorComments = JsonStore::get(commentFilename)->object();
 
     jsonFile = "verifier_comments.json";
     commentFilename = gDirTwoLevelUp + "/Comments/" + jsonFile;
-    QJsonObject verifierComments = readJsonFile(commentFilename);
+    QJsonObject verifierComments = JsonStore::get(commentFilename)->object();
 
     QStringList list = correctorComments.keys();
 
@@ -13018,16 +12940,7 @@ void MainWindow::writeCommentLogs(QString word, QString comment)
     pagename.replace(".txt", "");
     pagename.replace(".html", "");
 
-    QJsonObject mainObj = readJsonFile(commentFilename);
-    QJsonObject page = mainObj.value(pagename).toObject();
-
-    page.remove(word);
-    page.insert(word,comment);
-
-    mainObj.remove(pagename);
-    mainObj.insert(pagename, page);
-
-    writeJsonFile(commentFilename, mainObj);
+    JsonStore::get(commentFilename)->insert({ pagename, word }, comment);
 }
 
 ///*!
@@ -13081,19 +12994,11 @@ void MainWindow::deleteComment()
     QString dir = mProject.GetDir().absolutePath();
 
     QString commentFilename = gDirTwoLevelUp + "/Comments/" + jsonFile;
-    QJsonObject mainObj = readJsonFile(commentFilename);
     QString pagename = gCurrentPageName;
     pagename.replace(".html","");
 
-    QJsonObject page = mainObj.value(pagename).toObject();
-
-    page.remove(word);
-
-    mainObj.remove(pagename);
-    mainObj.insert(pagename, page);
-
     highlightComment(true);
-    writeJsonFile(commentFilename, mainObj);
+    JsonStore::get(commentFilename)->remove({ pagename, word });
 }
 
 void MainWindow::on_actionUndo_Two_Column_view_triggered()
@@ -13326,6 +13231,7 @@ void MainWindow::on_copyToVerifier_clicked()
                     out.setCodec("UTF-8");
                     out << s;
                     verifierFile.close();
+                    mProject.markForCommit(verifierFilePath);
                     qDebug()<<"Copied to verifier";
                 }
                 correctorFile.close();
@@ -13345,6 +13251,7 @@ void MainWindow::on_copyToVerifier_clicked()
                 out.setCodec("UTF-8");
                 out << s;
                 verifierFile.close();
+                mProject.markForCommit(verifierFilePath);
                 qDebug()<<"Copied to verifier";
             }
             correctorFile.close();
@@ -13762,6 +13669,7 @@ void MainWindow::on_actionInsert_Line_Graph_triggered()
             qDebug() << "Error, Failed to save the image as PNG.";
         }
         else{
+            mProject.markForCommit(fileName);
             insertGraph(fileName, ok);
             // Display a message if could not insert graph as an image in curr_browser.
             if(!ok){
@@ -13838,6 +13746,7 @@ void MainWindow::on_actionInsert_Histogram_triggered()
             qDebug() << "Error, Failed to save the image as PNG.";
         }
         else{
+            mProject.markForCommit(fileName);
             insertGraph(fileName, ok);
             // Display a message if could not insert graph as an image in curr_browser.
             if(!ok){
@@ -15312,6 +15221,7 @@ void MainWindow::on_actionInsert_Pie_Chart_triggered()
                     qDebug() << "Error, Failed to save the image as PNG.";
                 }
                 else{
+                    mProject.markForCommit(fileName);
                     insertGraph(fileName, ok);
 
                     // Display a message if could not insert graph as an image in curr_browser.
@@ -16216,44 +16126,36 @@ void MainWindow::on_pushButton_9_clicked()
 
 void MainWindow::on_corrected_stateChanged(int arg1)
 {
-    QStringList pageNames = correct.keys();
     if(arg1 == 2){
-        if(!pageNames.contains(gCurrentOpenPage)){
-            correct[gCurrentOpenPage] = 1;
-        }
+        pageStatus.set(gCurrentOpenPage, PageStatusIndex::Corrected);
     }
     else if(arg1 == 0){
-        if(pageNames.contains(gCurrentOpenPage)){
-            correct.remove(gCurrentOpenPage);
-        }
+        pageStatus.set(gCurrentOpenPage, PageStatusIndex::Corrected, false);
     }
+    showPageStatusCounts();
 
-    updateTreeviewHighlights(correct);
+    updateTreeviewHighlights();
 }
 
 
 void MainWindow::on_verified_stateChanged(int arg1)
 {
-    QStringList pageNames = verify.keys();
     if(arg1 == 2){
-        if(!pageNames.contains(gCurrentOpenPage)){
-            verify[gCurrentOpenPage] = 1;
-        }
+        pageStatus.set(gCurrentOpenPage, PageStatusIndex::Verified);
     }
     else if(arg1 == 0){
-        if(pageNames.contains(gCurrentOpenPage)){
-            verify.remove(gCurrentOpenPage);
-        }
+        pageStatus.set(gCurrentOpenPage, PageStatusIndex::Verified, false);
     }
+    showPageStatusCounts();
 
-    updateTreeviewHighlights(verify);
+    updateTreeviewHighlights();
 }
 
 
-void MainWindow::updateTreeviewHighlights(QMap<QString, int> checkedPages)
+void MainWindow::updateTreeviewHighlights()
 {
     if (customDelegate) {
-        customDelegate->update(checkedPages);
+        customDelegate->update();
     }
 }
 
@@ -16349,6 +16251,7 @@ void MainWindow::on_actionWatermark_triggered()
         QString savePath = saveDir + "watermark_" + QString::number(imageCount + 1) + ".png";
 
         if(image.save(savePath)){
+            mProject.markForCommit(savePath);
             qDebug() << "Succesfully saved the image.";
         }
         else{
@@ -52,12 +52,15 @@
 #include <QMediaRecorder>
 #include <QCalendarWidget>
 #include "customtreeviewitem.h"
+#include "pagestatusindex.h"
+#include "pageimagecache.h"
 #include <QProgressBar>
 
 
 
 using namespace std;
 class AudioLevel;
+class SuggestionService;
 namespace Ui {
 class MainWindow;
 }
@@ -108,6 +111,10 @@ private slots:
 
     void WordCount();
 
+    void requestChangedSuggestions(int position, int charsRemoved, int charsAdded);
+
+    void requestPendingSuggestions();
+
     void DisplayJsonDict(CustomTextBrowser *b, QString input);
 
     void DisplayAllDicts(CustomTextBrowser *b, QString input);
@@ -124,6 +131,8 @@ private slots:
 
     void on_actionSpell_Check_triggered();
 
+    void addSpellCheckPWords(const QStringList &words);
+
     void mousePressEvent(QMouseEvent *ev);
 
     void menuSelection(QAction* action);
@@ -175,6 +184,9 @@ private slots:
     void file_click(const QModelIndex & indx);
 
     void LoadImageFromFile(QFile * file);
+    QSize scanPreviewSize();
+    QString imageFileForPage(const QString &pageName);
+    void prefetchNeighbourImages();
 
     void CustomContextMenuTriggered(const QPoint &p);
 
@@ -284,9 +296,7 @@ private slots:
 
     void RecentPageInfo();
 
-    bool isStringInFile(QString file_path, QString searchString);
 
-    void dumpStringToFile(QString file_path, QString string);
 
     void highlight(CustomTextBrowser *b , QString input);
 
@@ -503,10 +513,8 @@ private slots:
 
     //! Page Status -- Corrected || Verified || Marked For Review
     void on_mark_review_clicked();
-    void write_corrected_pages();
-    void write_verified_pages();
-    void read_corrected_pages();
-    void read_verified_pages();
+    void openPageStatus();
+    void showPageStatusCounts();
     void read_review_pages();
     void write_review_pages();
     void read_recorrected_pages();
@@ -630,7 +638,7 @@ private slots:
 
     void on_verified_stateChanged(int arg1);
 
-    void updateTreeviewHighlights(QMap<QString, int> checkedPages);
+    void updateTreeviewHighlights();
 
     void on_lineEdit_5_returnPressed();
 
@@ -676,6 +684,10 @@ public slots:
     void setTotalWords(int value);
     void showWordCount();
 
+    void addProjectFiles(int scanId, QString filterName, QString dirPath, QStringList files);
+    void projectDirectoryScanned(int scanId, QString filterName);
+    void projectScanFinished(int scanId);
+
     void onClipboardDataChanged();
 
     void fetch(const QString api, const QString token);
@@ -700,9 +712,15 @@ private:
     CustomTextBrowser * curr_browser = nullptr;
     QGraphicsScene * graphic =nullptr;
     Graphics_view_zoom * z = nullptr;
+    PageImageCache * pageImages = nullptr;
+    QString scanImagePath;                  // scan shown in the image pane
     QModelIndex curr_idx;
     QSet<QString> corrector_set;
     QSet<QString> verifier_set;
+    int projectScanId = 0;                  // the project open the scan batches belong to
+    QMap<QString, int> fileCountInDir;      // files put in the tree for every filter
+    QSet<QString> scannedDirectories;
+    bool openRecentPageAfterScan = false;
     QFileSystemWatcher watcher;
     QGraphicsRectItem* item1;
     QGraphicsRectItem* crop_rect;
@@ -728,6 +746,14 @@ private:
 	int currentZoomLevel = 100;
 
 	HandleBbox *handleBbox = nullptr;
+
+	SuggestionService *suggestionService = nullptr;
+	//! edits are asked for once typing pauses, so the prefixes of a word being typed are not ranked
+	QTimer suggestionTimer;
+	QPointer<QTextDocument> changedDocument;
+	int changedFrom = -1, changedTo = -1;     // range of changedDocument edited since the last request
+	void requestSuggestions(const QString &text);
+	void resetSuggestions();
 	QVector<QPair<QString,QString> > bboxes;
 	int blockCount = -1;
     GlobalReplaceDialog *currentGlobalReplaceDialog = nullptr;
@@ -749,12 +775,9 @@ private:
     QVector <QString> changedWords;
     QByteArray m_data;
     std::string m_user, m_pass;
-    //Storing the status of the pages :-> Corrected || Verified
-    QMap<QString,int>correct;
-    QMap<QString,int>verify;
-    QMap<QString,int>recorrect;
+    //Storing the status of the pages :-> Corrected || Verified || Marked For Review || Recorrected
+    PageStatusIndex pageStatus;
     QString currentFile = "";
-    QMap<QString,int>markForReview;
 
     int presentWidth;
     int currentTablePosition;
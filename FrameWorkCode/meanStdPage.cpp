@@ -24,7 +24,7 @@ using namespace std;
  * \param PWords
  * \return 0,1
  */
-bool meanStdPage :: findMeanStd(double& mean, double& std,double& error, QString localmFilename1,QString localmFilename2, map<string, int>& GBook,map<string,int>&  PWords)
+bool meanStdPage :: findMeanStd(double& mean, double& std,double& error, QString localmFilename1,QString localmFilename2, const Lexicon& GBook,const Lexicon&  PWords)
 {
     std::ifstream ssCPage(localmFilename1.toUtf8().constData());
     string localstr;
@@ -68,7 +68,7 @@ bool meanStdPage :: findMeanStd(double& mean, double& std,double& error, QString
         while(ssIPage >> localstr)
         {
             localstr = slnp.toslp1(localstr);
-            if((GBook[(localstr)] > 0) || (PWords[localstr] > 0))
+            if((GBook.count(localstr) > 0) || (PWords.count(localstr) > 0))
             {
                 for(int t1 = std::max(i-win,0); t1 < min(i+win,vsz); t1++)
                 {
@@ -8,7 +8,7 @@ using namespace std;
 
 class meanStdPage {
 public:
-    bool findMeanStd(double& mean, double& std,double& error, QString localmFilename1,QString localmFilename2, map<string, int>& GBook,map<string,int>&  PWords);
+    bool findMeanStd(double& mean, double& std,double& error, QString localmFilename1,QString localmFilename2, const Lexicon& GBook,const Lexicon&  PWords);
 
 };
 
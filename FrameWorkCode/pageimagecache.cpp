@@ -0,0 +1,275 @@
+/*!
+ * \class PageImageCache
+ * \brief Decodes page scans at the resolution they are shown at, in the background where it can
+ */
+#include "pageimagecache.h"
+#include <QImageReader>
+#include <QRunnable>
+#include <QDebug>
+
+/*!
+ * \class PreviewDecodeTask
+ * \brief Runs decodePreview() for a page prefetched on the preview thread pool
+ */
+class PreviewDecodeTask : public QRunnable
+{
+public:
+    PreviewDecodeTask(PageImageCache *cache, const QString &path, const QSize &size)
+        : cache(cache), path(path), size(size) {}
+
+    void run() override
+    {
+        cache->decodePreview(path, size);
+    }
+
+private:
+    PageImageCache *cache;
+    QString path;
+    QSize size;
+};
+
+/*!
+ * \class TileDecodeTask
+ * \brief Runs decodeTile() for one tile on the tile thread pool
+ */
+class TileDecodeTask : public QRunnable
+{
+public:
+    TileDecodeTask(PageImageCache *cache, const QString &path, int level, const QPoint &tile)
+        : cache(cache), path(path), level(level), tile(tile) {}
+
+    void run() override
+    {
+        cache->decodeTile(path, level, tile);
+    }
+
+private:
+    PageImageCache *cache;
+    QString path;
+    int level;
+    QPoint tile;
+};
+
+/*!
+ * \fn PageImageCache::PageImageCache
+ * \param parent
+ */
+PageImageCache::PageImageCache(QObject *parent)
+    : QObject(parent)
+{
+    previews.setMaxCost(64 * 1024);     // a few pages at the size of the view
+    tiles.setMaxCost(96 * 1024);
+    previewPool.setMaxThreadCount(2);
+}
+
+/*!
+ * \fn PageImageCache::~PageImageCache
+ * \brief Drops the queued decodes and waits for the running ones
+ */
+PageImageCache::~PageImageCache()
+{
+    previewPool.clear();
+    tilePool.clear();
+    previewPool.waitForDone();
+    tilePool.waitForDone();
+}
+
+/*!
+ * \fn PageImageCache::imageSize
+ * \brief Full size of a scan, read from its header
+ * \param path
+ * \return QSize, invalid if the file can not be read
+ */
+QSize PageImageCache::imageSize(const QString &path)
+{
+    return QImageReader(path).size();
+}
+
+/*!
+ * \fn PageImageCache::preview
+ * \brief Returns the scan scaled to fit in size, from the cache if a large enough preview of it was decoded
+ * \details If the page is being prefetched its decode is waited for instead of decoding the page twice.
+ * \param path
+ * \param size
+ * \return QImage
+ */
+QImage PageImageCache::preview(const QString &path, const QSize &size)
+{
+    QSize want = previewSize(path, size);
+
+    QMutexLocker locker(&mutex);
+    while (pendingPreviews.contains(path))
+        previewDecoded.wait(&mutex);
+    QImage *cached = previews.object(path);
+    if (cached && cached->width() >= want.width())
+        return *cached;
+    locker.unlock();
+
+    return decodePreview(path, want);
+}
+
+/*!
+ * \fn PageImageCache::prefetch
+ * \brief Decodes the preview of a page in the background, if it is not in the cache already
+ * \param path
+ * \param size
+ */
+void PageImageCache::prefetch(const QString &path, const QSize &size)
+{
+    QSize want = previewSize(path, size);
+    if (!want.isValid())
+        return;
+
+    QMutexLocker locker(&mutex);
+    QImage *cached = previews.object(path);
+    if (pendingPreviews.contains(path) || (cached && cached->width() >= want.width()))
+        return;
+    pendingPreviews.insert(path);
+    previewPool.start(new PreviewDecodeTask(this, path, want));
+}
+
+/*!
+ * \fn PageImageCache::decodePreview
+ * \brief Decodes the scan at size and puts it in the cache
+ * \param path
+ * \param size
+ * \return QImage
+ */
+QImage PageImageCache::decodePreview(const QString &path, const QSize &size)
+{
+    QImageReader reader(path);
+    if (size.isValid() && size != reader.size())
+        reader.setScaledSize(size);
+    QImage image = reader.read();
+    if (image.isNull())
+        qDebug() << "Cannot read image" << path << reader.errorString();
+
+    QMutexLocker locker(&mutex);
+    if (!image.isNull())
+        previews.insert(path, new QImage(image), cost(image));
+    pendingPreviews.remove(path);
+    previewDecoded.wakeAll();
+    return image;
+}
+
+/*!
+ * \fn PageImageCache::tile
+ * \param path
+ * \param level
+ * \param tile
+ * \return the tile if it was decoded, a null image otherwise
+ */
+QImage PageImageCache::tile(const QString &path, int level, const QPoint &tile)
+{
+    QMutexLocker locker(&mutex);
+    QImage *cached = tiles.object(tileKey(path, level, tile));
+    return cached ? *cached : QImage();
+}
+
+/*!
+ * \fn PageImageCache::requestTile
+ * \brief Queues the decode of a tile that is neither cached nor queued already
+ * \param path
+ * \param level
+ * \param tile
+ */
+void PageImageCache::requestTile(const QString &path, int level, const QPoint &tile)
+{
+    QString key = tileKey(path, level, tile);
+    QMutexLocker locker(&mutex);
+    if (tiles.contains(key) || pendingTiles.contains(key))
+        return;
+    pendingTiles.insert(key);
+    tilePool.start(new TileDecodeTask(this, path, level, tile));
+}
+
+/*!
+ * \fn PageImageCache::cancelTiles
+ * \brief Drops the tiles that are still queued, e.g. those of the page that was just left
+ */
+void PageImageCache::cancelTiles()
+{
+    tilePool.clear();
+    QMutexLocker locker(&mutex);
+    pendingTiles.clear();
+}
+
+/*!
+ * \fn PageImageCache::decodeTile
+ * \brief Reads the part of the scan under a tile at 1/2^level of its size and emits tileReady()
+ * \param path
+ * \param level
+ * \param tile
+ */
+void PageImageCache::decodeTile(const QString &path, int level, const QPoint &tile)
+{
+    QImageReader reader(path);
+    int span = TILE_SIZE << level;
+    QRect clip = QRect(tile.x() * span, tile.y() * span, span, span) & QRect(QPoint(0, 0), reader.size());
+    if (clip.isEmpty())
+        return;
+    reader.setClipRect(clip);
+    if (level > 0)
+        reader.setScaledSize(QSize(((clip.width() - 1) >> level) + 1, ((clip.height() - 1) >> level) + 1));
+    QImage image = reader.read();
+
+    QString key = tileKey(path, level, tile);
+    {
+        QMutexLocker locker(&mutex);
+        if (!pendingTiles.contains(key))
+            return;     // cancelled while it was decoded
+        if (image.isNull()) {
+            //! left pending so that it is not requested again for every paint
+            qDebug() << "Cannot read tile of" << path << reader.errorString();
+            return;
+        }
+        pendingTiles.remove(key);
+        tiles.insert(key, new QImage(image), cost(image));
+    }
+    emit tileReady(path, level, tile);
+}
+
+/*!
+ * \fn PageImageCache::region
+ * \brief Reads a part of the scan at full resolution, e.g. a region marked for a figure or for OCR
+ * \details As with QPixmap::copy(), an empty rect gives the whole scan.
+ * \param path
+ * \param rect
+ * \return QImage
+ */
+QImage PageImageCache::region(const QString &path, const QRect &rect) const
+{
+    QImageReader reader(path);
+    QRect full(QPoint(0, 0), reader.size());
+    QRect clip = rect.isEmpty() ? full : full & rect;
+    if (clip.isEmpty())
+        return QImage();
+    if (clip != full)
+        reader.setClipRect(clip);
+    return reader.read();
+}
+
+/*!
+ * \fn PageImageCache::previewSize
+ * \brief Size of the scan scaled down to fit in size; the full size if it fits already
+ * \param path
+ * \param size
+ * \return QSize
+ */
+QSize PageImageCache::previewSize(const QString &path, const QSize &size)
+{
+    QSize full = imageSize(path);
+    if (!full.isValid() || !size.isValid() || (full.width() <= size.width() && full.height() <= size.height()))
+        return full;
+    return full.scaled(size, Qt::KeepAspectRatio);
+}
+
+QString PageImageCache::tileKey(const QString &path, int level, const QPoint &tile)
+{
+    return QString("%1|%2|%3|%4").arg(path).arg(level).arg(tile.x()).arg(tile.y());
+}
+
+int PageImageCache::cost(const QImage &image)
+{
+    return qMax(1, image.bytesPerLine() * image.height() / 1024);
+}
@@ -0,0 +1,63 @@
+#ifndef PAGEIMAGECACHE_H
+#define PAGEIMAGECACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+/*
+ * Decodes the page scans for the image pane at the resolution they are shown at.
+ * A page is first shown from a preview, decoded with QImageReader::setScaledSize
+ * to about the size of the view (JPEG scans are scaled while they are decoded, so
+ * the full scan is never in memory). When the view is zoomed in further, the scan
+ * is read in tiles of TILE_SIZE pixels at level k, i.e. at 1/2^k of its full size,
+ * on a thread pool, and tileReady() is emitted for every tile decoded.
+ * The previews of the next and previous pages are decoded in the background with
+ * prefetch(), so that turning a page does not wait for the decoder.
+ */
+class PageImageCache : public QObject
+{
+    Q_OBJECT
+public:
+    static const int TILE_SIZE = 512;
+
+    explicit PageImageCache(QObject *parent = nullptr);
+    ~PageImageCache();
+
+    static QSize imageSize(const QString &path);
+
+    QImage preview(const QString &path, const QSize &size);
+    void prefetch(const QString &path, const QSize &size);
+
+    QImage tile(const QString &path, int level, const QPoint &tile);
+    void requestTile(const QString &path, int level, const QPoint &tile);
+    void cancelTiles();
+
+    QImage region(const QString &path, const QRect &rect) const;
+
+    QImage decodePreview(const QString &path, const QSize &size);
+    void decodeTile(const QString &path, int level, const QPoint &tile);
+
+signals:
+    void tileReady(const QString &path, int level, const QPoint &tile);
+
+private:
+    static QSize previewSize(const QString &path, const QSize &size);
+    static QString tileKey(const QString &path, int level, const QPoint &tile);
+    static int cost(const QImage &image);
+
+    QMutex mutex;
+    QWaitCondition previewDecoded;
+    QCache<QString, QImage> previews;       // by path, cost in KB
+    QCache<QString, QImage> tiles;          // by tileKey(), cost in KB
+    QSet<QString> pendingPreviews;          // being decoded by prefetch()
+    QSet<QString> pendingTiles;
+    QThreadPool previewPool;
+    QThreadPool tilePool;
+};
+
+#endif // PAGEIMAGECACHE_H
@@ -0,0 +1,182 @@
+#include "pagestatusindex.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+
+/*!
+ * \fn PageStatusIndex::open
+ * \brief Reads the status of the pages from the index file, which stays open for the updates
+ * \details A file that is missing or has an unknown header is started again empty. A last record that was
+ * cut short is removed from the file.
+ * \param filePath
+ * \return true if an index was read from the file
+ */
+bool PageStatusIndex::open(const QString &filePath)
+{
+    close();
+    file.setFileName(filePath);
+    QDir().mkpath(QFileInfo(filePath).path());
+    if (!file.open(QIODevice::ReadWrite)) {
+        qDebug() << "Cannot open page status index" << filePath;
+        return false;
+    }
+
+    QByteArray data = file.readAll();
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    if (data.size() < HEADER_SIZE || qFromBigEndian<quint32>(p) != MAGIC || qFromBigEndian<quint32>(p + 4) != VERSION) {
+        if (!data.isEmpty())
+            qDebug() << "Page status index" << filePath << "is not readable, starting a new one";
+        uchar header[HEADER_SIZE];
+        qToBigEndian<quint32>(MAGIC, header);
+        qToBigEndian<quint32>(VERSION, header + 4);
+        file.resize(0);
+        file.seek(0);
+        file.write(reinterpret_cast<const char *>(header), HEADER_SIZE);
+        file.flush();
+        return false;
+    }
+
+    int pos = HEADER_SIZE;
+    while (pos + 3 <= data.size()) {
+        int length = qFromBigEndian<quint16>(p + pos + 1);
+        if (pos + 3 + length > data.size())
+            break;
+        QString name = QString::fromUtf8(data.constData() + pos + 3, length);
+        quint8 pageFlags = p[pos];
+        pageSlots.insert(name, names.size());
+        names.append(name);
+        flags.append(pageFlags);
+        offsets.append(pos);
+        for (int i = 0; i < 4; i++)
+            if (pageFlags & (1 << i))
+                counts[i]++;
+        pos += 3 + length;
+    }
+    if (pos != data.size()) {
+        qDebug() << "Dropping the last record of" << filePath;
+        file.resize(pos);
+    }
+    return true;
+}
+
+/*!
+ * \fn PageStatusIndex::close
+ * \brief Closes the file and forgets the pages
+ */
+void PageStatusIndex::close()
+{
+    file.close();
+    pageSlots.clear();
+    names.clear();
+    flags.clear();
+    offsets.clear();
+    for (int &count : counts)
+        count = 0;
+}
+
+/*!
+ * \fn PageStatusIndex::has
+ * \param page
+ * \param status
+ * \return true if page has status
+ */
+bool PageStatusIndex::has(const QString &page, Status status) const
+{
+    int slot = pageSlots.value(page, -1);
+    return slot != -1 && (flags[slot] & status);
+}
+
+/*!
+ * \fn PageStatusIndex::set
+ * \brief Sets or clears a status of a page. Only the record of the page is written.
+ * \param page
+ * \param status
+ * \param on
+ */
+void PageStatusIndex::set(const QString &page, Status status, bool on)
+{
+    int slot = pageSlots.value(page, -1);
+    if (slot == -1) {
+        if (!on)
+            return;
+        QByteArray name = page.toUtf8();
+        if (name.size() > 0xFFFF)
+            return;
+        slot = names.size();
+        pageSlots.insert(page, slot);
+        names.append(page);
+        flags.append(status);
+        counts[bit(status)]++;
+
+        if (!file.isOpen())
+            return;
+        qint64 end = file.size();
+        offsets.append(end);
+        QByteArray record(3, 0);
+        record[0] = char(status);
+        qToBigEndian<quint16>(quint16(name.size()), reinterpret_cast<uchar *>(record.data() + 1));
+        record.append(name);
+        file.seek(end);
+        file.write(record);
+        file.flush();
+        return;
+    }
+
+    quint8 pageFlags = on ? (flags[slot] | status) : (flags[slot] & ~status);
+    if (pageFlags == flags[slot])
+        return;
+    counts[bit(status)] += on ? 1 : -1;
+    flags[slot] = pageFlags;
+    writeFlags(slot);
+}
+
+/*!
+ * \fn PageStatusIndex::clear
+ * \brief Clears status from every page
+ * \param status
+ */
+void PageStatusIndex::clear(Status status)
+{
+    for (int slot = 0; slot < flags.size(); slot++) {
+        if (flags[slot] & status) {
+            flags[slot] &= ~status;
+            writeFlags(slot);
+        }
+    }
+    counts[bit(status)] = 0;
+}
+
+/*!
+ * \fn PageStatusIndex::pages
+ * \param status
+ * \return names of the pages that have status
+ */
+QStringList PageStatusIndex::pages(Status status) const
+{
+    QStringList list;
+    for (int slot = 0; slot < flags.size(); slot++)
+        if (flags[slot] & status)
+            list << names[slot];
+    return list;
+}
+
+int PageStatusIndex::bit(Status status)
+{
+    switch (status) {
+    case Corrected: return 0;
+    case Verified: return 1;
+    case MarkedForReview: return 2;
+    case Recorrected: return 3;
+    }
+    return 0;
+}
+
+void PageStatusIndex::writeFlags(int slot)
+{
+    if (!file.isOpen() || slot >= offsets.size())
+        return;
+    file.seek(offsets[slot]);
+    file.putChar(char(flags[slot]));
+    file.flush();
+}
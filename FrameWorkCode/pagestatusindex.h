@@ -0,0 +1,59 @@
+#ifndef PAGESTATUSINDEX_H
+#define PAGESTATUSINDEX_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*
+ * Status of the pages of a set (corrected, verified, marked for review,
+ * recorrected), kept in a small file of the set so that a change of status
+ * rewrites one byte of it instead of the whole list.
+ * The file starts with a header and then has one record per page:
+ *   quint8 flags, quint16 length of the name, name in UTF-8.
+ * A page seen for the first time is appended, a change of status rewrites the
+ * flags byte of its record in place. A record cut short by a crash is dropped
+ * when the file is opened.
+ */
+class PageStatusIndex
+{
+public:
+    enum Status : quint8 {
+        Corrected = 1,
+        Verified = 2,
+        MarkedForReview = 4,
+        Recorrected = 8
+    };
+
+    //! Reads the index of the set, false if it does not exist yet (an empty one is created)
+    bool open(const QString &filePath);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    bool has(const QString &page, Status status) const;
+    void set(const QString &page, Status status, bool on = true);
+    //! Clears status from every page, e.g. markings that only last for a session
+    void clear(Status status);
+
+    int count(Status status) const { return counts[bit(status)]; }
+    QStringList pages(Status status) const;
+
+private:
+    static const quint32 MAGIC = 0x50534958;    // "PSIX"
+    static const quint32 VERSION = 1;
+    static const int HEADER_SIZE = 8;
+
+    static int bit(Status status);
+    void writeFlags(int slot);
+
+    QFile file;
+    QHash<QString, int> pageSlots;
+    QVector<QString> names;
+    QVector<quint8> flags;
+    QVector<qint64> offsets;     // of the flags byte of every record
+    int counts[4] = { 0, 0, 0, 0 };
+};
+
+#endif // PAGESTATUSINDEX_H
@@ -1,18 +1,61 @@
 #include "printworker.h"
+#include "htmltotext.h"
 
 #include <QTextDocument>
+#include <QTextFrame>
+#include <QAbstractTextDocumentLayout>
+#include <QPainter>
 #include <QPrinter>
+#include <QFile>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QScopedArrayPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QVector>
+#include <QDebug>
+#include <string>
+
+/*!
+ * \class PrintPageTask
+ * \brief Runs preparePage() for one page on the print thread pool
+ */
+class PrintPageTask : public QRunnable
+{
+public:
+    PrintPageTask(PrintWorker *worker, PrintWorker::PageJob *job, QAtomicInt *done)
+        : worker(worker), job(job), done(done) {}
+
+    void run() override
+    {
+        worker->preparePage(job);
+        worker->markDone(done);
+    }
+
+private:
+    PrintWorker *worker;
+    PrintWorker::PageJob *job;
+    QAtomicInt *done;
+};
 
 /*!
  * \fn PrintWorker::PrintWorker
- * \brief This is the constructor which sets a data member to the HTML text passed to it
+ * \brief This is the constructor which takes the pages to print
  * \param parent
- * \param str
+ * \param pageFiles html files of the set, in print order, starting with the first page to print
+ * \param pageCount number of pages to print
+ * \param skipBlankPages pages without text are left out
  */
-PrintWorker::PrintWorker(QObject *parent, const QString &str)
-    : QObject{parent}
+PrintWorker::PrintWorker(QObject *parent, const QStringList &pageFiles, int pageCount, bool skipBlankPages)
+    : QObject{parent}, pageFiles(pageFiles), pageCount(pageCount), skipBlankPages(skipBlankPages)
 {
-    this->fullHtml = QString(str);
+    //! the 2 cm margins of QTextDocument::print() are given in the dpi of the screen, read here in the GUI thread
+    QScreen *screen = QGuiApplication::primaryScreen();
+    sourceDpiX = screen ? qRound(screen->logicalDotsPerInchX()) : 100;
+    sourceDpiY = screen ? qRound(screen->logicalDotsPerInchY()) : 100;
 }
 
 /*!
@@ -21,17 +64,186 @@ PrintWorker::PrintWorker(QObject *parent, const QString &str)
  */
 PrintWorker::~PrintWorker()
 {
-    delete doc;
+}
+
+/*!
+ * \fn PrintWorker::preparePage
+ * \brief Reads a page and prepares its html for printing
+ * \details The background colours are turned off and the Latex of the equations is replaced by their png images,
+ * as our tool saves Latex for mathematical equations in html but can't render it.
+ * \param job
+ */
+void PrintWorker::preparePage(PageJob *job)
+{
+    QFile file(job->filePath);
+    if (!file.open(QIODevice::ReadOnly)) qDebug() << "Error reading file" << job->filePath;
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+    QString mainHtml = stream.readAll();
+    file.close();
+    mainHtml.replace("background-color:","Background-colour:");
+
+    job->blank = skipBlankPages && HtmlToText::toPlainText(mainHtml).isEmpty();
+    if (job->blank)
+        return;
+
+    if(mainHtml.contains("$$")){
+
+        QRegularExpression rex_lat("<a(.*?)</a>",QRegularExpression::DotMatchesEverythingOption);
+        QRegularExpressionMatchIterator itr_lat;
+        itr_lat = rex_lat.globalMatch(mainHtml);
+        while(itr_lat.hasNext()){
+
+            QRegularExpressionMatch match = itr_lat.next();
+            QString text = match.captured(1);
+
+            if(text.contains("Equations_"))
+            {
+                std::string inputText_ = text.toStdString();
+                int ind = inputText_.find("/");
+                int lindex = inputText_.find(".tex");
+
+                std::string str = inputText_.substr(ind,lindex-ind);
+                QString path = QString::fromStdString(str) + ".png";
+                QString html = "<img src=\""+path+"\">";
+                text = "<a"+text+"</a>";
+                mainHtml.replace(text,html);
+            }
+
+        }
+        mainHtml = mainHtml.replace("$$","dne_nqe"); //where dne_nqe is a random string used as end delimiter here.
+        //Note that this string should not appear as an original text - else it will cause parsing issues.
+        QRegularExpression rex_dollar("dne_nqe(.*?)dne_nqe",QRegularExpression::DotMatchesEverythingOption);
+        mainHtml = mainHtml.remove(rex_dollar);
+    }
+    job->html = mainHtml;
+}
+
+/*!
+ * \fn PrintWorker::markDone
+ * \brief Marks a prepared page and wakes printPDF() if it waits for it
+ * \param done
+ */
+void PrintWorker::markDone(QAtomicInt *done)
+{
+    QMutexLocker locker(&mutex);
+    done->storeRelease(1);
+    pageReady.wakeAll();
 }
 
 /*!
  * \fn PrintWorker::printPDF
  * \brief It prints the PDF in a file
+ * \details The pages are prepared on a thread pool at most a few pages ahead of the one being painted, and each page
+ * is laid out on its own and dropped once painted. The progress is reported after every page.
  */
 void PrintWorker::printPDF()
 {
-    doc = new QTextDocument(this);
-    doc->setHtml(fullHtml);
-    doc->print(printer);
+    int total = pageFiles.size();
+    QVector<PageJob> jobs(total);
+    for (int i = 0; i < total; i++) {
+        jobs[i].filePath = pageFiles[i];
+        jobs[i].blank = false;
+    }
+    QScopedArrayPointer<QAtomicInt> done(new QAtomicInt[total > 0 ? total : 1]);
+
+    QPainter painter(printer);
+    if (!painter.isActive()) {
+        qDebug() << "Cannot print to" << printer->outputFileName();
+        emit finishedPrintingPDF();
+        return;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    int window = 2 * pool.maxThreadCount();     // pages prepared ahead of the one being painted
+    int started = 0;
+
+    int printed = 0;
+    int sheet = 0;
+    int perc = 0; // percentage to be shown on progress bar
+    for (int i = 0; i < total && printed < pageCount; i++) {
+        for (; started < total && started <= i + window; started++)
+            pool.start(new PrintPageTask(this, &jobs[started], &done[started]));
+
+        mutex.lock();
+        while (!done[i].loadAcquire())
+            pageReady.wait(&mutex);
+        mutex.unlock();
+
+        if (!jobs[i].blank) {
+            printPage(&painter, jobs[i].html, &sheet);
+            printed++;
+        }
+        jobs[i].html.clear();
+
+        int tempPerc = (printed * 100) / pageCount;
+        if (tempPerc > perc) {
+            perc = tempPerc;
+            emit changeProgressBarValue(perc);
+        }
+    }
+    pool.waitForDone();
+    painter.end();
     emit finishedPrintingPDF();
 }
+
+/*!
+ * \fn PrintWorker::printPage
+ * \brief Lays out one page of the set and paints it on as many sheets as it takes
+ * \details The layout is the one QTextDocument::print() uses for a document without a page size: the printable
+ * area of the printer, 2 cm margins and the sheet number at the bottom right.
+ * \param painter
+ * \param html
+ * \param sheet number of the last sheet printed, updated
+ */
+void PrintWorker::printPage(QPainter *painter, const QString &html, int *sheet)
+{
+    QTextDocument doc;
+    doc.documentLayout()->setPaintDevice(printer);
+    doc.setHtml(html);
+
+    const int horizontalMargin = int((2/2.54)*sourceDpiX);
+    const int verticalMargin = int((2/2.54)*sourceDpiY);
+    QTextFrameFormat fmt = doc.rootFrame()->frameFormat();
+    fmt.setLeftMargin(horizontalMargin);
+    fmt.setRightMargin(horizontalMargin);
+    fmt.setTopMargin(verticalMargin);
+    fmt.setBottomMargin(verticalMargin);
+    doc.rootFrame()->setFrameFormat(fmt);
+
+    QRectF body = QRectF(0, 0, printer->width(), printer->height());
+    doc.setPageSize(body.size());
+    const qreal dpiScaleX = qreal(printer->logicalDpiX()) / sourceDpiX;
+    const qreal dpiScaleY = qreal(printer->logicalDpiY()) / sourceDpiY;
+    QPointF pageNumberPos(body.width() - horizontalMargin * dpiScaleX,
+                          body.height() - verticalMargin * dpiScaleY
+                          + QFontMetrics(doc.defaultFont(), printer).ascent()
+                          + 5 * printer->logicalDpiY() / 72.0);
+
+    for (int page = 0; page < doc.pageCount(); page++) {
+        ++*sheet;
+        //! a range chosen in the print dialog
+        if (printer->fromPage() > 0 && (*sheet < printer->fromPage() || *sheet > printer->toPage()))
+            continue;
+        if (sheetPainted)
+            printer->newPage();
+        sheetPainted = true;
+
+        painter->save();
+        painter->translate(body.left(), body.top() - page * body.height());
+        QRectF view(0, page * body.height(), body.width(), body.height());
+        QAbstractTextDocumentLayout::PaintContext ctx;
+        painter->setClipRect(view);
+        ctx.clip = view;
+        ctx.palette.setColor(QPalette::Text, Qt::black);
+        doc.documentLayout()->draw(painter, ctx);
+
+        painter->setClipping(false);
+        painter->setFont(doc.defaultFont());
+        const QString pageString = QString::number(*sheet);
+        painter->drawText(qRound(pageNumberPos.x() - painter->fontMetrics().horizontalAdvance(pageString)),
+                          qRound(pageNumberPos.y() + view.top()), pageString);
+        painter->restore();
+    }
+}
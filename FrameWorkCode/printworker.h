@@ -2,27 +2,57 @@
 #define PRINTWORKER_H
 
 #include <QObject>
+#include <QStringList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
 
-class QTextDocument;
+class QPainter;
 class QPrinter;
 
+/*
+ * Prints the pages of a set into one PDF, page after page.
+ * The html of the next few pages is read and prepared (equations, background
+ * colours, blank pages) on a thread pool while the current page is laid out in
+ * its own QTextDocument and painted, so only a handful of pages are in memory
+ * however long the set is. Every page of the set starts on a new sheet and the
+ * sheets are numbered at the bottom, as QTextDocument::print() numbers them.
+ */
 class PrintWorker : public QObject
 {
 	Q_OBJECT
 public:
-	explicit PrintWorker(QObject *parent = nullptr, const QString &str = "");
+	struct PageJob {
+		QString filePath;
+		QString html;       // prepared for printing, cleared once the page is painted
+		bool blank;         // skipped, it has no text
+	};
+
+	explicit PrintWorker(QObject *parent = nullptr, const QStringList &pageFiles = {}, int pageCount = 0, bool skipBlankPages = false);
 	~PrintWorker();
 	QPrinter *printer = nullptr;
 
+	void preparePage(PageJob *job);
+	void markDone(QAtomicInt *done);
+
 private:
 	// data members
-	QString fullHtml = "";
-	QTextDocument *doc = nullptr;
+	QStringList pageFiles;
+	int pageCount;          // pages to print, blank pages that are skipped do not count
+	bool skipBlankPages;
+	qreal sourceDpiX;       // dpi QTextDocument lays out in
+	qreal sourceDpiY;
+	bool sheetPainted = false;
+	QMutex mutex;
+	QWaitCondition pageReady;
+
+	void printPage(QPainter *painter, const QString &html, int *sheet);
 
 public slots:
 	void printPDF();
 
 signals:
+	void changeProgressBarValue(int value);
 	void finishedPrintingPDF();
 };
 
@@ -0,0 +1,71 @@
+/*!
+ * \class ProjectScanWorker
+ * \brief Lists the CorrectorOutput, VerifierOutput, Inds and Images folders of a project in parallel, outside of the GUI thread
+ */
+#include "projectscanworker.h"
+#include <QDir>
+#include <QThreadPool>
+#include <QRunnable>
+
+//! Files sent to the GUI thread at a time, each batch is one insert into the tree model
+static const int scanBatchSize = 256;
+
+/*!
+ * \class ProjectScanTask
+ * \brief Runs scanDirectory() for one folder on the project scan thread pool
+ */
+class ProjectScanTask : public QRunnable
+{
+public:
+    ProjectScanTask(ProjectScanWorker *worker, const QString &filterName, const QString &dirPath)
+        : worker(worker), filterName(filterName), dirPath(dirPath) {}
+
+    void run() override
+    {
+        worker->scanDirectory(filterName, dirPath);
+    }
+
+private:
+    ProjectScanWorker *worker;
+    QString filterName;
+    QString dirPath;
+};
+
+/*!
+ * \fn ProjectScanWorker::ProjectScanWorker
+ * \param parent
+ * \param scanId number of the project open the files belong to
+ * \param directories folder of every filter of the tree
+ */
+ProjectScanWorker::ProjectScanWorker(QObject *parent, int scanId, QMap<QString, QString> directories)
+    : QObject(parent), scanId(scanId), directories(directories)
+{
+}
+
+/*!
+ * \fn ProjectScanWorker::scanDirectory
+ * \brief Emits the files of \a dirPath in name order, scanBatchSize at a time, then directoryScanned()
+ * \param filterName
+ * \param dirPath
+ */
+void ProjectScanWorker::scanDirectory(const QString &filterName, const QString &dirPath)
+{
+    QStringList list = QDir(dirPath).entryList(QDir::Filter::Files);
+    for (int i = 0; i < list.size(); i += scanBatchSize)
+        emit filesFound(scanId, filterName, dirPath, list.mid(i, scanBatchSize));
+    emit directoryScanned(scanId, filterName);
+}
+
+/*!
+ * \fn ProjectScanWorker::scanProject
+ * \brief Scans all the folders at once and emits finishedScanning() when they are all listed
+ */
+void ProjectScanWorker::scanProject()
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(directories.size());
+    for (auto it = directories.constBegin(); it != directories.constEnd(); ++it)
+        pool.start(new ProjectScanTask(this, it.key(), it.value()));
+    pool.waitForDone();
+    emit finishedScanning(scanId);
+}
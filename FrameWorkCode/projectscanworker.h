@@ -0,0 +1,34 @@
+#ifndef PROJECTSCANWORKER_H
+#define PROJECTSCANWORKER_H
+
+#include <QObject>
+#include <QMap>
+#include <QStringList>
+
+/*
+ * Lists the folders of a project that is being opened, each one on a thread
+ * of its own, and hands the file names to the GUI thread in batches so the
+ * project tree fills in while the rest of the project opens.
+ */
+class ProjectScanWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ProjectScanWorker(QObject *parent = nullptr, int scanId = 0, QMap<QString, QString> directories = {});
+
+    void scanDirectory(const QString &filterName, const QString &dirPath);
+
+public slots:
+    void scanProject();
+
+signals:
+    void filesFound(int scanId, QString filterName, QString dirPath, QStringList files);
+    void directoryScanned(int scanId, QString filterName);
+    void finishedScanning(int scanId);
+
+private:
+    int scanId;
+    QMap<QString, QString> directories;     // filter name -> folder
+};
+
+#endif // PROJECTSCANWORKER_H
@@ -4,35 +4,48 @@
 
 HEADERS += ./Filters.h \
     $$PWD/about.h \
+    $$PWD/accuracylogworker.h \
     $$PWD/add_comment.h \
     $$PWD/aesni-enc-cbc.h \
     $$PWD/aesni-enc-ecb.h \
     $$PWD/aesni-key-exp.h \
     $$PWD/aesni-key-init.h \
     $$PWD/column_width.h \
+    $$PWD/correctionpairs.h \
     $$PWD/crashlog.h \
     $$PWD/customtextbrowser.h \
     $$PWD/customtreeviewitem.h \
     $$PWD/dashboard.h \
+    $$PWD/dictsnapshot.h \
     $$PWD/editdistance.h \
     $$PWD/equationeditor.h \
     $$PWD/globalreplaceworker.h \
     $$PWD/handlebbox.h \
+    $$PWD/htmltotext.h \
     $$PWD/indentoptions.h \
+    $$PWD/jsonstore.h \
+    $$PWD/lexicon.h \
     $$PWD/loaddataworker.h \
     $$PWD/loadingspinner.h \
     $$PWD/markRegion.h \
+    $$PWD/pageimagecache.h \
+    $$PWD/pagestatusindex.h \
     $$PWD/pdfhandling.h \
     $$PWD/pdfrangedialog.h \
     $$PWD/printworker.h \
     $$PWD/progressbardialog.h \
+    $$PWD/projectscanworker.h \
     $$PWD/qaesencryption.h \
     $$PWD/qcustomplot.h \
     $$PWD/releasenote_msg.h \
     $$PWD/rubberband.h \
+    $$PWD/samassegmenter.h \
+    $$PWD/scanimageitem.h \
     $$PWD/sendmail.h \
     $$PWD/shortcutguidedialog.h \
     $$PWD/simplecrypt.h \
+    $$PWD/spellcheckhighlighter.h \
+    $$PWD/suggestionservice.h \
     $$PWD/textfinder.h \
     $$PWD/globalreplacedialog.h \
     $$PWD/threadingpush.h \
@@ -40,6 +53,7 @@ HEADERS += ./Filters.h \
     $$PWD/undoglobalreplace.h \
     $$PWD/verifyset.h \
     $$PWD/word_count.h \
+    $$PWD/wordmatcher.h \
     $$PWD/worker.h \
     $$PWD/xlsx_headers.h \
     ./3rdParty/RapidXML/rapidxml.hpp \
@@ -54,6 +68,7 @@ HEADERS += ./Filters.h \
     ./meanStdPage.h \
     ./slpNPatternDict.h \
     ./trieEditdis.h \
+    ./transliterator.h \
     ./DiffView.h \
     ./ProjectHierarchyWindow.h \
     ./Symbols.h \
@@ -71,42 +86,57 @@ HEADERS += ./Filters.h \
     $$PWD/globalreplaceinformation.h
 SOURCES += ./DiffView.cpp \
     $$PWD/about.cpp \
+    $$PWD/accuracylogworker.cpp \
     $$PWD/add_comment.cpp \
     $$PWD/column_width.cpp \
+    $$PWD/correctionpairs.cpp \
     $$PWD/crashlog.cpp \
     $$PWD/customtextbrowser.cpp \
     $$PWD/customtreeviewitem.cpp \
     $$PWD/dashboard.cpp \
+    $$PWD/dictsnapshot.cpp \
     $$PWD/eddis.cpp \
     $$PWD/editdistance.cpp \
     $$PWD/equationeditor.cpp \
     $$PWD/globalreplaceworker.cpp \
     $$PWD/handlebbox.cpp \
+    $$PWD/htmltotext.cpp \
     $$PWD/indentoptions.cpp \
+    $$PWD/jsonstore.cpp \
+    $$PWD/lexicon.cpp \
     $$PWD/loaddataworker.cpp \
     $$PWD/loadingspinner.cpp \
     $$PWD/markRegion.cpp \
     $$PWD/meanStdPage.cpp \
+    $$PWD/pageimagecache.cpp \
+    $$PWD/pagestatusindex.cpp \
     $$PWD/pdfhandling.cpp \
     $$PWD/pdfrangedialog.cpp \
     $$PWD/printworker.cpp \
     $$PWD/progressbardialog.cpp \
+    $$PWD/projectscanworker.cpp \
     $$PWD/qaesencryption.cpp \
     $$PWD/qcustomplot.cpp \
     $$PWD/releasenote_msg.cpp \
     $$PWD/rubberband.cpp \
+    $$PWD/samassegmenter.cpp \
+    $$PWD/scanimageitem.cpp \
     $$PWD/sendmail.cpp \
     $$PWD/shortcutguidedialog.cpp \
     $$PWD/simplecrypt.cpp \
     $$PWD/slpNPatternDict.cpp \
+    $$PWD/spellcheckhighlighter.cpp \
+    $$PWD/suggestionservice.cpp \
     $$PWD/textfinder.cpp \
     $$PWD/globalreplacedialog.cpp \
     $$PWD/threadingpush.cpp \
     $$PWD/trieEditdis.cpp \
+    $$PWD/transliterator.cpp \
     $$PWD/tutorial.cpp \
     $$PWD/undoglobalreplace.cpp \
     $$PWD/verifyset.cpp \
     $$PWD/word_count.cpp \
+    $$PWD/wordmatcher.cpp \
     $$PWD/worker.cpp \
     ./Filters.cpp \
     ./Project.cpp \
@@ -0,0 +1,140 @@
+/*!
+ * \class SamasSegmenter
+ * \brief Memoized samAsa splitting over a table of the dictionary words of a word
+ */
+#include "samassegmenter.h"
+
+//! results kept per direction before the cache is dropped
+static const size_t MEMO_LIMIT = 1 << 16;
+
+/*!
+ * \fn SamasSegmenter::SamasSegmenter
+ * \param Dict
+ */
+SamasSegmenter::SamasSegmenter(const Lexicon& Dict) : Dict(Dict), dictStamp(Dict.stamp())
+{
+}
+
+/*!
+ * \fn SamasSegmenter::of
+ * \brief Per thread, since suggestions are ranked on a thread pool; the segmenters live as long as their thread
+ * \param Dict
+ * \return SamasSegmenter&
+ */
+SamasSegmenter& SamasSegmenter::of(const Lexicon& Dict)
+{
+    static thread_local unordered_map<const Lexicon*, unique_ptr<SamasSegmenter> > segmenters;
+    unique_ptr<SamasSegmenter>& segmenter = segmenters[&Dict];
+    if (!segmenter) segmenter.reset(new SamasSegmenter(Dict));
+    else if (segmenter->dictStamp != Dict.stamp()) {
+        segmenter->clear();
+        segmenter->dictStamp = Dict.stamp();
+    }
+    return *segmenter;
+}
+
+/*!
+ * \fn SamasSegmenter::clear
+ * \brief Drops the cached results, needed when Dict changes
+ */
+void SamasSegmenter::clear()
+{
+    memoLR.clear();
+    memoRL.clear();
+    word.clear();
+    lengths.clear();
+}
+
+/*!
+ * \fn SamasSegmenter::index
+ * \brief Finds the dictionary words starting at every position of w
+ * \param w
+ */
+void SamasSegmenter::index(const string& w)
+{
+    if (w == word && lengths.size() == w.size()) return;
+    word = w;
+    lengths.assign(w.size(), vector<size_t>());
+    for (size_t s = 0; s < w.size(); s++) {
+        Dict.prefixCounts(w.data() + s, w.size() - s, counts);
+        for (size_t l = counts.size(); l > 0; l--)
+            if (counts[l - 1] > 0) lengths[s].push_back(l);
+    }
+}
+
+/*!
+ * \fn SamasSegmenter::segment
+ * \brief Splits word[from, to) around its longest dictionary word, leftmost for LR and rightmost for RL
+ * \param from
+ * \param to
+ * \param LR
+ * \return
+ */
+string SamasSegmenter::segment(size_t from, size_t to, bool LR)
+{
+    if (from == to) return "";
+
+    size_t best = 0, bestStart = 0;
+    for (size_t s = from; s < to; s++) {
+        //! the longest word at s that ends inside the span; lengths are sorted longest first
+        for (size_t l : lengths[s]) {
+            if (s + l > to) continue;
+            if (l > best || (l == best && !LR)) { best = l; bestStart = s; }
+            break;
+        }
+    }
+    if (best == 0) return " #" + word.substr(from, to - from) + "# ";
+
+    return segment(from, bestStart, LR) + " " + word.substr(bestStart, best) + " " + segment(bestStart + best, to, LR);
+}
+
+/*!
+ * \fn SamasSegmenter::cached
+ * \param memo
+ * \param w
+ * \param LR
+ * \return
+ */
+string SamasSegmenter::cached(unordered_map<string, string>& memo, const string& w, bool LR)
+{
+    unordered_map<string, string>::const_iterator it = memo.find(w);
+    if (it != memo.end()) return it->second;
+
+    index(w);
+    string out = segment(0, w.size(), LR);
+    if (memo.size() >= MEMO_LIMIT) memo.clear();
+    memo[w] = out;
+    return out;
+}
+
+/*!
+ * \fn SamasSegmenter::segmentLR
+ * \param word
+ * \return
+ */
+string SamasSegmenter::segmentLR(const string& word)
+{
+    return cached(memoLR, word, true);
+}
+
+/*!
+ * \fn SamasSegmenter::segmentRL
+ * \param word
+ * \return
+ */
+string SamasSegmenter::segmentRL(const string& word)
+{
+    return cached(memoRL, word, false);
+}
+
+/*!
+ * \fn SamasSegmenter::parts
+ * \param word
+ * \param FlagLR
+ * \return
+ */
+size_t SamasSegmenter::parts(const string& word, bool& FlagLR)
+{
+    string partsLR, partsRL;
+    return slnp.minsize_t(slnp.cntSamas(segmentLR(word), partsLR), slnp.cntSamas(segmentRL(word), partsRL), FlagLR);
+}
@@ -0,0 +1,63 @@
+#ifndef SAMASSEGMENTER_H
+#define SAMASSEGMENTER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include "lexicon.h"
+#include "slpNPatternDict.h"
+
+using namespace std;
+
+/*
+ * Splits SLP1 words into dictionary words (samAsa parts) the way
+ * slpNPatternDict::SamasLR and SamasRL do: take the longest dictionary word in
+ * the string (the leftmost one for LR, the rightmost one for RL) and split the
+ * parts left and right of it the same way; a part without any dictionary word
+ * is marked as #part#.
+ * All the dictionary words of a word are looked up once, one pass over the
+ * prefixes of each position, and the best split of every span is then taken
+ * from that table instead of looking up every substring again at every level.
+ * Results are kept per word, so asking again for a word, e.g. for the many
+ * confusion variants tried by print2OCRSugg, costs one hash lookup.
+ * of() keeps one segmenter per dictionary and thread for the whole session, and
+ * drops its results when the stamp of the dictionary shows that it changed.
+ */
+class SamasSegmenter
+{
+public:
+    explicit SamasSegmenter(const Lexicon& Dict);
+
+    //! The segmenter of Dict for the calling thread, cleared first if Dict changed since it was last asked for
+    static SamasSegmenter& of(const Lexicon& Dict);
+
+    //! Same output as slpNPatternDict::SamasLR(word, Dict)
+    string segmentLR(const string& word);
+
+    //! Same output as slpNPatternDict::SamasRL(word, Dict)
+    string segmentRL(const string& word);
+
+    //! Number of parts as counted by slpNPatternDict::cntSamas, min of the LR and RL splits; FlagLR tells which one is smaller as in slpNPatternDict::minsize_t
+    size_t parts(const string& word, bool& FlagLR);
+
+    void clear();
+
+private:
+    const Lexicon& Dict;
+    uint64_t dictStamp;     // Dict.stamp() the cached results were made with
+    slpNPatternDict slnp;
+
+    // dictionary words of the word being segmented: at every position the lengths, longest first
+    string word;
+    vector<vector<size_t> > lengths;
+    vector<int> counts;
+
+    unordered_map<string, string> memoLR, memoRL;
+
+    void index(const string& w);
+    string segment(size_t from, size_t to, bool LR);
+    string cached(unordered_map<string, string>& memo, const string& w, bool LR);
+};
+
+#endif // SAMASSEGMENTER_H
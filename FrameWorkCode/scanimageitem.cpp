@@ -0,0 +1,93 @@
+/*!
+ * \class ScanImageItem
+ * \brief Shows a page scan from a preview and, when zoomed in, from tiles decoded in the background
+ */
+#include "scanimageitem.h"
+#include "pageimagecache.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QWidget>
+#include <qmath.h>
+
+/*!
+ * \fn ScanImageItem::ScanImageItem
+ * \param cache
+ * \param path scan file
+ * \param fullSize size of the scan
+ * \param preview the scan scaled to the view
+ * \param parent
+ */
+ScanImageItem::ScanImageItem(PageImageCache *cache, const QString &path, const QSize &fullSize, const QImage &preview, QGraphicsItem *parent)
+    : QGraphicsObject(parent), cache(cache), path(path), fullSize(fullSize)
+{
+    this->preview = QPixmap::fromImage(preview);
+    previewScale = fullSize.width() > 0 ? qreal(preview.width()) / fullSize.width() : 1;
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);    // for option->exposedRect
+    connect(cache, SIGNAL(tileReady(QString,int,QPoint)), this, SLOT(tileReady(QString,int,QPoint)));
+}
+
+QRectF ScanImageItem::boundingRect() const
+{
+    return QRectF(QPointF(0, 0), QSizeF(fullSize));
+}
+
+/*!
+ * \fn ScanImageItem::paint
+ * \brief Draws the exposed part of the scan from the preview, then the decoded tiles over it if the view
+ * shows more pixels than the preview has
+ * \param painter
+ * \param option
+ * \param widget
+ */
+void ScanImageItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    QRectF exposed = option->exposedRect & boundingRect();
+    if (exposed.isEmpty() || preview.isNull())
+        return;
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+
+    qreal sx = qreal(preview.width()) / fullSize.width();
+    qreal sy = qreal(preview.height()) / fullSize.height();
+    painter->drawPixmap(exposed, preview, QRectF(exposed.x() * sx, exposed.y() * sy, exposed.width() * sx, exposed.height() * sy));
+
+    //! device pixels per pixel of the scan
+    qreal scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    if (widget)
+        scale *= widget->devicePixelRatioF();
+    if (previewScale >= 1 || scale <= previewScale * 1.25)
+        return;
+
+    int level = 0;
+    while (level < MAX_LEVEL && scale * (2 << level) <= 1)
+        level++;
+    int span = PageImageCache::TILE_SIZE << level;
+    int left = qFloor(exposed.left() / span), right = qCeil(exposed.right() / span);
+    int top = qFloor(exposed.top() / span), bottom = qCeil(exposed.bottom() / span);
+    for (int ty = top; ty < bottom; ty++) {
+        for (int tx = left; tx < right; tx++) {
+            QPoint tile(tx, ty);
+            QImage image = cache->tile(path, level, tile);
+            if (image.isNull()) {
+                cache->requestTile(path, level, tile);
+                continue;
+            }
+            QRectF target = QRectF(tx * span, ty * span, span, span) & boundingRect();
+            painter->drawImage(target, image);
+        }
+    }
+}
+
+/*!
+ * \fn ScanImageItem::tileReady
+ * \brief Repaints the part of the scan under a tile that was decoded
+ * \param path
+ * \param level
+ * \param tile
+ */
+void ScanImageItem::tileReady(const QString &path, int level, const QPoint &tile)
+{
+    if (path != this->path)
+        return;
+    int span = PageImageCache::TILE_SIZE << level;
+    update(QRectF(tile.x() * span, tile.y() * span, span, span));
+}
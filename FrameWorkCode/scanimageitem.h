@@ -0,0 +1,39 @@
+#ifndef SCANIMAGEITEM_H
+#define SCANIMAGEITEM_H
+
+#include <QGraphicsObject>
+#include <QPixmap>
+
+class PageImageCache;
+
+/*
+ * The page scan in the image pane. The item spans the full size of the scan, so
+ * scene coordinates stay the pixel coordinates of the scan (bboxes, marked
+ * regions), but it only ever holds a preview scaled to the view. Once the view
+ * is zoomed in past the preview, the exposed part is drawn from tiles of the
+ * PageImageCache at the nearest level that is at least as sharp as the view;
+ * until a tile is decoded the preview is shown in its place.
+ */
+class ScanImageItem : public QGraphicsObject
+{
+    Q_OBJECT
+public:
+    ScanImageItem(PageImageCache *cache, const QString &path, const QSize &fullSize, const QImage &preview, QGraphicsItem *parent = nullptr);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private slots:
+    void tileReady(const QString &path, int level, const QPoint &tile);
+
+private:
+    static const int MAX_LEVEL = 5;
+
+    PageImageCache *cache;
+    QString path;
+    QSize fullSize;
+    QPixmap preview;
+    qreal previewScale;     // width of the preview over the width of the scan
+};
+
+#endif // SCANIMAGEITEM_H
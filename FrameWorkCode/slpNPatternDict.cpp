@@ -21,6 +21,8 @@
 #include <QFile>
 #include "eddis.h"
 #include "slpNPatternDict.h"
+#include "transliterator.h"
+#include "samassegmenter.h"
 
 using namespace std;
 bool HinFlag = 0, SanFlag = 1;
@@ -120,67 +122,9 @@ void slpNPatternDict::loadFileCSV(map<string, vector<int>>& synonym, vector<vect
  * \return
  */
 string slpNPatternDict::toDev(string s)
-{ //Hin:-
-    if (HinFlag){
-        string vowel_dn[]={"अ","आ","इ","ई","उ","ऊ","ऋ","ए","ऐ","ओ","औ","ऑ","ं","ः","ँ","ॅ"};
-        string vowel_dn_joiner[]={"","ा","ि","ी","ु","ू","ृ","े","ै","ो","ौ","ॉ"};
-        string vowel_slp1[]={"a","A","i","I","u","U","f","e","E","o","O","Z","M","H","~","*"};
-        string consonants_dn[]={"क","ख","ग","घ","ङ","च","छ","ज","झ","ञ","ट","ठ","ड","ढ","ण","त","थ","द","ध","न","प","फ","ब","भ","म","य","र","ल","व","श","ष","स","ह","क़","ख़","ग़","ज़","ड़","ढ़","ऩ","फ़","य़","ऱ","ळ"};
-        string consonants_dn_halanta[]={"क्","ख्","ग्","घ्","ङ्","च्","छ्","ज्","झ्","ञ्","ट्","ठ्","ड्","ढ्","ण्","त्","थ्","द्","ध्","न्","प्","फ्","ब्","भ्","म्","य्","र्","ल्","व्","श्","ष्","स्","ह्","क़्","ख़्","ग़्","ज़्","ड़्","ढ़्","ऩ्","फ़्","य़्","ऱ्","ळ्"};
-        string consonants_slp1[]={"k","K","g","G","N","c","C","j","J","Y","w","W","q","Q","R","t","T","d","D","n","p","P","b","B","m","y","r","l","v","S","z","s","h","@","#","$","F","x","X","%","^","&","V","L"};
-        string no_dn[]={"०","१","२","३","४","५","६","७","८","९","॥","।","–","—"};
-        string no_slp1[]={"0","1","2","3","4","5","6","7","8","9","||","|","-","-"};
-
-        for(int i=0;i<44;i++)
-        {
-            s=ReplaceString(s,consonants_slp1[i],consonants_dn_halanta[i]);
-        }
-        for(int i=0;i<12;i++)
-        {
-            s=ReplaceString(s,"्"+vowel_slp1[i],vowel_dn_joiner[i]);
-        }
-        for(int i=0;i<16;i++)
-        {
-            s=ReplaceString(s,vowel_slp1[i],vowel_dn[i]);
-        }
-        for(int i=0;i<13;i++)
-        {
-            s=ReplaceString(s,no_slp1[i],no_dn[i]);
-        }
-    }
-    else if(SanFlag ){
-        string vowel_dn[]={"अ","आ","इ","ई","उ","ऊ","ऋ","ॠ","ऌ","ॡ","ए","ऐ","ओ","औ","ं","ः","ँ","ᳲ","ᳳ","ऽ","ॐ"};
-        string vowel_dn_joiner[]={"","ा","ि","ी","ु","ू","ृ","ॄ","ॢ","ॣ","े","ै","ो","ौ"};
-        //string consonants_dn[]={"क","ख","ग","घ","ङ","च","छ","ज","झ","ञ","ट","ठ","ड","ढ","ण","त","थ","द","ध","न","प","फ","ब","भ","म","य","र","ल","व","श","ष","स","ह","ळ"};
-        string consonants_dn_halanta[]={"क्","ख्","ग्","घ्","ङ्","च्","छ्","ज्","झ्","ञ्","ट्","ठ्","ड्","ढ्","ण्","त्","थ्","द्","ध्","न्","प्","फ्","ब्","भ्","म्","य्","र्","ल्","व्","श्","ष्","स्","ह्","ळ्"};
-        string vowel_slp1[]={"a","A","i","I","u","U","f","F","x","X","e","E","o","O","M","H","~","Z","V","$","%"};
-        string consonants_slp1[]={"k","K","g","G","N","c","C","j","J","Y","w","W","q","Q","R","t","T","d","D","n","p","P","b","B","m","y","r","l","v","S","z","s","h","L"};
-        string numbers_etc_dn[]={"॥","।","॰","ऽ","‘","’","“","”","ॐ","१","२","३","४","५","६","७","८","९","०"};
-        string numbers_eng[]={"||","|","^0","$","-'","'","-\"","\"","%","1","2","3","4","5","6","7","8","9","0"};
-
-
-        for(int i=0;i<34;i++)
-        {
-            s=ReplaceString(s,consonants_slp1[i],consonants_dn_halanta[i]);
-        }
-
-        for(int i=0;i<14;i++)
-        {
-            s=ReplaceString(s,"्"+vowel_slp1[i],vowel_dn_joiner[i]);
-        }
-
-        for(int i=0;i<21;i++)
-        {
-            s=ReplaceString(s,vowel_slp1[i],vowel_dn[i]);
-        }
-
-        for(unsigned int i=0;i<(sizeof(numbers_etc_dn)/sizeof(numbers_etc_dn[0]));i++)
-        {
-            s=ReplaceString(s,numbers_eng[i],numbers_etc_dn[i]);
-        }
-
-    }
-
+{
+    if (HinFlag) return Transliterator(Transliterator::Hindi).toDev(s);
+    else if (SanFlag) return Transliterator(Transliterator::Sanskrit).toDev(s);
     return s;
 }
 
@@ -190,98 +134,9 @@ string slpNPatternDict::toDev(string s)
  * \return
  */
 string slpNPatternDict::toslp1(string s)
-{ //Hin:-
-    if (HinFlag){
-        string vowel_dn[]={"अ","आ","इ","ई","उ","ऊ","ऋ","ए","ऐ","ओ","औ","ऑ","ं","ः","ँ","ॅ"};
-        string vowel_dn_joiner[]={"ा","ि","ी","ु","ू","ृ","े","ै","ो","ौ","ॉ"};
-        string vowel_slp1[]={"a","A","i","I","u","U","f","e","E","o","O","Z","M","H","*","~"};
-        string consonants_dn[]={"क","ख","ग","घ","ङ","च","छ","ज","झ","ञ","ट","ठ","ड","ढ","ण","त","थ","द","ध","न","प","फ","ब","भ","म","य","र","ल","व","श","ष","स","ह","क़","ख़","ग़","ज़","ड़","ढ़","ऩ","फ़","य़","ऱ","ळ"};
-        string consonants_dn_halanta[]={"क्","ख्","ग्","घ्","ङ्","च्","छ्","ज्","झ्","ञ्","ट्","ठ्","ड्","ढ्","ण्","त्","थ्","द्","ध्","न्","प्","फ्","ब्","भ्","म्","य्","र्","ल्","व्","श्","ष्","स्","ह्","क़्","ख़्","ग़्","ज़्","ड़्","ढ़्","ऩ्","फ़्","य़्","ऱ्","ळ्"};
-        string consonants_slp1[]={"k","K","g","G","N","c","C","j","J","Y","w","W","q","Q","R","t","T","d","D","n","p","P","b","B","m","y","r","l","v","S","z","s","h","@","#","$","F","x","X","%","^","&","V","L"};
-        string no_dn[]={"०","१","२","३","४","५","६","७","८","९","॥","।","–","—"};
-        string no_slp1[]={"0","1","2","3","4","5","6","7","8","9","||","|","-","-"};
-
-        for(int i=0;i<44;i++)
-        {
-            s=ReplaceString(s,consonants_dn_halanta[i],consonants_slp1[i]);
-        }
-        for(int i=0;i<11;i++)
-        {
-            s=ReplaceString(s,vowel_dn_joiner[i],vowel_slp1[i+1]);
-        }
-        for(int i=0;i<16;i++)
-        {
-            s=ReplaceString(s,vowel_dn[i],vowel_slp1[i]);
-        }
-        for(int i=0;i<43;i++)
-        {
-            s=ReplaceStringRestricted(s,consonants_dn[i],consonants_slp1[i]);
-        }
-        for(int i=0;i<14;i++)
-        {
-            s=ReplaceString(s,no_dn[i],no_slp1[i]);
-        }
-
-    }
-    else if(SanFlag){
-        //San:-
-        string vowel_dn[]={"अ","आ","इ","ई","उ","ऊ","ऋ","ॠ","ऌ","ॡ","ए","ऐ","ओ","औ","ं","ः","ँ","ᳲ","ᳳ"};
-        string vowel_dn_joiner[]={"ा","ि","ी","ु","ू","ृ","ॄ","ॢ","ॣ","े","ै","ो","ौ"};
-        string consonants_dn[]={"क","ख","ग","घ","ङ","च","छ","ज","झ","ञ","ट","ठ","ड","ढ","ण","त","थ","द","ध","न","प","फ","ब","भ","म","य","र","ल","व","श","ष","स","ह","ळ"};
-        string consonants_dn_halanta[]={"क्","ख्","ग्","घ्","ङ्","च्","छ्","ज्","झ्","ञ्","ट्","ठ्","ड्","ढ्","ण्","त्","थ्","द्","ध्","न्","प्","फ्","ब्","भ्","म्","य्","र्","ल्","व्","श्","ष्","स्","ह्","ळ्"};
-        string vowel_slp1[]={"a","A","i","I","u","U","f","F","x","X","e","E","o","O","M","H","~","Z","V"};
-        string consonants_slp1[]={"k","K","g","G","N","c","C","j","J","Y","w","W","q","Q","R","t","T","d","D","n","p","P","b","B","m","y","r","l","v","S","z","s","h","L"};
-        //cout<<s<<endl;
-        size_t pos = 0;
-        while((pos=s.find("ॆ", pos)) != string::npos)
-            s.replace(pos, 3,"े");
-
-        pos = 0;
-        while((pos=s.find("ऎ", pos)) != string::npos)
-            s.replace(pos, 3,"एे");
-
-        size_t pos1 = 0;
-        while((pos1=s.find("ॊ", pos1)) != string::npos)
-            s.replace(pos1, 3,"ो");
-        //cout<<s<<endl;
-        pos1 = 0;
-        //cout<<s<<" "<<s.find("ऴ्", pos1)<<endl;
-        while((pos1=s.find("ऴ्", pos1)) != string::npos)//"ळ" is valid, dot below "ळ" is invalid char
-        {s.replace(pos1, 6,"ळ्"); }
-        //cout<<s<<endl;
-        pos1 = 0;
-
-        while((pos1=s.find("ऴ", pos1)) != string::npos)//"ळ" is valid, dot below "ळ" is invalid char
-        {s.replace(pos1, 6,"ळ"); }
-        //cout<<s<<endl;
-
-        for(int i=0;i<34;i++)
-        {
-            s=ReplaceString(s,consonants_dn_halanta[i],consonants_slp1[i]);
-        }
-
-        for(int i=0;i<13;i++)
-        {
-            s=ReplaceString(s,vowel_dn_joiner[i],vowel_slp1[i+1]);
-        }
-
-        for(int i=0;i<34;i++)
-        {   //cout<< i << " " << consonants_dn[i] << " " << consonants_slp1[i] << endl;
-            s=ReplaceStringRestricted(s,consonants_dn[i],consonants_slp1[i]);
-        }
-
-        for(int i=0;i<19;i++)
-        {
-            s=ReplaceString(s,vowel_dn[i],vowel_slp1[i]);
-        }
-
-        string numbers_etc_dn[]={"॥","।","॰","ऽ","‘","’","“","”","ॐ","१","२","३","४","५","६","७","८","९","०"};
-        string numbers_eng[]={"||","|","^0","$","-'","'","-\"","\"","%","1","2","3","4","5","6","7","8","9","0"};
-        for(uint i=0;i<(sizeof(numbers_etc_dn)/sizeof(numbers_etc_dn[0]));i++)
-        {
-            s=ReplaceString(s,numbers_etc_dn[i],numbers_eng[i]);
-        }
-    } //ifSanflag over
+{
+    if (HinFlag) return Transliterator(Transliterator::Hindi).toslp1(s);
+    else if (SanFlag) return Transliterator(Transliterator::Sanskrit).toslp1(s);
     return s;
 }
 
@@ -345,8 +200,8 @@ void slpNPatternDict::printmapWFreq(map<string,int>& m1){
  * \param Dict
  * \param PWords
  */
-void slpNPatternDict::loadCwordsPair(string wordL,string wordR, map<string, string>& CPair,map<string,int>& Dict,map<string,int>&  PWords){
-    if ((Dict[wordL] ==0) && (PWords[wordL] == 0)) CPair[wordL] = wordR;
+void slpNPatternDict::loadCwordsPair(string wordL,string wordR, map<string, string>& CPair,const Lexicon& Dict,const Lexicon&  PWords){
+    if ((Dict.count(wordL) ==0) && (PWords.count(wordL) == 0)) CPair[wordL] = wordR;
 }
 
 /*!
@@ -356,7 +211,7 @@ void slpNPatternDict::loadCwordsPair(string wordL,string wordR, map<string, stri
  * \param Dict
  * \param PWords
  */
-void loadCPair(string filename, map<string, string>& CPair,map<string,int>&  Dict, map<string,int>&  PWords){
+void loadCPair(string filename, map<string, string>& CPair,const Lexicon&  Dict, const Lexicon&  PWords){
     ifstream myfile(filename);
     slpNPatternDict slnp;
     if (myfile.is_open())
@@ -375,7 +230,7 @@ void loadCPair(string filename, map<string, string>& CPair,map<string,int>&  Dic
  * \param Dict
  * \param PWords
  */
-void slpNPatternDict::loadCwordsPairs(string wordL,string wordR, map<string, set<string> >& CPairs,map<string,int>& Dict,map<string,int>&  PWords)
+void slpNPatternDict::loadCwordsPairs(string wordL,string wordR, CorrectionPairs& CPairs,const Lexicon& Dict,const Lexicon&  PWords)
 {
     //cout<< "hello"<<wordR<<endl;
     std::replace(wordR.begin(), wordR.end(), ',', ' ');
@@ -388,7 +243,7 @@ void slpNPatternDict::loadCwordsPairs(string wordL,string wordR, map<string, set
         setstring.insert(setwords);
     }
     //set<string> wordRs = wordR;
-    CPairs[wordL] = setstring;
+    CPairs.set(wordL, setstring);
 }
 
 /*!
@@ -398,7 +253,7 @@ void slpNPatternDict::loadCwordsPairs(string wordL,string wordR, map<string, set
  * \param Dict
  * \param PWords
  */
-void slpNPatternDict::loadCPairs(string filename, map<string, set<string> >& CPairs,map<string,int>&  Dict, map<string,int>&  PWords)
+void slpNPatternDict::loadCPairs(string filename, CorrectionPairs& CPairs,const Lexicon&  Dict, const Lexicon&  PWords)
 {
     ifstream myfile(filename);
     if (myfile.is_open())
@@ -453,11 +308,12 @@ void slpNPatternDict::loadCPairs(string filename, map<string, set<string> >& CPa
  * \param vec
  * \param GBook
  */
-void slpNPatternDict::loadMapNV(string fileName, map<string,int>& OCRWords, vector<string>& vec, string GBook){
-    ifstream myfile(fileName);
-    if (myfile.is_open())
-    { string str1;
-        while (myfile >> str1 ) { str1 = toslp1(str1); OCRWords[str1] = OCRWords[str1] + 1;vec.push_back(str1);}
+void slpNPatternDict::loadMapNV(string fileName, Lexicon& OCRWords, vector<string>& vec, string GBook){
+    Transliterator tr(HinFlag ? Transliterator::Hindi : Transliterator::Sanskrit);
+    size_t first = vec.size();
+    if (tr.toslp1File(fileName, vec))
+    {
+        for (size_t i = first; i < vec.size(); i++) OCRWords.add(vec[i]);
         cout <<GBook <<" " <<OCRWords.size() <<" Words Loaded in mapNvector" << endl;
     } else cout <<"Error:" << GBook<<  "Words NOT Loaded in mapNvector" << endl;
 }
@@ -466,21 +322,68 @@ int slpNPatternDict::minIG(int a, int b){ if(a>b)return b; else return a;}
 int slpNPatternDict::maxIG(int a, int b){ if(a<b)return b; else return a;}
 
 
-void slpNPatternDict::loadMapPWords(vector<string>& vGBook,vector<string>& vIBook, map<string,int>& PWords){
+/*!
+ * \fn slpNPatternDict::loadMapPWords
+ * \brief An IEROCR word goes to PWords when it is a substring of a GEROCR word within the window of
+ *        |vGBook|-|vIBook| words around its position. Every GEROCR word is mapped once to the IEROCR
+ *        words it contains, and the window keeps a count per IEROCR word while it slides, so the cost
+ *        no longer depends on the window size.
+ * \param vGBook
+ * \param vIBook
+ * \param PWords
+ */
+void slpNPatternDict::loadMapPWords(vector<string>& vGBook,vector<string>& vIBook, Lexicon& PWords){
     int vGsz = vGBook.size(), vIsz =  vIBook.size();
     int win = vGsz  - vIsz;
     if(win<0) win = -1*win;
-    // search for a word(pre space, post space as well) in Indsenz within win sized window in GDocs and if found then add to PWords
-    for(int t = 0; t < vIsz;t++){
-        for(int t1 = maxIG(t-win,0); t1 < min(t+win,vGsz); t1++){
-            string s1 = vIBook[t]; //(vGBook[t1].find(s1) != string::npos) || (vGBook[t1] == s1)
-            if( (vGBook[t1].find(s1) != string::npos)|| (vGBook[t1].find(s1 + " ") != string::npos) || (vGBook[t1].find(" " + s1) != string::npos)) {PWords[s1]++; break;}
+
+    //! ids of the distinct IEROCR words, stored as id + 1
+    Lexicon iIds;
+    vector<int> iWord(vIsz);
+    size_t maxLen = 0;
+    for(int t = 0; t < vIsz; t++){
+        const string& s1 = vIBook[t];
+        if(!iIds.contains(s1)) iIds.set(s1, (int)iIds.size() + 1);
+        iWord[t] = iIds.count(s1) - 1;
+        maxLen = max(maxLen, s1.size());
+    }
+
+    //! IEROCR words contained in every distinct GEROCR word
+    Lexicon gIds;
+    vector<int> gWord(vGsz);
+    vector<vector<int> > contains;
+    for(int t1 = 0; t1 < vGsz; t1++){
+        const string& g = vGBook[t1];
+        if(!gIds.contains(g)){
+            gIds.set(g, (int)gIds.size() + 1);
+            vector<int> ids;
+            for(size_t b = 0; b < g.size(); b++)
+                for(size_t len = 1; len <= maxLen && b + len <= g.size(); len++){
+                    int id = iIds.count(g.data() + b, len);
+                    if(id) ids.push_back(id - 1);
+                }
+            sort(ids.begin(), ids.end());
+            ids.erase(unique(ids.begin(), ids.end()), ids.end());
+            contains.push_back(ids);
         }
+        gWord[t1] = gIds.count(g) - 1;
+    }
+
+    //! slide the window [lo, hi) = [max(t-win,0), min(t+win,vGsz)) over vGBook; both ends only move right
+    vector<int> inWindow(iIds.size(), 0);
+    int curLo = 0, curHi = 0;
+    for(int t = 0; t < vIsz; t++){
+        int lo = maxIG(t-win,0), hi = maxIG(lo, min(t+win,vGsz));
+        for(; curLo < lo; curLo++)
+            if(curLo < curHi) { const vector<int>& ids = contains[gWord[curLo]]; for(size_t k = 0; k < ids.size(); k++) inWindow[ids[k]]--; }
+        if(curHi < curLo) curHi = curLo;
+        for(; curHi < hi; curHi++) { const vector<int>& ids = contains[gWord[curHi]]; for(size_t k = 0; k < ids.size(); k++) inWindow[ids[k]]++; }
+        if(inWindow[iWord[t]] > 0) PWords.add(vIBook[t]);
     }
     cout << PWords.size() << " words loaded in PWords" << endl;
 }
 
-string slpNPatternDict::findDictEntries1(string s1,  map<string, int>& m2, map<string, int>& m1, int size) { //unordered_
+string slpNPatternDict::findDictEntries1(string s1,  const Lexicon& m2, const Lexicon& m1, int size) { //unordered_
 
     if((s1.size() == 0) || (s1 == "")) return "";
 
@@ -490,9 +393,9 @@ string slpNPatternDict::findDictEntries1(string s1,  map<string, int>& m2, map<s
     //rAmaAnand
     for(size_t j =0; j < s1.size() ; j++){ //- i +1 j= 0:8
         for(size_t i = s1.size() - j; i > 0; i--){// j0 i = 9:1 rAmaAnand rAmaAnan rAmaAna.. , j1  8:2
-            string str = s1.substr(j,i); //&&((str.size() >= 3)|| ( (str.size()==2) && (str[1] != 'a') &&( size< 3) ) || ((str.size() ==1)&&( size< 2) ) ))
+            //&&((str.size() >= 3)|| ( (str.size()==2) && (str[1] != 'a') &&( size< 3) ) || ((str.size() ==1)&&( size< 2) ) ))
             //cout << "str  "<< str << endl;
-            if((m2[str]>0)||(m1[str]>0)) { //cout << "here "<< str << "L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
+            if((m2.count(s1.data() + j, i)>0)||(m1.count(s1.data() + j, i)>0)) { string str = s1.substr(j,i); //cout << "here "<< str << "L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
                 //colorFlag = !colorFlag;
                 //string strcolor = color[colorFlag];// << endl;
                 //cout << "str  "<< str << endl;
@@ -506,9 +409,35 @@ string slpNPatternDict::findDictEntries1(string s1,  map<string, int>& m2, map<s
     return ("<font color=\'red\'>" + toDev(s1) + "</font>");
 }
 
-string slpNPatternDict::findDictEntries(string s1,  map<string, int>& m2, map<string, int>& m1, int size) { //unordered_
-    m2["rAma"]++;
-    m2["rAm"]++;
+/*!
+ * \fn slpNPatternDict::findDictEntryParts
+ * \brief Splits s1 like findDictEntries1: the leftmost position starting a word of m2 or m1 takes its longest word there,
+ * the text before it has no word and the rest is split the same way
+ * \param s1
+ * \param m2
+ * \param m1
+ * \param parts
+ */
+void slpNPatternDict::findDictEntryParts(const string& s1, const Lexicon& m2, const Lexicon& m1, vector<pair<size_t, bool> >& parts)
+{
+    parts.clear();
+    size_t pos = 0, n = s1.size();
+    while (pos < n) {
+        size_t j = pos, len = 0;
+        for (; j < n && len == 0; j++)
+            for (size_t i = n - j; i > 0; i--)
+                if ((m2.count(s1.data() + j, i) > 0) || (m1.count(s1.data() + j, i) > 0)) { len = i; break; }
+        if (len == 0) { parts.push_back(make_pair(n - pos, false)); break; }
+        j--;
+        if (j > pos) parts.push_back(make_pair(j - pos, false));
+        parts.push_back(make_pair(len, true));
+        pos = j + len;
+    }
+}
+
+string slpNPatternDict::findDictEntries(string s1,  Lexicon& m2, const Lexicon& m1, int size) { //unordered_
+    m2.add("rAma");
+    m2.add("rAm");
     string s = findDictEntries1(s1,m2,m1, size);
 
     string vowel_dn[]={"आ","इ","ई","उ","ऊ","ऋ","ॠ","ऌ","ॡ","ए","ऐ","ओ","औ"};
@@ -567,12 +496,13 @@ bool slpNPatternDict::hasNoAsci(string word1){
  * \param OCRWords
  * \param GBook
  */
-void slpNPatternDict::loadMap(string fileName, map<string,int>& OCRWords, string GBook){
+void slpNPatternDict::loadMap(string fileName, Lexicon& OCRWords, string GBook){
     size_t szp = OCRWords.size();
     ifstream myfile(fileName);
     if (myfile.is_open())
-    { string str1;
-        while (myfile >> str1 ) { if(!hasM40PerAsci(str1)) {str1 = toslp1(str1); /*cout <<str1<<endl;*/ OCRWords[str1] = OCRWords[str1] + 1;}}
+    { string str1, slp;
+        Transliterator tr(HinFlag ? Transliterator::Hindi : Transliterator::Sanskrit);
+        while (myfile >> str1 ) { if(!hasM40PerAsci(str1)) {tr.toslp1(str1, slp); OCRWords.add(slp);}}
         cout << GBook <<" " <<OCRWords.size() - szp<<" Words Loaded" << endl;
     } else cout <<"Error:" << GBook<<  "Words NOT Loaded" << endl;
 }
@@ -606,13 +536,13 @@ bool slpNPatternDict::insertPatternstoMap(string str, map<string,int>& TPWordsP,
  * \param count6
  * \return
  */
-size_t slpNPatternDict::loadDictPatternstoMap(map<string,int >& TPWordsP, map<string,int >& PWords,size_t& count6){ // arg1(strt from 0) ,map<string,int >& PWordsP
+size_t slpNPatternDict::loadDictPatternstoMap(map<string,int >& TPWordsP, const Lexicon& PWords,size_t& count6){ // arg1(strt from 0) ,map<string,int >& PWordsP
     //! ADDED FOR FEATYRE EXTRACTION
     size_t count = 0,maxsiz = 0;
-    for( map<string,int >::const_iterator ptr=PWords.begin();
-         ptr!=PWords.end(); ptr++) {
-        insertPatternstoMap(ptr->first, TPWordsP,count,count6);
-        if (ptr->first.size() > maxsiz) maxsiz = ptr->first.size();
+    for(size_t i = 0; i < PWords.size(); i++) {
+        string w = PWords.key(i);
+        insertPatternstoMap(w, TPWordsP,count,count6);
+        if (w.size() > maxsiz) maxsiz = w.size();
     }
     cout << count <<" patterns loaded " << endl;
     //cout << "m2 size " << m2.size() << endl;
@@ -628,7 +558,7 @@ size_t slpNPatternDict::loadDictPatternstoMap(map<string,int >& TPWordsP, map<st
  * \param count
  * \return
  */
-bool slpNPatternDict::getNgramFeaturesinVect(string str,map<string,int>& Dict,vector<bool>& vb,vector<size_t>& vbf, size_t& count){
+bool slpNPatternDict::getNgramFeaturesinVect(string str,const Lexicon& Dict,vector<bool>& vb,vector<size_t>& vbf, size_t& count){
     //! ADDED FOR FEATYRE EXTRACTION
     size_t sz = str.size();
     //cout<<sz<<endl;
@@ -637,7 +567,7 @@ bool slpNPatternDict::getNgramFeaturesinVect(string str,map<string,int>& Dict,ve
         string s1 = str.substr(0,i);
         //cout<<s1<<endl;
         if(s1.size() < 9){
-            if (Dict[s1]>0){vb.push_back(1); vbf.push_back(Dict[s1]);} else {vb.push_back(0); vbf.push_back(0);}
+            if (Dict.count(s1)>0){vb.push_back(1); vbf.push_back(Dict.count(s1));} else {vb.push_back(0); vbf.push_back(0);}
             count++;
         }
         //cout << vb[count]<<endl;
@@ -714,7 +644,7 @@ bool slpNPatternDict::searchS1inGVec(string s1,size_t iocrdone,vector<string>& g
  * \param m1
  * \return
  */
-string slpNPatternDict::findDictEntries(string s1,  map<string, int>& m2, map<string, int>& m1) {//unordered_
+string slpNPatternDict::findDictEntries(string s1,  const Lexicon& m2, const Lexicon& m1) {//unordered_
 
     if((s1.size() == 0) || (s1 == "")) return "";
 
@@ -724,9 +654,9 @@ string slpNPatternDict::findDictEntries(string s1,  map<string, int>& m2, map<st
     for(size_t i = s1.size(); i > 0; i --){
         for(size_t j =0; j < s1.size() - i +1; j++){
             string str = s1.substr(j,i);
-            if((m1[str]>0) ) { //cout << "here "<< str << "L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
+            if((m1.count(str)>0) ) { //cout << "here "<< str << "L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
                 return findDictEntries(s1.substr(0,j),m2,m1) + "<font color=\'" + "green" + "\'>" + toDev(str) + "</font>" +  findDictEntries(s1.substr(j+i,s1.size()-i),m2,m1);
-            } else if(m2[str]>4) {//cout << "here "<< str << "L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
+            } else if(m2.count(str)>4) {//cout << "here "<< str << "L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
                 return findDictEntries(s1.substr(0,j),m2,m1) + "<font color=\'" + "cyan" + "\'>" + toDev(str) + "</font>" +  findDictEntries(s1.substr(j+i,s1.size()-i),m2,m1);
             }
         }
@@ -1169,9 +1099,9 @@ string slpNPatternDict::appendConfusionsPairsNindex(string str1, string str2, ve
  * \param ConfP
  * \param ConfPmap
  */
-void slpNPatternDict::loadvectomap(vector<string> ConfP, map<string,int>& ConfPmap){
+void slpNPatternDict::loadvectomap(vector<string> ConfP, Lexicon& ConfPmap){
 
-    for(size_t t = 0; t<ConfP.size(); t++) ConfPmap[ConfP[t]]++;
+    for(size_t t = 0; t<ConfP.size(); t++) ConfPmap.add(ConfP[t]);
 
 }
 
@@ -1201,7 +1131,7 @@ void slpNPatternDict::printvecint(vector<int> ConfP){
  * \param fileName
  * \param ConfPmap
  */
-void slpNPatternDict::loadConfusions(string fileName,map<string,int>& ConfPmap){
+void slpNPatternDict::loadConfusions(string fileName,Lexicon& ConfPmap){
     vector<string> ConfP;
     string str1, str2;
     ifstream myfile(fileName);
@@ -1220,7 +1150,7 @@ void slpNPatternDict::loadConfusions(string fileName,map<string,int>& ConfPmap){
  * \param fileName2
  * \param ConfPmap
  */
-void slpNPatternDict::loadConfusions2(string fileName1,string fileName2,map<string,int>& ConfPmap){
+void slpNPatternDict::loadConfusions2(string fileName1,string fileName2,Lexicon& ConfPmap){
     vector<string> ConfP;
     string str1, str2;
     ifstream myfile(fileName1);
@@ -1240,7 +1170,7 @@ void slpNPatternDict::loadConfusions2(string fileName1,string fileName2,map<stri
  * \param fileName2
  * \param ConfPmap
  */
-void slpNPatternDict::loadConfusionsFont(vector<string> fileName1,vector<string> fileName2,map<string,int>& ConfPmap){
+void slpNPatternDict::loadConfusionsFont(vector<string> fileName1,vector<string> fileName2,Lexicon& ConfPmap){
     vector<string> ConfP;
     if (fileName1.size() > 0)
     { for(size_t i =0;i < fileName1.size(); i++ ){
@@ -1474,17 +1404,21 @@ void slpNPatternDict::loadCPair(string fileName1,string fileName2,map<string,str
  * \param TopConfusions
  * \param TopConfusionsMask
  */
-void slpNPatternDict::loadTopConfusions(map<string,int>& ConfPmap,map<string, string>& TopConfusions,map<string, int>& TopConfusionsMask){
+void slpNPatternDict::loadTopConfusions(const Lexicon& ConfPmap,map<string, string>& TopConfusions,Lexicon& TopConfusionsMask){
     map<string, int> TopSuggFreq;
-    for(map<string, int >::const_iterator it = ConfPmap.begin();
-        it != ConfPmap.end(); ++it)
+    //! visit the rules in key order, as the last rule for l is the one kept
+    vector<pair<string, int> > rules;
+    for(size_t i = 0; i < ConfPmap.size(); i++) rules.push_back(make_pair(ConfPmap.key(i), ConfPmap.value(i)));
+    sort(rules.begin(), rules.end());
+    for(vector<pair<string, int> >::const_iterator it = rules.begin();
+        it != rules.end(); ++it)
     {
         //std::cout << it->first << " " << it->second<< "\n";
         string rule = it->first; istringstream s(rule);string l,r; s>>l; s>>r;
         //if(TopSuggFreq[l] < it->second){
         TopSuggFreq[l] = it->second;
         TopConfusions[l] = r;
-        TopConfusionsMask[l] ++;
+        TopConfusionsMask.add(l);
         //}
         l.clear(); r.clear();
     }
@@ -1512,15 +1446,13 @@ std::string slpNPatternDict::tokenize(const std::string& s) {
  * \fn slpNPatternDict::printConfusionRulesmap
  * \param ConfPmap
  */
-void slpNPatternDict::printConfusionRulesmap(map<string,int>& ConfPmap){
+void slpNPatternDict::printConfusionRulesmap(const Lexicon& ConfPmap){
     //! print only rules in Pattern Miner's Rule Input form
     map<string,vector<string> > rulesCorrectFormat;
     //! print the Map rule and correct the format
-    for(map<string, int >::const_iterator it = ConfPmap.begin();
-        it != ConfPmap.end(); ++it)
+    for(size_t i = 0; i < ConfPmap.size(); i++)
     {
-        //std::cout << it->first << " " << it->second<< "\n";
-        string rule = it->first; istringstream s(rule);  string l,r; s>>l; s>>r;
+        string rule = ConfPmap.key(i); istringstream s(rule);  string l,r; s>>l; s>>r;
         if((l.size() < 3) && (r.size() < 3)) rulesCorrectFormat[r].push_back(l);
     }
     //file.close();
@@ -1546,24 +1478,24 @@ void slpNPatternDict::printConfusionRulesmap(map<string,int>& ConfPmap){
  * \param wCindex
  * \return
  */
-int slpNPatternDict::loadWConfusionsNindex1(string str1,string str2,map<string,int>& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex){
+int slpNPatternDict::loadWConfusionsNindex1(string str1,string str2,const Lexicon& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex){
     string str1New = appendConfusionsPairsNindex(str1,str2,wordConfusions,wCindex);
 
     //!for choosing best out of nearest suggestions:-
     int szold = wordConfusions.size();// more confusions more szold
     //filter confusions:-
     //cout<< str1New << endl;
-    for(size_t t = 0; t<wordConfusions.size(); t++) { if(ConfPmap[wordConfusions[t]]>0) {/*cout << wCindex[t] << " "<< toDev(wordConfusions[t]) << endl;*/} else {wordConfusions.erase(wordConfusions.begin() + t); wCindex.erase(wCindex.begin() + t); t--;}}
+    for(size_t t = 0; t<wordConfusions.size(); t++) { if(ConfPmap.count(wordConfusions[t])>0) {/*cout << wCindex[t] << " "<< toDev(wordConfusions[t]) << endl;*/} else {wordConfusions.erase(wordConfusions.begin() + t); wCindex.erase(wCindex.begin() + t); t--;}}
     return 	(szold - wordConfusions.size());//  more confusions are Indsenz OCR Confusions, less will be difference
 }
 
 //! for alligning OCR Pair words
-string slpNPatternDict::loadWConfusionsNindex(string str1,string str2,map<string,int>& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex){
+string slpNPatternDict::loadWConfusionsNindex(string str1,string str2,const Lexicon& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex){
     string str1New = appendConfusionsPairsNindex(str1,str2,wordConfusions,wCindex);
 
     //filter confusions:-
     //cout<< str1New << endl;
-    for(size_t t = 0; t<wordConfusions.size(); t++) { if(ConfPmap[wordConfusions[t]]>0) {/*cout << wCindex[t] << " "<< toDev(wordConfusions[t]) << endl;*/} else {wordConfusions.erase(wordConfusions.begin() + t); wCindex.erase(wCindex.begin() + t); t--;}}
+    for(size_t t = 0; t<wordConfusions.size(); t++) { if(ConfPmap.count(wordConfusions[t])>0) {/*cout << wCindex[t] << " "<< toDev(wordConfusions[t]) << endl;*/} else {wordConfusions.erase(wordConfusions.begin() + t); wCindex.erase(wCindex.begin() + t); t--;}}
     return 	str1New;
 }
 
@@ -1676,60 +1608,26 @@ size_t slpNPatternDict::cntSamas(string in, string& out){
 
 /*!
  * \fn slpNPatternDict::SamasLR
+ * \brief Splits s1 around its longest word in m1 (the leftmost one if there are several), then splits the left and right remainders the same way
  * \param s1
  * \param m1
- * \return
+ * \return the parts separated by spaces, parts not in m1 as #part#
+ * \sa SamasSegmenter
  */
-string slpNPatternDict::SamasLR(string s1, map<string, int>& m1) {//, map<string, int>& PWordsNew
-
-    if((s1.size() == 0) || (s1 == "")) return "";
-    if((m1[s1]>0)) return " " + s1 + " ";//||PWordsNew[s1]>0
-    //cout << "s1 "<< s1 << endl;
-    for(size_t i = s1.size(); i > 0; i --){// DASOAHAM 8
-        for(size_t j =0; j < s1.size() - i+1; j++){ // i determinze size of substring
-            string str = s1.substr(j,i);//  i = 8, j = 0:0 DASOAHAM ; i = 7, j = 0:1  DASOAHA ASOAHAM..... ;i =1, j = 0:7 D A S O A H A M
-            // checking str
-            //cout <<"str outside " << str << endl;
-            if((m1[str]>0)) {//||PWordsNew[str]>0 //cout << "here "<< str << " L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
-                //cout <<"str inside " << str << endl;
-                //cout <<"left "<< s1.substr(0,j) << " nearest "<< searchTrie(s1.substr(0,j)) << endl;
-                //cout <<"right "<< s1.substr(j+i,s1.size()-i) << " nearest "<< searchTrie(s1.substr(j+i,s1.size()-i)) << endl;
-                return (SamasLR(s1.substr(0,j),m1) + " " + (str)+ " " + SamasLR(s1.substr(j+i,s1.size()-i),m1) ); //,PWordsNew,PWordsNew
-            }
-        }
-    }
-    return (" #" + s1 + "# ");
-    //
-    //return ((s1));//("#" + s1 + "#");//
+string slpNPatternDict::SamasLR(string s1, const Lexicon& m1) {
+    return SamasSegmenter::of(m1).segmentLR(s1);
 }
 
 /*!
  * \fn slpNPatternDict::SamasRL
+ * \brief As SamasLR() but takes the rightmost of the longest words
  * \param s1
  * \param m1
  * \return
+ * \sa SamasSegmenter
  */
-string slpNPatternDict::SamasRL(string s1, map<string, int>& m1) { //, map<string, int>& PWordsNew
-
-    if((s1.size() == 0) || (s1 == "")) return "";
-    if((m1[s1]>0)) return " " + s1 + " ";//||PWordsNew[s1]>0
-    //cout << "s1 "<< s1 << endl;
-    for(size_t i = s1.size(); i > 0; i --){// DASOAHAM 8
-        for(size_t j =0; j < s1.size() - i+1; j++){ // i determinze size of substring
-            //cout << s1.size() << " " << j << endl;
-            size_t jd =s1.size() - i - j;
-            string str = s1.substr(jd,i);
-            if((m1[str]>0)) {//||PWordsNew[str]>0 //cout << "here "<< str << " L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
-                //cout <<"str inside " << str << endl;
-                //cout <<"left "<< s1.substr(0,j) << " nearest "<< searchTrie(s1.substr(0,j)) << endl;
-                //cout <<"right "<< s1.substr(j+i,s1.size()-i) << " nearest "<< searchTrie(s1.substr(j+i,s1.size()-i)) << endl;
-                return (SamasRL(s1.substr(0,jd),m1) + " " + (str)+ " " + SamasRL(s1.substr(jd+i,s1.size()-i),m1) );//,PWordsNew,PWordsNew
-            }
-        }
-    }
-    return (" #" + s1 + "# ");
-    //
-    //return ((s1));//("#" + s1 + "#");//
+string slpNPatternDict::SamasRL(string s1, const Lexicon& m1) {
+    return SamasSegmenter::of(m1).segmentRL(s1);
 }
 
 
@@ -1740,23 +1638,51 @@ size_t slpNPatternDict::minsize_t(size_t a,size_t b,bool& FlagLR){
     if (b < a) {FlagLR = 0; return b;} else {FlagLR =1; return a;}
 }
 
+/*!
+ * \fn slpNPatternDict::applyConfusions
+ * \brief Applies the confusions whose bits are set in mask to the aligned string, last one first so that the earlier indexes stay valid
+ * \param str1New aligned string from loadWConfusionsNindex()
+ * \param mask bit k stands for wordConfusions[k]
+ * \param wordConfusions
+ * \param wCindex
+ * \return the new word
+ */
+string slpNPatternDict::applyConfusions(const string& str1New, uint64_t mask, const vector<string>& wordConfusions, const vector<int>& wCindex)
+{
+    string newstring = str1New;
+    for(size_t j = wordConfusions.size(); j > 0; j--){
+        if(mask & ((uint64_t)1 << (j-1))) replacestrcnf(newstring,wCindex[j-1],wordConfusions[j-1]);
+    }
+    return removeSpaces(newstring.substr(1,newstring.size()-2));
+}
+
 //print2OCRSugg("RemGOCR",ConfPmap,Dict,SmasWords)
 /*!
  * \fn slpNPatternDict::print2OCRSugg
+ * \brief Suggests the word that the OCR pair str1, str2 most likely stands for, by applying the confusions found between them to str1
+ * \details Every subset of the confusions is a candidate; the candidate split into the fewest samAsa parts wins, and among those the one
+ * applying the later confusions, i.e. the one with the largest subset mask. A candidate must not have more parts than str1 itself.
+ * If there are at most suggestionBudget subsets they are all tried, largest mask first, stopping early once a candidate has one part.
+ * Otherwise a beam search grows subsets one confusion at a time, keeping the suggestionBeamWidth subsets with the fewest parts (ties: most
+ * frequent confusions in ConfPmap) at every size, until suggestionBudget candidates have been segmented.
+ * Subsets are bit masks, so a pair with more than MAX_WORD_CONFUSIONS confusions keeps the MAX_WORD_CONFUSIONS most frequent ones in
+ * ConfPmap (the earlier one on a tie) and drops the rest; the kept ones stay in their order in the word.
  * \param str1
  * \param str2
  * \param ConfPmap
  * \param Dict
  * \return
  */
-string slpNPatternDict::print2OCRSugg(string str1, string str2, map<string,int>& ConfPmap,map<string,int>& Dict){//,map<string,int> SmasWords
+string slpNPatternDict::print2OCRSugg(string str1, string str2, const Lexicon& ConfPmap,const Lexicon& Dict){//,map<string,int> SmasWords
 
     //cout << "generating Pair Sugg for "<<str1<< " ";//<<"suggestion for " << endl
     if((str2 == "") || (str2 == " ") || (str2 == "  ")) {/*cout << "no suggestion" << endl;*/ return "";}
     string partsLR,partsRL;
     string twoOCRsugg = str1;
-    bool FlagLR,Flag1stSuggGenerated; Flag1stSuggGenerated =1; //Flag1stSuggGenerated :- if cnt 8 for str1 and <=8 for a suggestion then look for cnt <8 hence forth
-    size_t str1cnt = minsize_t(cntSamas(SamasLR(toslp1(str1),Dict),partsLR), cntSamas(SamasRL(toslp1(str1),Dict),partsRL),FlagLR);//,SmasWords,SmasWords
+    //! the subsets below share most of their splits, and earlier suggestions many more
+    SamasSegmenter& segmenter = SamasSegmenter::of(Dict);
+    bool FlagLR;
+    size_t str1cnt = segmenter.parts(toslp1(str1),FlagLR);
     vector<string> wordConfusions; vector<int> wCindex;
     string str1New = loadWConfusionsNindex(str1,str2,ConfPmap,wordConfusions,wCindex);
     //cout << str1New << endl; printvecint(wCindex); printvecstr(wordConfusions);
@@ -1765,31 +1691,85 @@ string slpNPatternDict::print2OCRSugg(string str1, string str2, map<string,int>&
     // lcs can give index of confusions say left are 3 6 9
     // we need to try 3 6 9, 3 6, 6 9 ,3 9, 3 , 6 ,9 if any dec no of parts through min(samasLR,samasRL) stop and give suggestion
     //cout << str1New << endl;
-    size_t sz = wordConfusions.size(); //cout << sz<< endl;
-    size_t max = pow(2,sz) - 1;
-
-    for(size_t i =max; i > 0; i--){
-        size_t mask = pow(2,sz-1);
-        string newstring = str1New;
-        for(size_t j =sz; j > 0; j--){
-            //generate new string using mask say 101 i.e. 210 :-
-            if((mask & i) != 0){ replacestrcnf(newstring,wCindex[log2(mask)],wordConfusions[log2(mask)]);}   mask = mask >> 1 ; }
-        string newstring1 = removeSpaces(newstring.substr(1,newstring.size()-2));
+    if(wordConfusions.empty()) return twoOCRsugg;
+    if(wordConfusions.size() > MAX_WORD_CONFUSIONS){
+        //! drop the least frequent confusions, the ones least likely to be the OCR error
+        vector<size_t> order(wordConfusions.size());
+        for(size_t k = 0; k < order.size(); k++) order[k] = k;
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return ConfPmap.count(wordConfusions[a]) > ConfPmap.count(wordConfusions[b]); });
+        order.resize(MAX_WORD_CONFUSIONS);
+        sort(order.begin(), order.end());
+        vector<string> keptConfusions; vector<int> keptIndex;
+        for(size_t k : order) { keptConfusions.push_back(wordConfusions[k]); keptIndex.push_back(wCindex[k]); }
+        wordConfusions.swap(keptConfusions); wCindex.swap(keptIndex);
+    }
+    size_t sz = wordConfusions.size();
+
+    //! parts of the candidate of a subset, segmented once
+    unordered_map<uint64_t, size_t> parts;
+    auto evaluate = [&](uint64_t mask) -> size_t {
+        unordered_map<uint64_t, size_t>::const_iterator it = parts.find(mask);
+        if(it != parts.end()) return it->second;
+        string newstring1 = applyConfusions(str1New, mask, wordConfusions, wCindex);
         size_t cntSamasNew;
-        if(FlagLR) cntSamasNew = cntSamas(SamasRL(newstring1,Dict),partsRL); // ,SmasWords
-        else cntSamasNew = cntSamas(SamasLR(newstring1,Dict),partsLR); // ,SmasWords
-
-        //cout << cntSamasNew <<" "<< str1cnt<< endl;
-        //Flag1stSuggGenerated :- if cnt 8 for str1 and <=8 for a suggestion then look for cnt <8 hence forth
-        if(Flag1stSuggGenerated){if(cntSamasNew <= str1cnt) {twoOCRsugg = (newstring1); str1cnt = cntSamasNew; Flag1stSuggGenerated = 0;}}
-        else {if(cntSamasNew < str1cnt) {twoOCRsugg = (newstring1); str1cnt = cntSamasNew;}}
-
+        if(FlagLR) cntSamasNew = cntSamas(segmenter.segmentRL(newstring1),partsRL);
+        else cntSamasNew = cntSamas(segmenter.segmentLR(newstring1),partsLR);
+        parts[mask] = cntSamasNew;
+        return cntSamasNew;
+    };
+
+    //! best subset so far: fewest parts, then largest mask
+    uint64_t bestMask = 0; size_t bestCnt = str1cnt + 1;
+    auto consider = [&](uint64_t mask, size_t cnt) {
+        if(cnt < bestCnt || (cnt == bestCnt && mask > bestMask)) { bestCnt = cnt; bestMask = mask; }
+    };
+
+    uint64_t max = ((uint64_t)1 << sz) - 1;
+    if(max <= suggestionBudget){
+        //! a non empty word has at least one part, and only confusions removing as many letters as the word has can empty it
+        size_t letters = 0, removable = 0;
+        for(size_t t = 1; t + 1 < str1New.size(); t++) if(str1New[t] != ' ') letters++;
+        for(size_t k = 0; k < sz; k++){ istringstream s(wordConfusions[k]); string lhs,rhs; s>>lhs; s>>rhs; if(lhs.size() > rhs.size()) removable += lhs.size() - rhs.size(); }
+        size_t floorCnt = removable >= letters ? 0 : 1;
+
+        for(uint64_t i = max; i > 0; i--){
+            consider(i, evaluate(i));
+            if(bestCnt <= floorCnt) break; // nothing later can have fewer parts, and ties keep the larger mask
+        }
     }
+    else {
+        vector<int> freq(sz);
+        for(size_t k = 0; k < sz; k++) freq[k] = ConfPmap.count(wordConfusions[k]);
+        struct State { uint64_t mask; size_t cnt; long long freq; };
+        auto better = [](const State& a, const State& b) -> bool {
+            if(a.cnt != b.cnt) return a.cnt < b.cnt;
+            if(a.freq != b.freq) return a.freq > b.freq;
+            return a.mask > b.mask;
+        };
+
+        consider(max, evaluate(max));  // all the confusions first, as the exhaustive order does
+        vector<State> beam(1, State{0, str1cnt, 0});
+        set<uint64_t> seen;
+        for(size_t level = 1; level <= sz && parts.size() < suggestionBudget && !beam.empty(); level++){
+            vector<State> next;
+            for(const State& st : beam){
+                for(size_t k = 0; k < sz && parts.size() < suggestionBudget; k++){
+                    uint64_t bit = (uint64_t)1 << k;
+                    if((st.mask & bit) || !seen.insert(st.mask | bit).second) continue;
+                    State child{st.mask | bit, evaluate(st.mask | bit), st.freq + freq[k]};
+                    consider(child.mask, child.cnt);
+                    next.push_back(child);
+                }
+            }
+            sort(next.begin(), next.end(), better);
+            if(next.size() > suggestionBeamWidth) next.resize(suggestionBeamWidth);
+            beam.swap(next);
+        }
+    }
+
+    if(bestCnt <= str1cnt) twoOCRsugg = applyConfusions(str1New, bestMask, wordConfusions, wCindex);
     //cout << toDev(twoOCRsugg)<<endl;
-    wordConfusions.clear();
-    wCindex.clear();
     return twoOCRsugg;
-    //break;
 }
 
 /*!
@@ -1799,19 +1779,12 @@ string slpNPatternDict::print2OCRSugg(string str1, string str2, map<string,int>&
  * \param m1
  * \return
  */
-string slpNPatternDict::bestIG(string s1,string s2,map<string, int>& m1){
+string slpNPatternDict::bestIG(string s1,string s2,const Lexicon& m1){
     string s11 = s1; string s21 = s2;
     s1 = toslp1(s1); s2=toslp1(s2);
-    string RL1 = SamasRL(s1,m1); string RLout1;
-    size_t cRL1 = cntSamas(RL1,RLout1);
-    string RL2 = SamasRL(s2,m1); string RLout2;
-    size_t cRL2 = cntSamas(RL2,RLout2);
-    string LR1 = SamasLR(s1,m1); string LRout1;
-    size_t cLR1 = cntSamas(LR1,LRout1);
-    string LR2 = SamasLR(s2,m1); string LRout2;
-    size_t cLR2 = cntSamas(LR2,LRout2);
+    SamasSegmenter& segmenter = SamasSegmenter::of(m1);
     bool lolz;
-    if(minsize_t(cRL1,cLR1,lolz) < minsize_t(cRL2,cLR2,lolz)) return s11; else return s21;
+    if(segmenter.parts(s1,lolz) < segmenter.parts(s2,lolz)) return s11; else return s21;
 
 }
 
@@ -1851,16 +1824,18 @@ void slpNPatternDict::printSandhiRUles(map<string,vector<string> >& SRules){
  * \param Dict
  * \return
  */
-bool slpNPatternDict::SamasCheck(string OCRNew, map<string, int>& Dict){
+bool slpNPatternDict::SamasCheck(string OCRNew, const Lexicon& Dict){
     if (OCRNew == "") return 1;
-    if (Dict[OCRNew] > 0) return 1;
+    if (Dict.count(OCRNew) > 0) return 1;
     //cout << endl<< "heres " << OCRNew << endl;
     size_t sz = OCRNew.size();
 
-    for(size_t ts = sz ; ts > 0; ts--){// Bapyopetam Bapy 0 4 10
-        string s1 = OCRNew.substr(0,ts); string rem = OCRNew.substr(ts,sz-ts);
+    //! all the prefixes are looked up in one pass, longer prefixes than the longest word cannot match
+    vector<int> counts;
+    Dict.prefixCounts(OCRNew.data(), sz, counts);
+    for(size_t ts = counts.size() ; ts > 0; ts--){// Bapyopetam Bapy 0 4 10
         //cout << "s1 " << s1 << " rem " << rem << endl;
-        if((Dict[s1] > 0) &&(s1.size() >3) &&(rem.size() >3))/*try && rem.size >3*/ return SamasCheck(rem,Dict); // apply ending with a to aH, ending with consonants say c to ca etc // if not 1st leftstarting with a to remove a
+        if((counts[ts-1] > 0) &&(ts >3) &&(sz-ts >3))/*try && rem.size >3*/ return SamasCheck(OCRNew.substr(ts,sz-ts),Dict); // apply ending with a to aH, ending with consonants say c to ca etc // if not 1st leftstarting with a to remove a
     }
     return 0;
 }
@@ -1872,10 +1847,10 @@ bool slpNPatternDict::SamasCheck(string OCRNew, map<string, int>& Dict){
  * \param SRules
  * \return
  */
-bool slpNPatternDict::SandhiCheck(string OCRNew, map<string, int>& Dict,map<string, vector<string>>& SRules){
+bool slpNPatternDict::SandhiCheck(string OCRNew, const Lexicon& Dict,map<string, vector<string>>& SRules){
     // Sandhi Check
     //if (OCRNew == "") return 1;
-    if (Dict[OCRNew] > 0) return 1;
+    if (Dict.count(OCRNew) > 0) return 1;
     //cout << endl<< "hereS " << OCRNew << endl;
     size_t sz = OCRNew.size();
     for(size_t ts = sz ; ts > 0; ts--){// Bapyopetam Bapy 0 4 10
@@ -1894,7 +1869,7 @@ bool slpNPatternDict::SandhiCheck(string OCRNew, map<string, int>& Dict,map<stri
                 for(size_t vt =0; vt < vsz; vt++) {
                     istringstream s(v[vt]); string l,r; s>>l; s>>r;
                     string s1new = s1.substr(0,s1.size()-1)+l;
-                    if((Dict[s1new] > 0) ){
+                    if((Dict.count(s1new) > 0) ){
                         //cout << "found " << s1new << endl;
                         SandhiFlag = (SandhiFlag | SamasCheck(r+rem,Dict));
                     } else { SandhiFlag = (SandhiFlag | (SandhiCheck(s1new,Dict,SRules) & SamasCheck(r+rem,Dict)) | (SamasCheck(s1new,Dict) & SamasCheck(r+rem,Dict)));} //else
@@ -1919,7 +1894,7 @@ bool slpNPatternDict::SandhiCheck(string OCRNew, map<string, int>& Dict,map<stri
  * \param SRules
  * \return
  */
-string slpNPatternDict::generatePossibilitesNsuggest(string OCRWord,map<string,string>& TopConfusions,map<string,int>& TopConfusionsMask,map<string, int>& Dict, map<string, vector<string>>& SRules){
+string slpNPatternDict::generatePossibilitesNsuggest(string OCRWord,map<string,string>& TopConfusions,const Lexicon& TopConfusionsMask,const Lexicon& Dict, map<string, vector<string>>& SRules){
     string OCRWordOrig = OCRWord;
     size_t sz = OCRWord.size() + 2;
     // one confusion one sandhi at a time
@@ -1931,7 +1906,7 @@ string slpNPatternDict::generatePossibilitesNsuggest(string OCRWord,map<string,s
             string OCRNew = OCRWord;
             //cout << "OCRWord " << OCRWord << endl;
             size_t tc = t; while( tc < sz - t2 + 1) {  string s1 = OCRWord.substr(tc,t2); //cout << s1<< " "<< tc << " " << t2 << endl;
-                if (TopConfusionsMask[s1] > 0) { OCRNew = OCRWord;  OCRNew.replace(tc,s1.size(),TopConfusions[s1]);  t = tc; break; } else tc++; }
+                if (TopConfusionsMask.count(s1) > 0) { OCRNew = OCRWord;  OCRNew.replace(tc,s1.size(),TopConfusions[s1]);  t = tc; break; } else tc++; }
             //cout << "OCRWord1 " << OCRNew << endl;
             // apply Samas s
             OCRNew = OCRNew.substr(0,OCRNew.size()-1); OCRNew = OCRNew.substr(1,OCRNew.size()-1);
@@ -16,6 +16,8 @@
 #include <unordered_map>
 #include <QFile>
 #include "eddis.h"
+#include "lexicon.h"
+#include "correctionpairs.h"
 //#include <boost/serialization/map.hpp>
 //#include <boost/serialization/vector.hpp>
 //#include <boost/serialization/serialization.hpp>
@@ -29,6 +31,10 @@ class slpNPatternDict{
 public:
     //variables
     bool HinFlag = 0, SanFlag = 1;
+    //! print2OCRSugg: most confusion subsets segmented per word, and subsets kept per size once there are more than that
+    size_t suggestionBudget = 4096, suggestionBeamWidth = 16;
+    //! print2OCRSugg: a subset of the confusions of a word is a 64 bit mask, so at most this many confusions are tried
+    static const size_t MAX_WORD_CONFUSIONS = 63;
 
     //functions
 
@@ -50,37 +56,40 @@ public:
 
     void printmapWFreq(map<string,int>& m1);
 
-    void loadCwordsPair(string wordL,string wordR, map<string, string>& CPair,map<string,int>& Dict,map<string,int>&  PWords);
+    void loadCwordsPair(string wordL,string wordR, map<string, string>& CPair,const Lexicon& Dict,const Lexicon&  PWords);
 
-    void loadCPair(string filename, map<string, string>& CPair,map<string,int>&  Dict, map<string,int>&  PWords);
+    void loadCPair(string filename, map<string, string>& CPair,const Lexicon&  Dict, const Lexicon&  PWords);
 
-    void loadCwordsPairs(string wordL,string wordR, map<string, set<string> >& CPairs,map<string,int>& Dict,map<string,int>&  PWords);
+    void loadCwordsPairs(string wordL,string wordR, CorrectionPairs& CPairs,const Lexicon& Dict,const Lexicon&  PWords);
 
-    void loadCPairs(string filename, map<string, set<string> >& CPairs,map<string,int>&  Dict, map<string,int>&  PWords);
+    void loadCPairs(string filename, CorrectionPairs& CPairs,const Lexicon&  Dict, const Lexicon&  PWords);
 
-    void loadMapNV(string fileName, map<string,int>& OCRWords, vector<string>& vec, string GBook);
+    void loadMapNV(string fileName, Lexicon& OCRWords, vector<string>& vec, string GBook);
 
     int minIG(int a, int b);
 
     int maxIG(int a, int b);
 
-    void loadMapPWords(vector<string>& vGBook,vector<string>& vIBook, map<string,int>& PWords);
+    void loadMapPWords(vector<string>& vGBook,vector<string>& vIBook, Lexicon& PWords);
 
-    string findDictEntries1(string s1,  map<string, int>& m2, map<string, int>& m1, int size);
+    string findDictEntries1(string s1,  const Lexicon& m2, const Lexicon& m1, int size);
 
-    string findDictEntries(string s1,  map<string, int>& m2, map<string, int>& m1, int size);
+    string findDictEntries(string s1,  Lexicon& m2, const Lexicon& m1, int size);
+
+    //! The parts findDictEntries1 colors, without building html: (length, found in m2 or m1) in order from the start of s1
+    void findDictEntryParts(const string& s1, const Lexicon& m2, const Lexicon& m1, vector<pair<size_t, bool> >& parts);
 
     bool hasM40PerAsci(string word1);
 
     bool hasNoAsci(string word1);
 
-    void loadMap(string fileName, map<string,int>& OCRWords, string GBook);
+    void loadMap(string fileName, Lexicon& OCRWords, string GBook);
 
     bool insertPatternstoMap(string str, map<string,int>& TPWordsP, size_t& count ,size_t& count6);
 
-    size_t loadDictPatternstoMap(map<string,int >& TPWordsP, map<string,int >& PWords,size_t& count6);
+    size_t loadDictPatternstoMap(map<string,int >& TPWordsP, const Lexicon& PWords,size_t& count6);
 
-    bool getNgramFeaturesinVect(string str,map<string,int>& Dict,vector<bool>& vb,vector<size_t>& vbf, size_t& count);
+    bool getNgramFeaturesinVect(string str,const Lexicon& Dict,vector<bool>& vb,vector<size_t>& vbf, size_t& count);
 
     bool endsWith(const std::string& s, const std::string& suffix);
 
@@ -90,7 +99,7 @@ public:
 
     bool searchS1inGVec(string s1,size_t iocrdone,vector<string>& gocr,size_t winig);
 
-    string findDictEntries(string s1,  map<string, int>& m2, map<string, int>& m1);
+    string findDictEntries(string s1,  const Lexicon& m2, const Lexicon& m1);
 
     void find_and_replace(string& source, string const& find, string const& replace);
 
@@ -162,17 +171,17 @@ public:
 
     string appendConfusionsPairsNindex(string str1, string str2, vector<string>& vec, vector<int>& vecind);
 
-    void loadvectomap(vector<string> ConfP, map<string,int>& ConfPmap);
+    void loadvectomap(vector<string> ConfP, Lexicon& ConfPmap);
 
     void printvecstr(vector<string> ConfP);
 
     void printvecint(vector<int> ConfP);
 
-    void loadConfusions(string fileName,map<string,int>& ConfPmap);
+    void loadConfusions(string fileName,Lexicon& ConfPmap);
 
-    void loadConfusions2(string fileName1,string fileName2,map<string,int>& ConfPmap);
+    void loadConfusions2(string fileName1,string fileName2,Lexicon& ConfPmap);
 
-    void loadConfusionsFont(vector<string> fileName1,vector<string> fileName2,map<string,int>& ConfPmap);
+    void loadConfusionsFont(vector<string> fileName1,vector<string> fileName2,Lexicon& ConfPmap);
 
     void generateCorrectionPairs(vector<string> &wrong,vector<string> &right,string localFilenameI,string localFilenameC);
 
@@ -184,15 +193,15 @@ public:
 
     void loadCPair(string fileName1,string fileName2,map<string,string>& CPair);
 
-    void loadTopConfusions(map<string,int>& ConfPmap,map<string, string>& TopConfusions,map<string, int>& TopConfusionsMask);
+    void loadTopConfusions(const Lexicon& ConfPmap,map<string, string>& TopConfusions,Lexicon& TopConfusionsMask);
 
     std::string tokenize(const std::string& s);
 
-    void printConfusionRulesmap(map<string,int>& ConfPmap);
+    void printConfusionRulesmap(const Lexicon& ConfPmap);
 
-    int loadWConfusionsNindex1(string str1,string str2,map<string,int>& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex);
+    int loadWConfusionsNindex1(string str1,string str2,const Lexicon& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex);
 
-    string loadWConfusionsNindex(string str1,string str2,map<string,int>& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex);
+    string loadWConfusionsNindex(string str1,string str2,const Lexicon& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex);
 
     void replacestrcnf(string& newstring,size_t i,string cnfn);
 
@@ -204,28 +213,30 @@ public:
 
     size_t cntSamas(string in, string& out);
 
-    string SamasLR(string s1, map<string, int>& m1);
+    string SamasLR(string s1, const Lexicon& m1);
 
-    string SamasRL(string s1, map<string, int>& m1);
+    string SamasRL(string s1, const Lexicon& m1);
 
     size_t minsize_t(size_t a,size_t b,bool& FlagLR);
 
-    string print2OCRSugg(string str1, string str2, map<string,int>& ConfPmap,map<string,int>& Dict);
+    string applyConfusions(const string& str1New, uint64_t mask, const vector<string>& wordConfusions, const vector<int>& wCindex);
+
+    string print2OCRSugg(string str1, string str2, const Lexicon& ConfPmap,const Lexicon& Dict);
 
-    string bestIG(string s1,string s2,map<string, int>& m1);
+    string bestIG(string s1,string s2,const Lexicon& m1);
 
     void loadSandhiRules(string fileName, map<string, vector<string>>& SRules);
 
     void printSandhiRUles(map<string,vector<string> >& SRules);
 
-    bool SamasCheck(string OCRNew, map<string, int>& Dict);
+    bool SamasCheck(string OCRNew, const Lexicon& Dict);
 
-    bool SandhiCheck(string OCRNew, map<string, int>& Dict,map<string, vector<string>>& SRules);
+    bool SandhiCheck(string OCRNew, const Lexicon& Dict,map<string, vector<string>>& SRules);
 
     //Sandhi rules
 
     // OCR Word = BApyopetam
-    string generatePossibilitesNsuggest(string OCRWord,map<string,string>& TopConfusions,map<string,int>& TopConfusionsMask,map<string, int>& Dict, map<string, vector<string>>& SRules);
+    string generatePossibilitesNsuggest(string OCRWord,map<string,string>& TopConfusions,const Lexicon& TopConfusionsMask,const Lexicon& Dict, map<string, vector<string>>& SRules);
 
 };
 
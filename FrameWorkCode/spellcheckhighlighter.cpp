@@ -0,0 +1,182 @@
+/*!
+ * \class SpellCheckHighlighter
+ * \brief Colours the words of a page by their spell check class, classifying them in the background
+ */
+#include "spellcheckhighlighter.h"
+#include "suggestionservice.h"
+#include "wordmatcher.h"
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTimer>
+
+//! words classified by one task
+static const int BATCH_SIZE = 256;
+
+/*!
+ * \brief State shared with the tasks, which may finish after the highlighter was deleted with its page
+ */
+struct SpellCheckHighlighter::Shared {
+    QMutex mutex;
+    SpellCheckHighlighter *owner;
+    int generation = 0;     // raised by recheck(), results of the tasks started before are dropped
+    QList<QPair<QString, SpellCheckHighlighter::Marks> > results;
+};
+
+/*!
+ * \class SpellCheckTask
+ * \brief Classifies a batch of words on the global thread pool and hands the results to the highlighter
+ */
+class SpellCheckTask : public QRunnable
+{
+public:
+    SpellCheckTask(std::shared_ptr<SpellCheckHighlighter::Shared> shared, SpellCheckHighlighter::Classify classify, const QStringList &words, int generation)
+        : shared(shared), classify(classify), words(words), generation(generation) {}
+
+    void run() override
+    {
+        QList<QPair<QString, SpellCheckHighlighter::Marks> > out;
+        {
+            QReadLocker locker(&suggestionDataLock);
+            for (const QString &w : words)
+                out.append(qMakePair(w, classify(w)));
+        }
+        QMutexLocker locker(&shared->mutex);
+        if (!shared->owner || shared->generation != generation)
+            return;
+        shared->results += out;
+        QMetaObject::invokeMethod(shared->owner, "takeResults", Qt::QueuedConnection);
+    }
+
+private:
+    std::shared_ptr<SpellCheckHighlighter::Shared> shared;
+    SpellCheckHighlighter::Classify classify;
+    QStringList words;
+    int generation;
+};
+
+/*!
+ * \fn SpellCheckHighlighter::SpellCheckHighlighter
+ * \param document the highlighter is deleted with it
+ * \param classify spell check class of a word; it is called with suggestionDataLock held for reading
+ */
+SpellCheckHighlighter::SpellCheckHighlighter(QTextDocument *document, Classify classify)
+    : QSyntaxHighlighter(document), classify(classify), shared(std::make_shared<Shared>())
+{
+    shared->owner = this;
+}
+
+/*!
+ * \fn SpellCheckHighlighter::~SpellCheckHighlighter
+ */
+SpellCheckHighlighter::~SpellCheckHighlighter()
+{
+    QMutexLocker locker(&shared->mutex);
+    shared->owner = nullptr;
+}
+
+/*!
+ * \fn SpellCheckHighlighter::recheck
+ * \brief Forgets the classified words and the words being classified, whose results would be the old ones
+ */
+void SpellCheckHighlighter::recheck()
+{
+    {
+        QMutexLocker locker(&shared->mutex);
+        shared->generation++;
+        shared->results.clear();
+    }
+    marks.clear();
+    queued.clear();
+    missing.clear();
+    waiting.clear();
+    rehighlight();
+}
+
+/*!
+ * \fn SpellCheckHighlighter::highlightBlock
+ * \brief Colours the classified words of the block and queues the others
+ * \details Words that are mostly latin letters or digits are classified too, the classify function leaves them
+ * uncoloured (hasM40PerAsci()), so a Devanagari word with a stray latin character is still checked.
+ * \param text
+ */
+void SpellCheckHighlighter::highlightBlock(const QString &text)
+{
+    bool complete = true;
+    int n = text.size();
+    for (int i = 0; i < n; ) {
+        if (!WordMatcher::isWordChar(text.at(i))) { i++; continue; }
+        int start = i;
+        while (i < n && WordMatcher::isWordChar(text.at(i)))
+            i++;
+
+        QString word = text.mid(start, i - start);
+        QHash<QString, Marks>::const_iterator it = marks.constFind(word);
+        if (it == marks.constEnd()) {
+            complete = false;
+            if (!queued.contains(word)) {
+                queued.insert(word);
+                missing.append(word);
+            }
+            continue;
+        }
+        for (const Span &s : it->spans)
+            setFormat(start + s.start, s.length, s.color);
+    }
+    if (complete)
+        return;
+    waiting.insert(currentBlock());
+    if (!classifyQueued) {
+        //! a rehighlight visits every block, classify all their words once it is over
+        classifyQueued = true;
+        QTimer::singleShot(0, this, SLOT(classifyMissing()));
+    }
+}
+
+/*!
+ * \fn SpellCheckHighlighter::classifyMissing
+ * \brief Starts one task per batch of the queued words
+ */
+void SpellCheckHighlighter::classifyMissing()
+{
+    classifyQueued = false;
+    int generation;
+    {
+        QMutexLocker locker(&shared->mutex);
+        generation = shared->generation;
+    }
+    for (int i = 0; i < missing.size(); i += BATCH_SIZE)
+        QThreadPool::globalInstance()->start(new SpellCheckTask(shared, classify, missing.mid(i, BATCH_SIZE), generation));
+    missing.clear();
+}
+
+/*!
+ * \fn SpellCheckHighlighter::takeResults
+ * \brief Keeps the classified words, and colours the waiting blocks again once no word is left to classify
+ */
+void SpellCheckHighlighter::takeResults()
+{
+    QList<QPair<QString, Marks> > results;
+    {
+        QMutexLocker locker(&shared->mutex);
+        results.swap(shared->results);
+    }
+    QStringList pwords;
+    for (const QPair<QString, Marks> &r : results) {
+        marks.insert(r.first, r.second);
+        queued.remove(r.first);
+        if (!r.second.pword.empty())
+            pwords.append(QString::fromStdString(r.second.pword));
+    }
+    if (!pwords.isEmpty())
+        emit foundPWords(pwords);
+    if (!queued.isEmpty())
+        return;
+
+    QSet<QTextBlock> blocks;
+    blocks.swap(waiting);
+    for (const QTextBlock &block : blocks)
+        if (block.isValid())
+            rehighlightBlock(block);
+}
@@ -0,0 +1,79 @@
+#ifndef SPELLCHECKHIGHLIGHTER_H
+#define SPELLCHECKHIGHLIGHTER_H
+
+#include <QSyntaxHighlighter>
+#include <QTextBlock>
+#include <QColor>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QStringList>
+#include <functional>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+//! QTextBlock::operator== compares the fragment index of the blocks, so it identifies a block as long as it exists
+inline uint qHash(const QTextBlock &block, uint seed = 0)
+{
+    return qHash(block.fragmentIndex(), seed);
+}
+
+/*
+ * Spell check colouring of a page as formats of the layout, the document text
+ * and its html are not changed.
+ * Words are classified by the function given to the constructor on the global
+ * thread pool, in batches, and the results are kept per word; a block is
+ * coloured from those results and is queued for the words it is missing. As a
+ * QSyntaxHighlighter it is asked again only for the blocks that changed after
+ * an edit, so only their new words are classified.
+ */
+class SpellCheckHighlighter : public QSyntaxHighlighter
+{
+    Q_OBJECT
+public:
+    struct Span {
+        int start;      // in the word
+        int length;
+        QColor color;
+    };
+
+    struct Marks {
+        QVector<Span> spans;
+        string pword;   // SLP1 word to add to PWords, for the words of the secondary OCR
+    };
+
+    typedef std::function<Marks(const QString&)> Classify;
+
+    SpellCheckHighlighter(QTextDocument *document, Classify classify);
+    ~SpellCheckHighlighter();
+
+    //! Forgets the classified words and checks the whole page again, e.g. after the dictionaries were loaded
+    void recheck();
+
+signals:
+    //! Words of the secondary OCR met on the page, to be added to PWords
+    void foundPWords(const QStringList &words);
+
+protected:
+    void highlightBlock(const QString &text) override;
+
+private slots:
+    void classifyMissing();
+    void takeResults();
+
+private:
+    struct Shared;
+    friend class SpellCheckTask;
+
+    Classify classify;
+    std::shared_ptr<Shared> shared;
+    QHash<QString, Marks> marks;
+    QSet<QString> queued;
+    QStringList missing;
+    QSet<QTextBlock> waiting;       // blocks coloured before all their words were classified
+    bool classifyQueued = false;
+};
+
+#endif // SPELLCHECKHIGHLIGHTER_H
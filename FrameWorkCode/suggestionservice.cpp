@@ -0,0 +1,172 @@
+/*!
+ * \class SuggestionService
+ * \brief Computes the right click suggestions of a page in the background and caches them per word
+ */
+#include "suggestionservice.h"
+#include <QRunnable>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QThread>
+
+QReadWriteLock suggestionDataLock;
+
+/*!
+ * \class SuggestionTask
+ * \brief Computes the suggestions of one word on the SuggestionService thread pool
+ */
+class SuggestionTask : public QRunnable
+{
+public:
+    SuggestionTask(SuggestionService *service, const string &word, int gen)
+        : service(service), word(word), gen(gen) {}
+
+    void run() override
+    {
+        service->run(word, gen);
+    }
+
+private:
+    SuggestionService *service;
+    string word;
+    int gen;
+};
+
+/*!
+ * \fn SuggestionService::SuggestionService
+ * \brief One thread is left to the GUI, so that typing stays responsive while a page is being processed
+ * \param compute ranks the suggestions of a word; it is called with suggestionDataLock held for reading
+ * \param capacity number of words kept in the cache
+ */
+SuggestionService::SuggestionService(Compute compute, size_t capacity)
+    : compute(compute), capacity(capacity)
+{
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+/*!
+ * \fn SuggestionService::~SuggestionService
+ */
+SuggestionService::~SuggestionService()
+{
+    cancel();
+}
+
+/*!
+ * \fn SuggestionService::request
+ * \param words
+ */
+void SuggestionService::request(const vector<string>& words)
+{
+    int gen = generation.load();
+    QMutexLocker locker(&mutex);
+    for (const string& w : words) {
+        if (w.empty() || cache.count(w) > 0 || !pending.insert(w).second)
+            continue;
+        pool.start(new SuggestionTask(this, w, gen));
+    }
+}
+
+/*!
+ * \fn SuggestionService::lookup
+ * \param word
+ * \param out
+ * \return true if the suggestions of word were cached
+ */
+bool SuggestionService::lookup(const string& word, Suggestions& out)
+{
+    QMutexLocker locker(&mutex);
+    auto it = cache.find(word);
+    if (it == cache.end())
+        return false;
+    order.splice(order.begin(), order, it->second.second);
+    out = it->second.first;
+    return true;
+}
+
+/*!
+ * \fn SuggestionService::insert
+ * \param word
+ * \param suggestions
+ */
+void SuggestionService::insert(const string& word, const Suggestions& suggestions)
+{
+    QMutexLocker locker(&mutex);
+    store(word, suggestions);
+}
+
+/*!
+ * \fn SuggestionService::invalidate
+ * \param word
+ */
+void SuggestionService::invalidate(const string& word)
+{
+    QMutexLocker locker(&mutex);
+    auto it = cache.find(word);
+    if (it != cache.end()) {
+        order.erase(it->second.second);
+        cache.erase(it);
+    }
+    if (pending.count(word) > 0)
+        stale.insert(word);
+}
+
+/*!
+ * \fn SuggestionService::cancel
+ * \brief Drops the queued words, waits for the running ones and empties the cache
+ */
+void SuggestionService::cancel()
+{
+    generation.ref();
+    pool.clear();
+    pool.waitForDone();
+    QMutexLocker locker(&mutex);
+    pending.clear();
+    stale.clear();
+    cache.clear();
+    order.clear();
+}
+
+/*!
+ * \fn SuggestionService::run
+ * \brief Computes the suggestions of word unless the service was cancelled since it was queued
+ * \param word
+ * \param gen generation the word was queued in
+ */
+void SuggestionService::run(const string& word, int gen)
+{
+    Suggestions suggestions;
+    bool computed = false;
+    if (gen == generation.load()) {
+        QReadLocker locker(&suggestionDataLock);
+        suggestions = compute(word);
+        computed = true;
+    }
+
+    QMutexLocker locker(&mutex);
+    pending.erase(word);
+    if (stale.erase(word) > 0 || !computed || gen != generation.load())
+        return;
+    store(word, suggestions);
+}
+
+/*!
+ * \fn SuggestionService::store
+ * \brief Caches suggestions of word as the most recently used entry, evicting the least recently used ones; mutex is held
+ * \param word
+ * \param suggestions
+ */
+void SuggestionService::store(const string& word, const Suggestions& suggestions)
+{
+    auto it = cache.find(word);
+    if (it != cache.end()) {
+        it->second.first = suggestions;
+        order.splice(order.begin(), order, it->second.second);
+        return;
+    }
+    order.push_front(word);
+    cache[word] = make_pair(suggestions, order.begin());
+    while (cache.size() > capacity) {
+        cache.erase(order.back());
+        order.pop_back();
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef SUGGESTIONSERVICE_H
+#define SUGGESTIONSERVICE_H
+
+#include <QThreadPool>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QAtomicInt>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+//! Held for reading while suggestions are computed, and for writing wherever Dict, PWords, CPair or CPairs change
+extern QReadWriteLock suggestionDataLock;
+
+/*
+ * Right click suggestions of the words of the open page, computed ahead of time.
+ * When a page is loaded its unknown words are handed to request(), which ranks
+ * them on a small thread pool and keeps the results in a least recently used
+ * cache shared by all pages, so the context menu usually only does lookup().
+ * A word whose result changes (a suggestion was picked, the word was added to
+ * PWords or CPairs) is dropped with invalidate(); a result still being computed
+ * for it is thrown away when it arrives.
+ * cancel() stops the pending work and empties the cache; it has to be called
+ * before the data the suggestions are computed from is cleared or reloaded.
+ */
+class SuggestionService
+{
+public:
+    struct Suggestions {
+        bool aligned = false;       // a secondary OCR entry was aligned with the word, i.e. the suggestion menu is shown
+        vector<string> words;       // SLP1, best first
+    };
+
+    typedef std::function<Suggestions(const string&)> Compute;
+
+    explicit SuggestionService(Compute compute, size_t capacity = 4096);
+    ~SuggestionService();
+
+    //! Queues the words that are neither cached nor queued yet
+    void request(const vector<string>& words);
+
+    bool lookup(const string& word, Suggestions& out);
+
+    //! Caches a result computed outside of the pool, e.g. on a cache miss in the context menu
+    void insert(const string& word, const Suggestions& suggestions);
+
+    void invalidate(const string& word);
+
+    void cancel();
+
+private:
+    friend class SuggestionTask;
+
+    Compute compute;
+    size_t capacity;
+    QThreadPool pool;
+    QAtomicInt generation;
+
+    QMutex mutex;
+    list<string> order;     // most recently used first
+    unordered_map<string, pair<Suggestions, list<string>::iterator> > cache;
+    unordered_set<string> pending;
+    unordered_set<string> stale;    // invalidated while pending
+
+    void run(const string& word, int gen);
+    void store(const string& word, const Suggestions& suggestions);
+};
+
+#endif // SUGGESTIONSERVICE_H
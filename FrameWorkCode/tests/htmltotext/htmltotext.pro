@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# HtmlToText against QTextDocument::setHtml() + toPlainText()
+#
+#-------------------------------------------------
+
+QT += core gui testlib
+QT -= widgets
+
+TARGET = tst_htmltotext
+TEMPLATE = app
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../..
+
+HEADERS += $$PWD/../../htmltotext.h
+
+SOURCES += $$PWD/../../htmltotext.cpp \
+    $$PWD/tst_htmltotext.cpp
+
+DEFINES += SAMPLE_PROJECT_DIR=\\\"$$PWD/../../../TestProject\\\"
@@ -0,0 +1,139 @@
+/*!
+ * \class TestHtmlToText
+ * \brief Compares HtmlToText::toPlainText() with QTextDocument::setHtml() + toPlainText()
+ * \details The pages of the sample project are checked as they are on disk, as QTextDocument::toHtml() writes
+ * them back when a page is saved, and fed in as plain text. Run headless with QT_QPA_PLATFORM=offscreen.
+ */
+#include "htmltotext.h"
+#include <QtTest>
+#include <QTextDocument>
+
+class TestHtmlToText : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QString reference(const QString &html);
+    static void addPages(const QString &folder, const QString &filter);
+
+private slots:
+    void samplePages_data();
+    void samplePages();
+    void savedPages_data();
+    void savedPages();
+    void plainText_data();
+    void plainText();
+    void snippets_data();
+    void snippets();
+};
+
+/*!
+ * \fn TestHtmlToText::reference
+ * \brief The text the tool got from a page before HtmlToText
+ * \param html
+ * \return QString
+ */
+QString TestHtmlToText::reference(const QString &html)
+{
+    QTextDocument doc;
+    doc.setHtml(html);
+    return doc.toPlainText();
+}
+
+/*!
+ * \fn TestHtmlToText::addPages
+ * \brief Adds a row with the contents of every file of a folder of the sample project
+ * \param folder
+ * \param filter
+ */
+void TestHtmlToText::addPages(const QString &folder, const QString &filter)
+{
+    QDir dir(QString(SAMPLE_PROJECT_DIR) + "/" + folder);
+    QStringList files = dir.entryList(QStringList(filter), QDir::Files, QDir::Name);
+    QVERIFY2(!files.isEmpty(), qPrintable("No sample pages in " + dir.absolutePath()));
+    for (const QString &name : files) {
+        QFile file(dir.filePath(name));
+        QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(file.fileName()));
+        QTest::newRow(qPrintable(folder + "/" + name)) << QString::fromUtf8(file.readAll());
+    }
+}
+
+void TestHtmlToText::samplePages_data()
+{
+    QTest::addColumn<QString>("html");
+    addPages("CorrectorOutput", "*.html");
+    addPages("VerifierOutput", "*.html");
+}
+
+void TestHtmlToText::samplePages()
+{
+    QFETCH(QString, html);
+    QCOMPARE(HtmlToText::toPlainText(html), reference(html));
+}
+
+void TestHtmlToText::savedPages_data()
+{
+    samplePages_data();
+}
+
+/*!
+ * \fn TestHtmlToText::savedPages
+ * \brief The pages as the editor writes them when they are saved
+ */
+void TestHtmlToText::savedPages()
+{
+    QFETCH(QString, html);
+    QTextDocument doc;
+    doc.setHtml(html);
+    QString saved = doc.toHtml();
+    QCOMPARE(HtmlToText::toPlainText(saved), reference(saved));
+}
+
+void TestHtmlToText::plainText_data()
+{
+    QTest::addColumn<QString>("html");
+    addPages("Inds", "*.txt");
+}
+
+/*!
+ * \fn TestHtmlToText::plainText
+ * \brief The OCR text of a page, which the diff views pass to setHtml() as it is
+ */
+void TestHtmlToText::plainText()
+{
+    QFETCH(QString, html);
+    QCOMPARE(HtmlToText::toPlainText(html), reference(html));
+}
+
+void TestHtmlToText::snippets_data()
+{
+    QTest::addColumn<QString>("html");
+
+    QTest::newRow("empty") << QString();
+    QTest::newRow("paragraphs") << "<p>one</p><p>two</p>\n<p>three</p>";
+    QTest::newRow("collapsed whitespace") << "<p>  a \n\t b  </p>  <p> c</p>";
+    QTest::newRow("line breaks") << "<p>a<br />b<br/><br>c</p>";
+    QTest::newRow("empty paragraph") << "<p style=\"-qt-paragraph-type:empty;\"><br /></p><p>a</p>";
+    QTest::newRow("pre") << "<pre>  a\n\n  b  </pre><p>c</p>";
+    QTest::newRow("pre-wrap") << "<style>p { white-space: pre-wrap; }</style><p>  a   b\n c</p>";
+    QTest::newRow("entities") << "<p>&lt;a&gt; &amp; &nbsp;&quot;&#2325;&#x915;&#150;&bogus; &amp</p>";
+    QTest::newRow("image") << "<p>a<img src=\"x.png\" />b</p>";
+    QTest::newRow("equation") << "<p>$$\\frac{a}{b}$$ c</p>";
+    QTest::newRow("lists") << "<ul><li>a</li><li><p>b</p></li></ul><ol><li>c</li></ol>";
+    QTest::newRow("table") << "<table border=\"1\"><tr><td>a</td><td>b</td></tr><tr><td></td><td>d</td></tr></table><p>e</p>";
+    QTest::newRow("table in text") << "a<table><tr><td>b</td></tr></table>c";
+    QTest::newRow("head") << "<html><head><title>t</title><style>p{}</style></head><body><p>a</p></body></html>";
+    QTest::newRow("comment") << "<p>a<!-- b <p>c</p> -->d</p>";
+    QTest::newRow("unclosed tags") << "<p>a<span>b<p>c";
+    QTest::newRow("plain text with less than") << "a < b and c > d\nx<y";
+    QTest::newRow("plain text lines") << "a\n\nb\r\nc  d\n";
+}
+
+void TestHtmlToText::snippets()
+{
+    QFETCH(QString, html);
+    QCOMPARE(HtmlToText::toPlainText(html), reference(html));
+}
+
+QTEST_MAIN(TestHtmlToText)
+#include "tst_htmltotext.moc"
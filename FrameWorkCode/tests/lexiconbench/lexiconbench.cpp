@@ -0,0 +1,141 @@
+/*!
+ * \file lexiconbench.cpp
+ * \brief Lookup throughput and memory of Lexicon against the std::map<string, int> it replaced
+ * \details Loads a word list (wordlists/hindi.txt unless one is given on the command line), converts it to SLP1
+ * like the dictionaries are, and builds both tables from it. Then it times lookups of every word, of words that
+ * are not in the table, and of all the substrings of the words as the OCR suggestion code looks them up.
+ * Heap bytes are counted by replacing the global operator new and delete.
+ */
+#include "lexicon.h"
+#include "transliterator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+
+static size_t liveBytes = 0;
+
+void* operator new(size_t n)
+{
+    //! the size is kept in front of the block so that delete can subtract it
+    size_t* p = static_cast<size_t*>(malloc(n + sizeof(max_align_t)));
+    if (!p)
+        throw bad_alloc();
+    *p = n;
+    liveBytes += n;
+    return reinterpret_cast<char*>(p) + sizeof(max_align_t);
+}
+
+void operator delete(void* q) noexcept
+{
+    if (!q)
+        return;
+    size_t* p = reinterpret_cast<size_t*>(static_cast<char*>(q) - sizeof(max_align_t));
+    liveBytes -= *p;
+    free(p);
+}
+
+void operator delete(void* q, size_t) noexcept
+{
+    operator delete(q);
+}
+
+static double msSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+//! runs lookup over the queries rounds times and prints ns per lookup; the sum keeps the loop from being optimised out
+template <typename Lookup>
+static void timeLookups(const char* name, const vector<string>& queries, int rounds, Lookup lookup)
+{
+    long long sum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+        for (const string& q : queries)
+            sum += lookup(q);
+    double ms = msSince(start);
+    cout << "  " << name << ": " << ms * 1e6 / (double(queries.size()) * rounds) << " ns/lookup (" << sum << ")" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    string fileName = argc > 1 ? argv[1] : WORD_LIST;
+    vector<string> words;
+    if (!Transliterator(Transliterator::Hindi).toslp1File(fileName, words) || words.empty()) {
+        cerr << "Cannot read " << fileName << endl;
+        return 1;
+    }
+    cout << words.size() << " words from " << fileName << endl;
+
+    size_t before = liveBytes;
+    auto start = chrono::steady_clock::now();
+    map<string, int> m;
+    for (const string& w : words)
+        m[w] = m[w] + 1;
+    double mapBuild = msSince(start);
+    size_t mapBytes = liveBytes - before;
+
+    before = liveBytes;
+    start = chrono::steady_clock::now();
+    Lexicon lex;
+    for (const string& w : words)
+        lex.add(w);
+    double lexBuild = msSince(start);
+    size_t lexBytes = liveBytes - before;
+
+    cout << m.size() << " distinct words" << endl;
+    cout << "std::map: built in " << mapBuild << " ms, " << mapBytes / 1024 << " KB on the heap" << endl;
+    cout << "Lexicon:  built in " << lexBuild << " ms, " << lexBytes / 1024 << " KB on the heap, memoryUsage() "
+         << lex.memoryUsage() / 1024 << " KB" << endl;
+
+    vector<string> hits(words);
+    mt19937 rng(7);
+    shuffle(hits.begin(), hits.end(), rng);
+    vector<string> misses;
+    misses.reserve(hits.size());
+    for (const string& w : hits)
+        misses.push_back(w + "~");
+
+    const int rounds = 5;
+    cout << "hits" << endl;
+    timeLookups("std::map", hits, rounds, [&](const string& q) { auto it = m.find(q); return it == m.end() ? 0 : it->second; });
+    timeLookups("Lexicon ", hits, rounds, [&](const string& q) { return lex.count(q); });
+    cout << "misses" << endl;
+    timeLookups("std::map", misses, rounds, [&](const string& q) { auto it = m.find(q); return it == m.end() ? 0 : it->second; });
+    timeLookups("Lexicon ", misses, rounds, [&](const string& q) { return lex.count(q); });
+
+    //! the substring scans of slpNPatternDict: every prefix of every suffix, up to the longest word
+    cout << "substrings" << endl;
+    size_t maxLen = lex.maxLength();
+    timeLookups("std::map", hits, 1, [&](const string& q) {
+        long long s = 0;
+        for (size_t j = 0; j < q.size(); j++)
+            for (size_t i = 1; i <= min(maxLen, q.size() - j); i++) {
+                auto it = m.find(q.substr(j, i));
+                if (it != m.end()) s += it->second;
+            }
+        return s;
+    });
+    timeLookups("Lexicon ", hits, 1, [&](const string& q) {
+        long long s = 0;
+        for (size_t j = 0; j < q.size(); j++)
+            for (size_t i = 1; i <= min(maxLen, q.size() - j); i++)
+                s += lex.count(q.data() + j, i);
+        return s;
+    });
+    vector<int> counts;
+    timeLookups("Lexicon::prefixCounts", hits, 1, [&](const string& q) {
+        long long s = 0;
+        for (size_t j = 0; j < q.size(); j++) {
+            lex.prefixCounts(q.data() + j, q.size() - j, counts);
+            for (int c : counts) s += c;
+        }
+        return s;
+    });
+    return 0;
+}
@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Lexicon lookup throughput and memory against std::map; not a testcase, run it by hand
+#
+#-------------------------------------------------
+
+QT -= core gui
+
+TARGET = lexiconbench
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += $$PWD/../..
+
+HEADERS += $$PWD/../../lexicon.h \
+    $$PWD/../../transliterator.h
+
+SOURCES += $$PWD/../../lexicon.cpp \
+    $$PWD/../../transliterator.cpp \
+    $$PWD/lexiconbench.cpp
+
+DEFINES += WORD_LIST=\\\"$$PWD/../../wordlists/hindi.txt\\\"
@@ -0,0 +1,12 @@
+# ----------------------------------------------------
+# Checks of the parts of the tool that replace Qt or older code with faster
+# versions; build with qmake tests.pro && make && make check
+# lexiconbench is a benchmark, built here but only run by hand
+# ----------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    htmltotext \
+    lexiconbench \
+    transliterator
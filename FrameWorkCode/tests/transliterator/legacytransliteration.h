@@ -0,0 +1,29 @@
+#ifndef LEGACYTRANSLITERATION_H
+#define LEGACYTRANSLITERATION_H
+
+#include <string>
+
+using namespace std;
+
+/*
+ * slpNPatternDict::toslp1/toDev as they were before Transliterator: a chain of
+ * ReplaceString passes over the word per character list. Kept here unchanged,
+ * with the HinFlag/SanFlag globals as members, as the reference the tables of
+ * Transliterator are checked against.
+ */
+class LegacyTransliteration
+{
+public:
+    explicit LegacyTransliteration(bool hindi) : HinFlag(hindi), SanFlag(!hindi) {}
+
+    string toDev(string s);
+    string toslp1(string s);
+
+private:
+    string ReplaceString(string subject, const string& search, const string& replace);
+    string ReplaceStringRestricted(string subject, const string& search, const string& replace);
+
+    bool HinFlag, SanFlag;
+};
+
+#endif // LEGACYTRANSLITERATION_H
@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# Transliterator against the ReplaceString chains of slpNPatternDict it replaced
+#
+#-------------------------------------------------
+
+QT += core testlib
+QT -= gui
+
+TARGET = tst_transliterator
+TEMPLATE = app
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../..
+
+HEADERS += $$PWD/../../transliterator.h \
+    $$PWD/legacytransliteration.h
+
+SOURCES += $$PWD/../../transliterator.cpp \
+    $$PWD/legacytransliteration.cpp \
+    $$PWD/tst_transliterator.cpp
+
+DEFINES += SAMPLE_PROJECT_DIR=\\\"$$PWD/../../../TestProject\\\"
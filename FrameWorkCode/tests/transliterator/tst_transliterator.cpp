@@ -0,0 +1,221 @@
+/*!
+ * \class TestTransliterator
+ * \brief Compares Transliterator with the ReplaceString chains it replaced, byte for byte, in the Hindi and Sanskrit modes
+ * \details The words are those of the sample project and random words over the Devanagari block, the other
+ * characters of the old character lists and the ASCII that SLP1 uses. The seed is fixed so that a failure repeats.
+ */
+#include "transliterator.h"
+#include "legacytransliteration.h"
+#include <QtTest>
+#include <random>
+
+class TestTransliterator : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int RANDOM_WORDS = 100000;
+
+    static void appendUtf8(string &s, uint c);
+    static vector<string> randomDevanagari(unsigned seed);
+    static vector<string> randomSlp1(unsigned seed);
+    static vector<string> sampleWords();
+    static void compare(Transliterator::Script script, const vector<string> &words, bool toslp1);
+
+private slots:
+    void sampleWords_data();
+    void sampleWords();
+    void randomDevanagari_data();
+    void randomDevanagari();
+    void randomSlp1_data();
+    void randomSlp1();
+    void batch();
+};
+
+/*!
+ * \fn TestTransliterator::appendUtf8
+ * \param s
+ * \param c code point below U+10000
+ */
+void TestTransliterator::appendUtf8(string &s, uint c)
+{
+    if (c < 0x80) {
+        s += char(c);
+    } else if (c < 0x800) {
+        s += char(0xC0 | (c >> 6));
+        s += char(0x80 | (c & 0x3F));
+    } else {
+        s += char(0xE0 | (c >> 12));
+        s += char(0x80 | ((c >> 6) & 0x3F));
+        s += char(0x80 | (c & 0x3F));
+    }
+}
+
+/*!
+ * \fn TestTransliterator::randomDevanagari
+ * \brief Words of 1 to 12 characters, mostly from the Devanagari block, with the virama made more likely so
+ * that conjuncts and dropped inherent vowels are common
+ * \param seed
+ * \return vector<string>
+ */
+vector<string> TestTransliterator::randomDevanagari(unsigned seed)
+{
+    //! characters of the old lists outside the Devanagari block: vedic anusvaras, dashes and quotes
+    const uint others[] = { 0x1CF2, 0x1CF3, 0x2013, 0x2014, 0x2018, 0x2019, 0x201C, 0x201D };
+    const string ascii = "aAiIuUfFxXeEoOMHkKgGNcCjJYwWqQRtTdDnpPbBmyrlvSzshLZV0123456789|^$%-'\"~*@#&";
+
+    mt19937 rng(seed);
+    vector<string> words;
+    words.reserve(RANDOM_WORDS);
+    for (int n = 0; n < RANDOM_WORDS; n++) {
+        string w;
+        int len = 1 + rng() % 12;
+        for (int i = 0; i < len; i++) {
+            uint r = rng() % 100;
+            if (r < 70)
+                appendUtf8(w, 0x0900 + rng() % 0x80);
+            else if (r < 85)
+                appendUtf8(w, 0x094D);      // virama
+            else if (r < 95)
+                appendUtf8(w, others[rng() % (sizeof(others) / sizeof(others[0]))]);
+            else
+                w += ascii[rng() % ascii.size()];
+        }
+        words.push_back(w);
+    }
+    return words;
+}
+
+/*!
+ * \fn TestTransliterator::randomSlp1
+ * \brief Words of 1 to 12 characters over the SLP1 letters and the ASCII the old lists map to Devanagari
+ * \param seed
+ * \return vector<string>
+ */
+vector<string> TestTransliterator::randomSlp1(unsigned seed)
+{
+    const string letters = "aAiIuUfFxXeEoOMHkKgGNcCjJYwWqQRtTdDnpPbBmyrlvSzshLZV~*@#$%^&0123456789|-'\"";
+
+    mt19937 rng(seed);
+    vector<string> words;
+    words.reserve(RANDOM_WORDS);
+    for (int n = 0; n < RANDOM_WORDS; n++) {
+        string w;
+        int len = 1 + rng() % 12;
+        for (int i = 0; i < len; i++)
+            w += letters[rng() % letters.size()];
+        words.push_back(w);
+    }
+    return words;
+}
+
+/*!
+ * \fn TestTransliterator::sampleWords
+ * \brief The whitespace separated words of the OCR text of the sample project
+ * \return vector<string>
+ */
+vector<string> TestTransliterator::sampleWords()
+{
+    vector<string> words;
+    QDir dir(QString(SAMPLE_PROJECT_DIR) + "/Inds");
+    for (const QString &name : dir.entryList(QStringList("*.txt"), QDir::Files, QDir::Name)) {
+        QFile file(dir.filePath(name));
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+        for (const QByteArray &word : file.readAll().simplified().split(' '))
+            words.push_back(word.toStdString());
+    }
+    return words;
+}
+
+/*!
+ * \fn TestTransliterator::compare
+ * \brief Converts every word with both implementations and fails on the first that differs
+ * \param script
+ * \param words
+ * \param toslp1 direction, Devanagari to SLP1 if true
+ */
+void TestTransliterator::compare(Transliterator::Script script, const vector<string> &words, bool toslp1)
+{
+    Transliterator tr(script);
+    LegacyTransliteration legacy(script == Transliterator::Hindi);
+    string out;
+    for (const string &w : words) {
+        string expected = toslp1 ? legacy.toslp1(w) : legacy.toDev(w);
+        if (toslp1)
+            tr.toslp1(w, out);
+        else
+            tr.toDev(w, out);
+        if (out != expected)
+            QFAIL(qPrintable(QString("%1 gives %2, expected %3")
+                             .arg(QString::fromStdString(w), QString::fromStdString(out), QString::fromStdString(expected))));
+    }
+}
+
+void TestTransliterator::sampleWords_data()
+{
+    QTest::addColumn<int>("script");
+    QTest::newRow("Hindi") << int(Transliterator::Hindi);
+    QTest::newRow("Sanskrit") << int(Transliterator::Sanskrit);
+}
+
+/*!
+ * \fn TestTransliterator::sampleWords
+ * \brief The OCR words of the sample project to SLP1, and their SLP1 back to Devanagari
+ */
+void TestTransliterator::sampleWords()
+{
+    QFETCH(int, script);
+    vector<string> words = sampleWords();
+    QVERIFY2(!words.empty(), "No OCR text in the sample project");
+    compare(Transliterator::Script(script), words, true);
+
+    vector<string> slp1;
+    Transliterator(Transliterator::Script(script)).toslp1(words, slp1);
+    compare(Transliterator::Script(script), slp1, false);
+}
+
+void TestTransliterator::randomDevanagari_data()
+{
+    sampleWords_data();
+}
+
+void TestTransliterator::randomDevanagari()
+{
+    QFETCH(int, script);
+    compare(Transliterator::Script(script), randomDevanagari(4 + script), true);
+}
+
+void TestTransliterator::randomSlp1_data()
+{
+    sampleWords_data();
+}
+
+void TestTransliterator::randomSlp1()
+{
+    QFETCH(int, script);
+    compare(Transliterator::Script(script), randomSlp1(17 + script), false);
+}
+
+/*!
+ * \fn TestTransliterator::batch
+ * \brief The vector overloads give the same words as converting them one by one
+ */
+void TestTransliterator::batch()
+{
+    Transliterator tr(Transliterator::Sanskrit);
+    vector<string> dev = randomDevanagari(29), slp1;
+    tr.toslp1(dev, slp1);
+    QCOMPARE(slp1.size(), dev.size());
+    for (size_t i = 0; i < dev.size(); i++)
+        QVERIFY(slp1[i] == tr.toslp1(dev[i]));
+
+    vector<string> back;
+    tr.toDev(slp1, back);
+    QCOMPARE(back.size(), slp1.size());
+    for (size_t i = 0; i < slp1.size(); i++)
+        QVERIFY(back[i] == tr.toDev(slp1[i]));
+}
+
+QTEST_APPLESS_MAIN(TestTransliterator)
+#include "tst_transliterator.moc"
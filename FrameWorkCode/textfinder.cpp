@@ -289,12 +289,16 @@ void TextFinder::on_replaceAllButton_clicked()
                     cur.mergeCharFormat(fmt); //apply the text properties captured earlier
                     tot_replaced += 1;
                 }
-                QString s1 = doc->toHtml();
+                QString s1 = handleBbox->insertBboxes(doc->toHtml());
                 doc->clear();
-                file->open(QIODevice::WriteOnly);
-                file->write(s1.toUtf8());
-                file->close();
-                handleBbox->insertBboxes(file);
+                if (file->open(QIODevice::WriteOnly | QIODevice::Text)) {
+                    QTextStream out(file);
+                    out.setCodec("UTF-8");
+                    out << s1;
+                    out.flush();
+                    file->close();
+                }
+                ((MainWindow *)(parent()))->GetProject().markForCommit(it_file_path);
             }
         }
         ((MainWindow *)(parent()))->reLoadTabWindow();
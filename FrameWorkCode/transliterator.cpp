@@ -0,0 +1,514 @@
+/*!
+ * \class Transliterator
+ * \brief Table driven SLP1 <-> Devanagari conversion used by slpNPatternDict::toslp1() and toDev()
+ * \details The previous implementation ran one ReplaceString pass per table entry (90+ passes per
+ *          word). Here every table is decoded once into per code point and per ASCII byte lookups,
+ *          and a word is converted by a single scan that writes into a caller owned buffer.
+ *          Where the order of the old passes changed the result (the inherent "a" after a consonant
+ *          depends on which neighbours had already been converted), the scanner follows the same rule.
+ */
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include "transliterator.h"
+
+namespace {
+
+enum Kind { Raw = 0, Consonant, Halanta, Joiner, Vowel, Number };
+
+//! Devanagari side of one table entry
+struct DevChar {
+    unsigned char kind = Raw;
+    int order = -1;          // position in the consonant pass, -1 if that pass skips it
+    bool halanta = false;    // consonant + virama has an SLP1 form
+    string slp;
+};
+
+//! One scanned unit of the input
+struct Token {
+    unsigned char kind;
+    size_t len;
+    const DevChar* c;
+};
+
+const char* const virama = "\xE0\xA5\x8D";   // "्"
+
+uint32_t decode(const string& s, size_t pos, size_t& len)
+{
+    unsigned char b = s[pos];
+    size_t n = (b >= 0xF0 && b < 0xF8) ? 4 : (b >= 0xE0) ? 3 : (b >= 0xC0) ? 2 : 1;
+    if (n == 1 || pos + n > s.size()) { len = 1; return b; }
+
+    uint32_t cp = b & (0x3F >> (n - 1));
+    for (size_t i = 1; i < n; ++i) {
+        unsigned char c = s[pos + i];
+        if ((c & 0xC0) != 0x80) { len = 1; return b; }
+        cp = (cp << 6) | (c & 0x3F);
+    }
+    len = n;
+    return cp;
+}
+
+uint32_t firstCodePoint(const string& s)
+{
+    size_t len;
+    return decode(s, 0, len);
+}
+
+//! Bytes that, following a consonant, stop ReplaceStringRestricted from adding the inherent "a"
+bool isMatraByte(unsigned char c)
+{
+    return c == 'A' || c == 'i' || c == 'I' || c == 'u' || c == 'U' || c == 'f' || c == 'F' || c == 'x' || c == 'X' || c == 'e' || c == 'E' || c == 'o' || c == 'O';
+}
+
+} // namespace
+
+struct Transliterator::Tables {
+    // toslp1
+    DevChar block[0x80];           // U+0900 .. U+097F
+    vector<pair<uint32_t, DevChar>> extra;
+    bool vowelsBeforeConsonants;
+    bool normalize;
+
+    // toDev, indexed by ASCII byte
+    string consonant[128];
+    string joiner[128];
+    bool hasJoiner[128];
+    string vowel[128];
+    vector<pair<string, string>> numbers;   // longest pattern first
+
+    const DevChar* find(uint32_t cp) const
+    {
+        if (cp >= 0x900 && cp < 0x980) return block[cp - 0x900].kind != Raw ? &block[cp - 0x900] : nullptr;
+        for (size_t i = 0; i < extra.size(); ++i)
+            if (extra[i].first == cp) return &extra[i].second;
+        return nullptr;
+    }
+
+    DevChar& entry(const string& dev)
+    {
+        uint32_t cp = firstCodePoint(dev);
+        if (cp >= 0x900 && cp < 0x980) return block[cp - 0x900];
+        for (size_t i = 0; i < extra.size(); ++i)
+            if (extra[i].first == cp) return extra[i].second;
+        extra.push_back(make_pair(cp, DevChar()));
+        return extra.back().second;
+    }
+
+    void addNumber(const string& slp, const string& dev)
+    {
+        for (size_t i = 0; i < numbers.size(); ++i)
+            if (numbers[i].first == slp) return;   // an earlier pass already converts it
+        numbers.push_back(make_pair(slp, dev));
+    }
+
+    static bool longerPattern(const pair<string, string>& a, const pair<string, string>& b)
+    {
+        return a.first.size() > b.first.size();
+    }
+
+    Tables(Script script)
+    {
+        for (int i = 0; i < 128; ++i) hasJoiner[i] = false;
+
+        if (script == Hindi) {
+            vowelsBeforeConsonants = true;
+            normalize = false;
+
+            //! toslp1
+            {
+                string vowel_dn[]={"अ","आ","इ","ई","उ","ऊ","ऋ","ए","ऐ","ओ","औ","ऑ","ं","ः","ँ","ॅ"};
+                string vowel_dn_joiner[]={"ा","ि","ी","ु","ू","ृ","े","ै","ो","ौ","ॉ"};
+                string vowel_slp1[]={"a","A","i","I","u","U","f","e","E","o","O","Z","M","H","*","~"};
+                string consonants_dn[]={"क","ख","ग","घ","ङ","च","छ","ज","झ","ञ","ट","ठ","ड","ढ","ण","त","थ","द","ध","न","प","फ","ब","भ","म","य","र","ल","व","श","ष","स","ह","क़","ख़","ग़","ज़","ड़","ढ़","ऩ","फ़","य़","ऱ","ळ"};
+                string consonants_slp1[]={"k","K","g","G","N","c","C","j","J","Y","w","W","q","Q","R","t","T","d","D","n","p","P","b","B","m","y","r","l","v","S","z","s","h","@","#","$","F","x","X","%","^","&","V","L"};
+                string no_dn[]={"०","१","२","३","४","५","६","७","८","९","॥","।","–","—"};
+                string no_slp1[]={"0","1","2","3","4","5","6","7","8","9","||","|","-","-"};
+
+                for (int i = 0; i < 44; i++) {
+                    DevChar& d = entry(consonants_dn[i]);
+                    d.kind = Consonant; d.halanta = true; d.slp = consonants_slp1[i];
+                    if (i < 43) d.order = i;
+                }
+                for (int i = 0; i < 11; i++) { DevChar& d = entry(vowel_dn_joiner[i]); d.kind = Joiner; d.slp = vowel_slp1[i+1]; }
+                for (int i = 0; i < 16; i++) { DevChar& d = entry(vowel_dn[i]); d.kind = Vowel; d.slp = vowel_slp1[i]; }
+                for (int i = 0; i < 14; i++) { DevChar& d = entry(no_dn[i]); d.kind = Number; d.slp = no_slp1[i]; }
+            }
+
+            //! toDev
+            {
+                string vowel_dn[]={"अ","आ","इ","ई","उ","ऊ","ऋ","ए","ऐ","ओ","औ","ऑ","ं","ः","ँ","ॅ"};
+                string vowel_dn_joiner[]={"","ा","ि","ी","ु","ू","ृ","े","ै","ो","ौ","ॉ"};
+                string vowel_slp1[]={"a","A","i","I","u","U","f","e","E","o","O","Z","M","H","~","*"};
+                string consonants_dn[]={"क","ख","ग","घ","ङ","च","छ","ज","झ","ञ","ट","ठ","ड","ढ","ण","त","थ","द","ध","न","प","फ","ब","भ","म","य","र","ल","व","श","ष","स","ह","क़","ख़","ग़","ज़","ड़","ढ़","ऩ","फ़","य़","ऱ","ळ"};
+                string consonants_slp1[]={"k","K","g","G","N","c","C","j","J","Y","w","W","q","Q","R","t","T","d","D","n","p","P","b","B","m","y","r","l","v","S","z","s","h","@","#","$","F","x","X","%","^","&","V","L"};
+                string no_dn[]={"०","१","२","३","४","५","६","७","८","९","॥","।","–","—"};
+                string no_slp1[]={"0","1","2","3","4","5","6","7","8","9","||","|","-","-"};
+
+                for (int i = 0; i < 44; i++) consonant[(unsigned char)consonants_slp1[i][0]] = consonants_dn[i];
+                for (int i = 0; i < 12; i++) { joiner[(unsigned char)vowel_slp1[i][0]] = vowel_dn_joiner[i]; hasJoiner[(unsigned char)vowel_slp1[i][0]] = true; }
+                for (int i = 0; i < 16; i++) vowel[(unsigned char)vowel_slp1[i][0]] = vowel_dn[i];
+                for (int i = 0; i < 13; i++) addNumber(no_slp1[i], no_dn[i]);
+            }
+        }
+        else {
+            vowelsBeforeConsonants = false;
+            normalize = true;
+
+            //! toslp1
+            {
+                string vowel_dn[]={"अ","आ","इ","ई","उ","ऊ","ऋ","ॠ","ऌ","ॡ","ए","ऐ","ओ","औ","ं","ः","ँ","ᳲ","ᳳ"};
+                string vowel_dn_joiner[]={"ा","ि","ी","ु","ू","ृ","ॄ","ॢ","ॣ","े","ै","ो","ौ"};
+                string consonants_dn[]={"क","ख","ग","घ","ङ","च","छ","ज","झ","ञ","ट","ठ","ड","ढ","ण","त","थ","द","ध","न","प","फ","ब","भ","म","य","र","ल","व","श","ष","स","ह","ळ"};
+                string vowel_slp1[]={"a","A","i","I","u","U","f","F","x","X","e","E","o","O","M","H","~","Z","V"};
+                string consonants_slp1[]={"k","K","g","G","N","c","C","j","J","Y","w","W","q","Q","R","t","T","d","D","n","p","P","b","B","m","y","r","l","v","S","z","s","h","L"};
+                string numbers_etc_dn[]={"॥","।","॰","ऽ","‘","’","“","”","ॐ","१","२","३","४","५","६","७","८","९","०"};
+                string numbers_eng[]={"||","|","^0","$","-'","'","-\"","\"","%","1","2","3","4","5","6","7","8","9","0"};
+
+                for (int i = 0; i < 34; i++) { DevChar& d = entry(consonants_dn[i]); d.kind = Consonant; d.halanta = true; d.slp = consonants_slp1[i]; d.order = i; }
+                for (int i = 0; i < 13; i++) { DevChar& d = entry(vowel_dn_joiner[i]); d.kind = Joiner; d.slp = vowel_slp1[i+1]; }
+                for (int i = 0; i < 19; i++) { DevChar& d = entry(vowel_dn[i]); d.kind = Vowel; d.slp = vowel_slp1[i]; }
+                for (int i = 0; i < 19; i++) { DevChar& d = entry(numbers_etc_dn[i]); d.kind = Number; d.slp = numbers_eng[i]; }
+            }
+
+            //! toDev
+            {
+                string vowel_dn[]={"अ","आ","इ","ई","उ","ऊ","ऋ","ॠ","ऌ","ॡ","ए","ऐ","ओ","औ","ं","ः","ँ","ᳲ","ᳳ","ऽ","ॐ"};
+                string vowel_dn_joiner[]={"","ा","ि","ी","ु","ू","ृ","ॄ","ॢ","ॣ","े","ै","ो","ौ"};
+                string consonants_dn[]={"क","ख","ग","घ","ङ","च","छ","ज","झ","ञ","ट","ठ","ड","ढ","ण","त","थ","द","ध","न","प","फ","ब","भ","म","य","र","ल","व","श","ष","स","ह","ळ"};
+                string vowel_slp1[]={"a","A","i","I","u","U","f","F","x","X","e","E","o","O","M","H","~","Z","V","$","%"};
+                string consonants_slp1[]={"k","K","g","G","N","c","C","j","J","Y","w","W","q","Q","R","t","T","d","D","n","p","P","b","B","m","y","r","l","v","S","z","s","h","L"};
+                string numbers_etc_dn[]={"॥","।","॰","ऽ","‘","’","“","”","ॐ","१","२","३","४","५","६","७","८","९","०"};
+                string numbers_eng[]={"||","|","^0","$","-'","'","-\"","\"","%","1","2","3","4","5","6","7","8","9","0"};
+
+                for (int i = 0; i < 34; i++) consonant[(unsigned char)consonants_slp1[i][0]] = consonants_dn[i];
+                for (int i = 0; i < 14; i++) { joiner[(unsigned char)vowel_slp1[i][0]] = vowel_dn_joiner[i]; hasJoiner[(unsigned char)vowel_slp1[i][0]] = true; }
+                for (int i = 0; i < 21; i++) vowel[(unsigned char)vowel_slp1[i][0]] = vowel_dn[i];
+                for (int i = 0; i < 19; i++) addNumber(numbers_eng[i], numbers_etc_dn[i]);
+            }
+        }
+        //! the old passes ran "||" before "|", "^0" before "0" and "-'" before "'"
+        stable_sort(numbers.begin(), numbers.end(), longerPattern);
+    }
+};
+
+namespace {
+
+const Transliterator::Tables& tablesFor(Transliterator::Script script)
+{
+    static const Transliterator::Tables hindi(Transliterator::Hindi);
+    static const Transliterator::Tables sanskrit(Transliterator::Sanskrit);
+    return script == Transliterator::Hindi ? hindi : sanskrit;
+}
+
+Token scan(const Transliterator::Tables& t, const string& s, size_t pos)
+{
+    Token tok = { Raw, 1, nullptr };
+    if ((unsigned char)s[pos] < 0x80) return tok;
+
+    uint32_t cp = decode(s, pos, tok.len);
+    const DevChar* c = t.find(cp);
+    if (!c) return tok;
+
+    tok.c = c;
+    tok.kind = c->kind;
+    if (c->kind == Consonant) {
+        if (c->halanta && s.compare(pos + tok.len, 3, virama) == 0) {
+            tok.kind = Halanta;
+            tok.len += 3;
+        }
+        else if (c->order < 0) tok.kind = Raw;
+    }
+    return tok;
+}
+
+/*
+ * The old code converted consonants after the virama forms and the vowel signs (and, for Hindi,
+ * after the independent vowels), one consonant of the table at a time. A consonant got an "a"
+ * unless the byte following it at that moment was a vowel sign letter; this returns that byte.
+ */
+unsigned char byteSeenAfter(const Transliterator::Tables& t, const string& s, size_t pos, int order)
+{
+    Token next = scan(t, s, pos);
+    switch (next.kind) {
+    case Halanta:
+    case Joiner:
+        return next.c->slp[0];
+    case Vowel:
+        return t.vowelsBeforeConsonants ? next.c->slp[0] : s[pos];
+    case Consonant:
+        return next.c->order < order ? next.c->slp[0] : s[pos];
+    default:
+        return s[pos];
+    }
+}
+
+//! Character fix-ups that the Sanskrit toslp1 ran before its tables, kept exactly as they were
+void normalizeSanskrit(string& s)
+{
+    size_t pos = 0;
+    while((pos=s.find("ॆ", pos)) != string::npos)
+        s.replace(pos, 3,"े");
+
+    pos = 0;
+    while((pos=s.find("ऎ", pos)) != string::npos)
+        s.replace(pos, 3,"एे");
+
+    pos = 0;
+    while((pos=s.find("ॊ", pos)) != string::npos)
+        s.replace(pos, 3,"ो");
+
+    pos = 0;
+    while((pos=s.find("ऴ्", pos)) != string::npos)
+        s.replace(pos, 6,"ळ्");
+
+    pos = 0;
+    while((pos=s.find("ऴ", pos)) != string::npos)
+        s.replace(pos, 6,"ळ");
+}
+
+bool needsSanskritNormalization(const string& s)
+{
+    //! U+090E, U+0934, U+093C (nukta), U+0946 and U+094A are E0 A4 8E, E0 A4 B4, E0 A4 BC, E0 A5 86, E0 A5 8A
+    for (size_t pos = 0; (pos = s.find('\xE0', pos)) != string::npos; ++pos) {
+        if (pos + 2 >= s.size()) break;
+        unsigned char b1 = s[pos + 1], b2 = s[pos + 2];
+        if ((b1 == 0xA4 && (b2 == 0x8E || b2 == 0xB4 || b2 == 0xBC)) || (b1 == 0xA5 && (b2 == 0x86 || b2 == 0x8A))) return true;
+    }
+    return false;
+}
+
+
+//! Independent vowel or number sign starting at pos, otherwise the byte itself; returns the bytes consumed
+size_t appendVowelOrNumber(const Transliterator::Tables& t, const string& s, size_t pos, string& out)
+{
+    unsigned char b = s[pos];
+    if (b < 0x80 && !t.vowel[b].empty()) {
+        out += t.vowel[b];
+        return 1;
+    }
+    for (size_t i = 0; i < t.numbers.size(); ++i) {
+        const string& p = t.numbers[i].first;
+        if (s.compare(pos, p.size(), p) == 0) {
+            out += t.numbers[i].second;
+            return p.size();
+        }
+    }
+    out += (char)b;
+    return 1;
+}
+
+/*
+ * Consonants and vowel signs of toDev for input that already contains viramas, following the old
+ * passes exactly: every consonant became consonant + virama, then "्a" was dropped (ReplaceString
+ * resumed one byte later, so a "्a" right behind a dropped one was kept), and only afterwards
+ * "्" + vowel turned into vowel signs, which can now join a virama with the letter after a dropped "्a".
+ */
+void joinViramas(const Transliterator::Tables& t, const string& in, string& out)
+{
+    size_t n = in.size();
+    bool dropped = false;
+
+    for (size_t pos = 0; pos < n;) {
+        unsigned char b = in[pos];
+        bool viramaUnit = false;
+        size_t next = pos + 1;
+
+        if (b < 0x80 && !t.consonant[b].empty()) {
+            out += t.consonant[b];
+            dropped = false;
+            viramaUnit = true;
+        }
+        else if (b == 0xE0 && in.compare(pos, 3, virama) == 0) {
+            viramaUnit = true;
+            next = pos + 3;
+        }
+
+        if (viramaUnit) {
+            if (next < n && in[next] == 'a' && !dropped) {
+                dropped = true;
+                pos = next + 1;
+                continue;
+            }
+            out += virama;
+            dropped = false;
+            pos = next;
+            continue;
+        }
+
+        dropped = false;
+        size_t len = out.size();
+        if (b < 0x80 && b != 'a' && t.hasJoiner[b] && len >= 3 && out.compare(len - 3, 3, virama) == 0) {
+            out.replace(len - 3, 3, t.joiner[b]);
+        }
+        else out += (char)b;
+        pos++;
+    }
+}
+} // namespace
+
+/*!
+ * \fn Transliterator::Transliterator
+ * \param script selects the Hindi or the Sanskrit tables
+ */
+Transliterator::Transliterator(Script script) : t(&tablesFor(script))
+{
+}
+
+/*!
+ * \fn Transliterator::toslp1
+ * \brief Converts Devanagari to SLP1, bytes outside the tables are copied unchanged
+ * \param in
+ * \param out
+ */
+void Transliterator::toslp1(const string& in, string& out) const
+{
+    out.clear();
+
+    const string* src = &in;
+    string normalized;
+    if (t->normalize && needsSanskritNormalization(in)) {
+        normalized = in;
+        normalizeSanskrit(normalized);
+        src = &normalized;
+    }
+    const string& s = *src;
+    size_t n = s.size();
+    out.reserve(n);
+
+    for (size_t pos = 0; pos < n;) {
+        Token tok = scan(*t, s, pos);
+        switch (tok.kind) {
+        case Raw:
+            out.append(s, pos, tok.len);
+            break;
+        case Consonant:
+            out += tok.c->slp;
+            if (pos + tok.len >= n || !isMatraByte(byteSeenAfter(*t, s, pos + tok.len, tok.c->order))) out += 'a';
+            break;
+        default:
+            out += tok.c->slp;
+            break;
+        }
+        pos += tok.len;
+    }
+}
+
+/*!
+ * \fn Transliterator::toDev
+ * \brief Converts SLP1 to Devanagari, bytes outside the tables are copied unchanged
+ * \param in
+ * \param out
+ */
+void Transliterator::toDev(const string& in, string& out) const
+{
+    out.clear();
+    size_t n = in.size();
+    out.reserve(n * 3);
+
+    //! A virama already present in the input can meet other letters once a "्a" is dropped
+    if (in.find(virama) != string::npos) {
+        string joined;
+        joinViramas(*t, in, joined);
+        for (size_t pos = 0; pos < joined.size();) pos += appendVowelOrNumber(*t, joined, pos, out);
+        return;
+    }
+
+    for (size_t pos = 0; pos < n;) {
+        unsigned char b = in[pos];
+        if (b < 0x80 && !t->consonant[b].empty()) {
+            out += t->consonant[b];
+            unsigned char v = (pos + 1 < n) ? in[pos + 1] : 0;
+            if (v < 0x80 && t->hasJoiner[v]) {
+                out += t->joiner[v];
+                pos += 2;
+            }
+            else {
+                out += virama;
+                pos += 1;
+            }
+        }
+        else pos += appendVowelOrNumber(*t, in, pos, out);
+    }
+}
+
+/*!
+ * \fn Transliterator::toslp1
+ * \param in
+ * \return
+ */
+string Transliterator::toslp1(const string& in) const
+{
+    string out;
+    toslp1(in, out);
+    return out;
+}
+
+/*!
+ * \fn Transliterator::toDev
+ * \param in
+ * \return
+ */
+string Transliterator::toDev(const string& in) const
+{
+    string out;
+    toDev(in, out);
+    return out;
+}
+
+/*!
+ * \fn Transliterator::toslp1
+ * \brief Batch form, out[i] receives the conversion of in[i]
+ * \param in
+ * \param out
+ */
+void Transliterator::toslp1(const vector<string>& in, vector<string>& out) const
+{
+    out.resize(in.size());
+    for (size_t i = 0; i < in.size(); ++i) toslp1(in[i], out[i]);
+}
+
+/*!
+ * \fn Transliterator::toDev
+ * \brief Batch form, out[i] receives the conversion of in[i]
+ * \param in
+ * \param out
+ */
+void Transliterator::toDev(const vector<string>& in, vector<string>& out) const
+{
+    out.resize(in.size());
+    for (size_t i = 0; i < in.size(); ++i) toDev(in[i], out[i]);
+}
+
+/*!
+ * \fn Transliterator::toslp1File
+ * \param fileName
+ * \param words receives the converted words in file order
+ * \return false if the file could not be opened
+ */
+bool Transliterator::toslp1File(const string& fileName, vector<string>& words) const
+{
+    ifstream file(fileName, ios::in | ios::binary);
+    if (!file.is_open()) return false;
+
+    stringstream buffer;
+    buffer << file.rdbuf();
+    const string text = buffer.str();
+
+    string word;
+    size_t n = text.size();
+    for (size_t pos = 0; pos < n;) {
+        while (pos < n && isspace((unsigned char)text[pos])) pos++;
+        size_t end = pos;
+        while (end < n && !isspace((unsigned char)text[end])) end++;
+        if (end > pos) {
+            word.assign(text, pos, end - pos);
+            words.push_back(string());
+            toslp1(word, words.back());
+        }
+        pos = end;
+    }
+    return true;
+}
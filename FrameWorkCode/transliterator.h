@@ -0,0 +1,43 @@
+#ifndef TRANSLITERATOR_H
+#define TRANSLITERATOR_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+ * SLP1 <-> Devanagari transliteration in a single left to right pass.
+ * The tables are built once per script from the same character lists that
+ * slpNPatternDict::toslp1/toDev used, and the scanner reproduces the output
+ * of their sequence of ReplaceString passes byte for byte.
+ */
+class Transliterator {
+public:
+    enum Script { Hindi, Sanskrit };
+
+    struct Tables;
+
+    explicit Transliterator(Script script = Sanskrit);
+
+    //! out is cleared and reused, so callers can keep one buffer for many words
+    void toslp1(const string& in, string& out) const;
+
+    void toDev(const string& in, string& out) const;
+
+    string toslp1(const string& in) const;
+
+    string toDev(const string& in) const;
+
+    void toslp1(const vector<string>& in, vector<string>& out) const;
+
+    void toDev(const vector<string>& in, vector<string>& out) const;
+
+    //! Reads the whitespace separated words of fileName, as `ifstream >> word` would, and converts them to SLP1
+    bool toslp1File(const string& fileName, vector<string>& words) const;
+
+private:
+    const Tables* t;
+};
+
+#endif // TRANSLITERATOR_H
@@ -10,19 +10,278 @@
 #include "slpNPatternDict.h"
 #include <cctype>
 #include <vector>
+#include <cstring>
 #include "trieEditdis.h"
 
 using namespace std;
 
+const trie::node_t trie::npos;
+
+/*!
+ * \fn trie::clear
+ * \brief Releases all nodes and leaves only the root.
+ */
+void trie::clear()
+{
+    vector<node_t>().swap(firstChild);
+    vector<node_t>().swap(nextSibling);
+    vector<char>().swap(label);
+    vector<node_t>().swap(childStart);
+    vector<node_t>().swap(childNode);
+    vector<char>().swap(childLabel);
+    vector<unsigned char>().swap(terminal);
+    words = 0;
+    compacted = false;
+    addNode(0);
+}
+
+/*!
+ * \fn trie::addNode
+ * \param c label of the edge leading to the new node
+ * \return index of the new node in the arena
+ */
+trie::node_t trie::addNode(char c)
+{
+    firstChild.push_back(npos);
+    nextSibling.push_back(npos);
+    label.push_back(c);
+    terminal.push_back(0);
+    return (node_t)(terminal.size() - 1);
+}
+
+/*!
+ * \fn trie::findOrAddChild
+ * \brief Returns the child of n labelled c, creating it at its sorted place in the sibling list if needed.
+ * \param n
+ * \param c
+ * \return
+ */
+trie::node_t trie::findOrAddChild(node_t n, char c)
+{
+    node_t prev = npos, cur = firstChild[n];
+    while (cur != npos && label[cur] < c) {
+        prev = cur;
+        cur = nextSibling[cur];
+    }
+    if (cur != npos && label[cur] == c) return cur;
+
+    node_t m = addNode(c);
+    nextSibling[m] = cur;
+    if (prev == npos) firstChild[n] = m;
+    else nextSibling[prev] = m;
+    return m;
+}
+
+/*!
+ * \fn trie::insert
+ * \param w
+ */
+void trie::insert(const string& w)
+{
+    if (compacted) expand();
+
+    node_t n = findOrAddChild(root(), '$');
+    for (size_t i = 0; i < w.size(); ++i)
+        n = findOrAddChild(n, w[i]);
+
+    if (!terminal[n]) { terminal[n] = 1; words++; }
+}
+
+/*!
+ * \fn trie::insertPrefixes
+ * \brief Same as inserting w.substr(0, i) for every i in [0, len], but walks the path only once.
+ * \param w
+ * \param len
+ */
+void trie::insertPrefixes(const char* w, size_t len)
+{
+    if (compacted) expand();
+
+    node_t n = findOrAddChild(root(), '$');
+    if (!terminal[n]) { terminal[n] = 1; words++; }
+    for (size_t i = 0; i < len; ++i) {
+        n = findOrAddChild(n, w[i]);
+        if (!terminal[n]) { terminal[n] = 1; words++; }
+    }
+}
+
+/*!
+ * \fn trie::compact
+ * \brief Renumbers the nodes in depth first order and stores the children of every node as
+ *        contiguous sorted label and node arrays. The sibling lists are released afterwards.
+ */
+void trie::compact()
+{
+    if (compacted) return;
+
+    size_t sz = terminal.size();
+    vector<node_t> order, newId(sz), stack, kids;
+    order.reserve(sz);
+    stack.push_back(root());
+    while (!stack.empty()) {
+        node_t n = stack.back();
+        stack.pop_back();
+        newId[n] = (node_t)order.size();
+        order.push_back(n);
+
+        kids.clear();
+        for (node_t c = firstChild[n]; c != npos; c = nextSibling[c]) kids.push_back(c);
+        for (size_t k = kids.size(); k > 0; --k) stack.push_back(kids[k - 1]);
+    }
+
+    vector<unsigned char> newTerminal(sz);
+    childStart.assign(sz + 1, 0);
+    childLabel.reserve(sz - 1);
+    childNode.reserve(sz - 1);
+    for (size_t i = 0; i < sz; ++i) {
+        node_t n = order[i];
+        newTerminal[i] = terminal[n];
+        childStart[i] = (node_t)childNode.size();
+        for (node_t c = firstChild[n]; c != npos; c = nextSibling[c]) {
+            childLabel.push_back(label[c]);
+            childNode.push_back(newId[c]);
+        }
+    }
+    childStart[sz] = (node_t)childNode.size();
+    terminal.swap(newTerminal);
+
+    vector<node_t>().swap(firstChild);
+    vector<node_t>().swap(nextSibling);
+    vector<char>().swap(label);
+    compacted = true;
+}
+
+/*!
+ * \fn trie::expand
+ * \brief Rebuilds the sibling lists from the compact arrays so that more words can be inserted.
+ */
+void trie::expand()
+{
+    size_t sz = terminal.size();
+    firstChild.assign(sz, npos);
+    nextSibling.assign(sz, npos);
+    label.assign(sz, 0);
+    for (size_t n = 0; n < sz; ++n) {
+        node_t b = childStart[n], e = childStart[n + 1];
+        if (b < e) firstChild[n] = childNode[b];
+        for (node_t i = b; i < e; ++i) {
+            label[childNode[i]] = childLabel[i];
+            if (i + 1 < e) nextSibling[childNode[i]] = childNode[i + 1];
+        }
+    }
+
+    vector<node_t>().swap(childStart);
+    vector<node_t>().swap(childNode);
+    vector<char>().swap(childLabel);
+    compacted = false;
+}
+
+/*!
+ * \fn trie::child
+ * \param n
+ * \param c
+ * \return child of n labelled c, or npos
+ */
+trie::node_t trie::child(node_t n, char c) const
+{
+    if (!compacted) {
+        for (node_t cur = firstChild[n]; cur != npos; cur = nextSibling[cur])
+            if (label[cur] == c) return cur;
+        return npos;
+    }
+    for (node_t i = childStart[n], e = childStart[n + 1]; i < e; ++i)
+        if (childLabel[i] == c) return childNode[i];
+    return npos;
+}
+
+/*!
+ * \fn trie::memoryUsage
+ * \return bytes held by the node arrays
+ */
+size_t trie::memoryUsage() const
+{
+    return sizeof(*this)
+            + (firstChild.capacity() + nextSibling.capacity() + childStart.capacity() + childNode.capacity()) * sizeof(node_t)
+            + label.capacity() + childLabel.capacity() + terminal.capacity();
+}
+
+/*!
+ * \fn trie::write
+ * \brief Appends the compact arrays to out, in native byte order, so that read() can restore them without rebuilding.
+ * \param out
+ */
+void trie::write(string& out)
+{
+    compact();
+
+    uint64_t header[3] = { terminal.size(), childNode.size(), words };
+    out.append((const char*)header, sizeof(header));
+    out.append((const char*)childStart.data(), childStart.size() * sizeof(node_t));
+    out.append((const char*)childNode.data(), childNode.size() * sizeof(node_t));
+    out.append(childLabel.data(), childLabel.size());
+    out.append((const char*)terminal.data(), terminal.size());
+}
+
+/*!
+ * \fn trie::read
+ * \brief Restores a trie stored by write(). The arrays are checked so that a damaged buffer cannot send a search out of bounds.
+ * \param p start of the stored trie, advanced past it on success
+ * \param end
+ * \return false if the buffer does not hold a valid trie, the trie is left empty then
+ */
+bool trie::read(const char*& p, const char* end)
+{
+    clear();
+
+    uint64_t header[3];
+    if ((size_t)(end - p) < sizeof(header)) return false;
+    memcpy(header, p, sizeof(header));
+    uint64_t nodes = header[0], edges = header[1];
+    if (nodes == 0 || nodes >= npos || edges != nodes - 1) return false;
+    uint64_t bytes = sizeof(header) + (nodes + 1 + edges) * sizeof(node_t) + edges + nodes;
+    if ((uint64_t)(end - p) < bytes) return false;
+
+    const char* q = p + sizeof(header);
+    vector<node_t> start(nodes + 1), node(edges);
+    vector<char> lab(edges);
+    vector<unsigned char> term(nodes);
+    memcpy(start.data(), q, start.size() * sizeof(node_t)); q += start.size() * sizeof(node_t);
+    memcpy(node.data(), q, node.size() * sizeof(node_t)); q += node.size() * sizeof(node_t);
+    memcpy(lab.data(), q, lab.size()); q += lab.size();
+    memcpy(term.data(), q, term.size()); q += term.size();
+
+    //! nodes are in depth first order, so every child has a larger index than its parent
+    if (start[0] != 0 || start[nodes] != edges) return false;
+    for (size_t n = 0; n < nodes; ++n) {
+        if (start[n] > start[n + 1]) return false;
+        for (node_t i = start[n]; i < start[n + 1]; ++i)
+            if (node[i] <= n || node[i] >= nodes) return false;
+    }
+
+    vector<node_t>().swap(firstChild);
+    vector<node_t>().swap(nextSibling);
+    vector<char>().swap(label);
+    childStart.swap(start);
+    childNode.swap(node);
+    childLabel.swap(lab);
+    terminal.swap(term);
+    words = header[2];
+    compacted = true;
+    p = q;
+    return true;
+}
+
 /*!
  * \fn trieEditDis::search_impl
  * \param tree
+ * \param node
  * \param ch
  * \param last_row
  * \param word
+ * \param path letters on the way from the root to node, used to rebuild the terminal word
  * \param min_str
  */
-void trieEditDis::search_impl(trie* tree, char ch, vector<int> last_row, const string& word, vector<pair<int,string>>& min_str)
+void trieEditDis::search_impl(const trie& tree, trie::node_t node, char ch, vector<int> last_row, const string& word, string& path, vector<pair<int,string>>& min_str)
 {
     int sz = last_row.size();
 
@@ -38,20 +297,24 @@ void trieEditDis::search_impl(trie* tree, char ch, vector<int> last_row, const s
         current_row[i] = min(insert_or_del, replace);
     }
 
+    path.push_back(ch);
+
     //! When we find a cost that is less than the min_cost, is because it is the minimum until the current row, so we update
-    string treeword =(tree->word);
+    bool terminal = tree.isTerminal(node);
 
-    if ((current_row[sz-1] < min_cost + 1) && (treeword != "")) {
-         min_str.push_back(make_pair(current_row[sz-1],(treeword).substr(1,treeword.size()-1))); //cout << "edit dis and instance = "<< current_row[sz-1] <<" " << treeword << endl;
+    if ((current_row[sz-1] < min_cost + 1) && terminal) {
+         min_str.push_back(make_pair(current_row[sz-1], path.substr(1)));
     }
-    if ((current_row[sz-1] < min_cost) && (treeword != "")) min_cost = current_row[sz-1];
+    if ((current_row[sz-1] < min_cost) && terminal) min_cost = current_row[sz-1];
 
     //! If there is an element wich is smaller than the current minimum cost, we can have another cost smaller than the current minimum cost
     if (*min_element(current_row.begin(), current_row.end()) < min_cost) {
-        for (trie::next_t::iterator it = tree->next.begin(); it != tree->next.end(); ++it) {
-            search_impl(it->second, it->first, current_row, word,min_str);
+        for (trie::node_t i = tree.childBegin(node); i < tree.childEnd(node); ++i) {
+            search_impl(tree, tree.childNodeAt(i), tree.childLabelAt(i), current_row, word, path, min_str);
         }
     }
+
+    path.pop_back();
 }
 
 /*!
@@ -62,12 +325,11 @@ void trieEditDis::search_impl(trie* tree, char ch, vector<int> last_row, const s
  */
 vector<pair<int,string>> trieEditDis::searchTrie(trie& tree, string word)
 {   vector<pair<int,string>> min_str;
-    min_str.clear();
+    tree.compact();
     word = string("$") + word;
 
     int sz = word.size();
     min_cost = 0x3f3f3f3f;
-    //min_str = "";
 
     vector<int> current_row(sz + 1);
 
@@ -75,28 +337,124 @@ vector<pair<int,string>> trieEditDis::searchTrie(trie& tree, string word)
     for (int i = 0; i < sz; ++i) current_row[i] = i;
     current_row[sz] = sz;
 
-
+    string path;
+    path.reserve(sz * 2);
 
     //! For each letter in the root map wich matches with a letter in word, we must call the search
     for (int i = 0 ; i < sz; ++i) {
-        if (tree.next.find(word[i]) != tree.next.end()) {
-            search_impl(tree.next[word[i]], word[i], current_row, word, min_str);
+        trie::node_t n = tree.child(tree.root(), word[i]);
+        if (n != trie::npos) {
+            search_impl(tree, n, word[i], current_row, word, path, min_str);
         }
     }
 
     return min_str;
 }
 
+/*!
+ * \fn trieEditDis::search_bounded
+ * \brief Same walk as search_impl, but the DP rows live in row_stack (one row per depth) and
+ *        subtrees whose best possible cost exceeds maxDist are not visited.
+ * \param tree
+ * \param node
+ * \param ch
+ * \param depth depth of node, the "$" node has depth 1
+ * \param word
+ * \param path letters on the way from the root to node
+ * \param maxDist
+ * \param min_str
+ */
+void trieEditDis::search_bounded(const trie& tree, trie::node_t node, char ch, size_t depth, const string& word, string& path, int maxDist, vector<pair<int,string>>& min_str)
+{
+    size_t sz = word.size() + 1;
+    if ((depth + 1) * sz > row_stack.size()) row_stack.resize((depth + 2) * sz);
+
+    const int* last_row = &row_stack[(depth - 1) * sz];
+    int* current_row = &row_stack[depth * sz];
+    current_row[0] = last_row[0] + 1;
+    int row_min = current_row[0];
+
+    //! Calculate the min cost of insertion, deletion, match or substution
+    int insert_or_del, replace;
+    for (size_t i = 1; i < sz; ++i) {
+        insert_or_del = min(current_row[i-1] + 1, last_row[i] + 1);
+        replace = (word[i-1] == ch) ? last_row[i-1] : (last_row[i-1] + 1);
+
+        current_row[i] = min(insert_or_del, replace);
+        if (current_row[i] < row_min) row_min = current_row[i];
+    }
+
+    path.push_back(ch);
+
+    int cost = current_row[sz-1];
+    if (tree.isTerminal(node)) {
+        if ((cost < min_cost + 1) && (cost <= maxDist)) min_str.push_back(make_pair(cost, path.substr(1)));
+        if (cost < min_cost) min_cost = cost;
+    }
+
+    //! min_cost starts at maxDist + 1, so this also stops at the bound
+    if (row_min < min_cost) {
+        for (trie::node_t i = tree.childBegin(node); i < tree.childEnd(node); ++i) {
+            search_bounded(tree, tree.childNodeAt(i), tree.childLabelAt(i), depth + 1, word, path, maxDist, min_str);
+        }
+    }
+
+    path.pop_back();
+}
+
+/*!
+ * \fn trieEditDis::searchTrieBounded
+ * \brief Returns the entries of searchTrie() whose edit distance is at most maxDist, sorted,
+ *        keeping only the first topN of them (all of them when topN is 0).
+ * \param tree
+ * \param word
+ * \param maxDist
+ * \param topN
+ * \return
+ */
+vector<pair<int,string>> trieEditDis::searchTrieBounded(trie& tree, string word, int maxDist, size_t topN)
+{   vector<pair<int,string>> min_str;
+    tree.compact();
+    word = string("$") + word;
+
+    size_t sz = word.size() + 1;
+    min_cost = maxDist + 1;
+
+    //! Rows are bounded by the word length plus the allowed distance
+    row_stack.resize((word.size() + maxDist + 3) * sz);
+    for (size_t i = 0; i < sz; ++i) row_stack[i] = i;
+
+    string path;
+    path.reserve(sz + maxDist);
+
+    for (size_t i = 0 ; i < word.size(); ++i) {
+        trie::node_t n = tree.child(tree.root(), word[i]);
+        if (n != trie::npos) {
+            search_bounded(tree, n, word[i], 1, word, path, maxDist, min_str);
+        }
+    }
+
+    if (topN > 0 && min_str.size() > topN) {
+        partial_sort(min_str.begin(), min_str.begin() + topN, min_str.end());
+        min_str.resize(topN);
+    }
+    else sort(min_str.begin(), min_str.end());
+
+    return min_str;
+}
+
 // treeonesearch Starts
 /*!
  * \fn trieEditDis::search_impl1
  * \param tree
+ * \param node
  * \param ch
  * \param last_row
  * \param word
+ * \param path letters on the way from the root to node, used to rebuild the terminal word
  * \param min_str
  */
-void trieEditDis::search_impl1(trie* tree, char ch, vector<int> last_row, const string& word, string& min_str)
+void trieEditDis::search_impl1(const trie& tree, trie::node_t node, char ch, vector<int> last_row, const string& word, string& path, string& min_str)
 {
     int sz = last_row.size();
 
@@ -112,20 +470,24 @@ void trieEditDis::search_impl1(trie* tree, char ch, vector<int> last_row, const
         current_row[i] = min(insert_or_del, replace);
     }
 
+    path.push_back(ch);
+
     //! When we find a cost that is less than the min_cost, is because it is the minimum until the current row, so we update
-    string treeword =(tree->word);
+    bool terminal = tree.isTerminal(node);
 
-    if ((current_row[sz-1] < min_cost + 1) && (treeword != "")) {
-         min_str = (treeword).substr(1,treeword.size()-1); //cout << "edit dis and instance = "<< current_row[sz-1] <<" " << treeword << endl;
+    if ((current_row[sz-1] < min_cost + 1) && terminal) {
+         min_str = path.substr(1);
     }
-    if ((current_row[sz-1] < min_cost) && (treeword != "")) min_cost = current_row[sz-1];
+    if ((current_row[sz-1] < min_cost) && terminal) min_cost = current_row[sz-1];
 
     //! If there is an element wich is smaller than the current minimum cost, we can have another cost smaller than the current minimum cost
     if (*min_element(current_row.begin(), current_row.end()) < min_cost) {
-        for (trie::next_t::iterator it = tree->next.begin(); it != tree->next.end(); ++it) {
-            search_impl1(it->second, it->first, current_row, word,min_str);
+        for (trie::node_t i = tree.childBegin(node); i < tree.childEnd(node); ++i) {
+            search_impl1(tree, tree.childNodeAt(i), tree.childLabelAt(i), current_row, word, path, min_str);
         }
     }
+
+    path.pop_back();
 }
 
 /*!
@@ -136,12 +498,11 @@ void trieEditDis::search_impl1(trie* tree, char ch, vector<int> last_row, const
  */
 string trieEditDis::searchTrie1(trie& tree, string word)
 {   string min_str;
-    min_str.clear();
+    tree.compact();
     word = string("$") + word;
 
     int sz = word.size();
     min_cost = 0x3f3f3f3f;
-    //min_str = "";
 
     vector<int> current_row(sz + 1);
 
@@ -149,10 +510,14 @@ string trieEditDis::searchTrie1(trie& tree, string word)
     for (int i = 0; i < sz; ++i) current_row[i] = i;
     current_row[sz] = sz;
 
+    string path;
+    path.reserve(sz * 2);
+
     //! For each letter in the root map wich matches with a letter in word, we must call the search
     for (int i = 0 ; i < sz; ++i) {
-        if (tree.next.find(word[i]) != tree.next.end()) {
-            search_impl1(tree.next[word[i]], word[i], current_row, word, min_str);
+        trie::node_t n = tree.child(tree.root(), word[i]);
+        if (n != trie::npos) {
+            search_impl1(tree, n, word[i], current_row, word, path, min_str);
         }
     }
 
@@ -161,11 +526,11 @@ string trieEditDis::searchTrie1(trie& tree, string word)
 
 
 // treeonesearch ends
-void trieEditDis::loadmaptoTrie(trie& tree,map<string,int > m2){
-    for( map<string,int >::const_iterator ptr=m2.begin();
-         ptr!=m2.end(); ptr++) {
-        tree.insert(ptr->first);
+void trieEditDis::loadmaptoTrie(trie& tree, const Lexicon& m2){
+    for(size_t i = 0; i < m2.size(); i++) {
+        tree.insert(m2.key(i));
     }
+    tree.compact();
     //cout << " copied map to tree" << endl;
            //cout << "m2 size " << m2.size() << endl;
 }
@@ -175,14 +540,20 @@ void trieEditDis::loadmaptoTrie(trie& tree,map<string,int > m2){
  * \fn trieEditDis::print5NearestEntries
  * \param tree
  * \param OCRWord
+ * \param maxDist largest edit distance considered, negative for no bound
  * \return
  */
-vector<string> trieEditDis::print5NearestEntries(trie& tree,string OCRWord){
+vector<string> trieEditDis::print5NearestEntries(trie& tree,string OCRWord, int maxDist){
 vector<string> out;
 slpNPatternDict slnp;
 OCRWord = slnp.toslp1(OCRWord);
-vector<pair<int,string>> minGooglestr = searchTrie(tree,OCRWord);
+vector<pair<int,string>> minGooglestr;
+//! The loop below looks at no more than the first six sorted entries
+if (maxDist >= 0) minGooglestr = searchTrieBounded(tree, OCRWord, maxDist, 6);
+else {
+    minGooglestr = searchTrie(tree,OCRWord);
     sort(minGooglestr.begin(), minGooglestr.end());
+}
     bool boolFlag =0;
 
     for(size_t i = 0; i < minGooglestr.size(); i++)
@@ -207,14 +578,16 @@ return out;
  * \param vec
  * \return
  */
-vector<string> trieEditDis::print1OCRNearestEntries(string OCRWord, vector<string> vec){
+vector<string> trieEditDis::print1OCRNearestEntries(string OCRWord, const vector<string>& vec){
 
 vector<pair<int,string>> minIstr;
 size_t minEditDis = 100;
 size_t sz = vec.size();
+eddis e;
+vector<size_t> dists;
+e.editDistBatch(OCRWord, vec, dists);
     for(size_t t =0; t< sz; t++){
-    eddis e;
-    size_t  ed = e.editDist(vec[t],OCRWord);
+    size_t  ed = dists[t];
     if (ed < minEditDis) { minEditDis = ed; minIstr.push_back(make_pair(ed, vec[t]));}
     else if(ed < minEditDis+2) minIstr.push_back(make_pair(ed, vec[t]));
     }
@@ -250,13 +623,13 @@ return out;
  * \return
  */
 bool trieEditDis::insertPatternsOf(string str, trie& TPWordsP, size_t& count){ //map<string,int >&  PWordsP
+    //! Every prefix of every suffix of str, one trie walk per suffix
     size_t sz = str.size();
-    if(sz == 0) return 1;
-    for(size_t i = 0; i < (sz+1); i++){
-        string s1 = str.substr(0,i);
-        TPWordsP.insert(s1); count++;//PWordsP[s1]++;
+    for(size_t j = 0; j < sz; j++){
+        TPWordsP.insertPrefixes(str.data() + j, sz - j);
+        count += sz - j + 1;
     }
-    return insertPatternsOf(str.substr(1,sz-1),TPWordsP,count);//PWordsP
+    return 1;
 }
 
 /*!
@@ -265,32 +638,32 @@ bool trieEditDis::insertPatternsOf(string str, trie& TPWordsP, size_t& count){ /
  * \param PWords
  * \return
  */
-size_t trieEditDis::loadPWordsPatternstoTrie(trie& TPWordsP, map<string,int >& PWords){ // arg1(strt from 0) ,map<string,int >& PWordsP
+size_t trieEditDis::loadPWordsPatternstoTrie(trie& TPWordsP, const Lexicon& PWords){ // arg1(strt from 0) ,map<string,int >& PWordsP
     size_t count = 0;
 
-        for( map<string,int >::const_iterator ptr=PWords.begin();
-             ptr!=PWords.end(); ptr++) {
-           insertPatternsOf(ptr->first, TPWordsP,count);
+        for(size_t i = 0; i < PWords.size(); i++) {
+           insertPatternsOf(PWords.key(i), TPWordsP,count);
         }
+        TPWordsP.compact();
         return count;
     }
 
 
 
 //!applicable when trieeditdisone is used as searchTrie will give str as output, else it give vector<string>
-string trieEditDis::SamasBreakLRCorrect(string s1, map<string, int>& m1, map<string, int>& PWordsNew,trie& tree, trie& treeP) { //unordered_
+string trieEditDis::SamasBreakLRCorrect(string s1, const Lexicon& m1, const Lexicon& PWordsNew,trie& tree, trie& treeP) { //unordered_
 if((s1.size() == 0) || (s1 == "")) return "";
-if((m1[s1]>0)||PWordsNew[s1]>0) return  s1;
+if((m1.count(s1)>0)||PWordsNew.count(s1)>0) return  s1;
 //cout << "s1 "<< s1 << endl;
 
 for(size_t i = s1.size(); i > 0; i --){            // DASOAHAM 8
 
     for(size_t j =0; j < s1.size() - i+1; j++){    // i determinze size of substring
-    string str = s1.substr(j,i);                   // eg: i = 8, j = 0:0 DASOAHAM ; i = 7, j = 0:1  DASOAHA ASOAHAM..... ;i =1, j = 0:7 D A S O A H A M
+    // eg: i = 8, j = 0:0 DASOAHAM ; i = 7, j = 0:1  DASOAHA ASOAHAM..... ;i =1, j = 0:7 D A S O A H A M
 
-    //!checking str
-    //cout <<"str outside " << str << endl;
-    if((m1[str]>0)||PWordsNew[str]>0) {
+    //!checking str without building it
+    if((m1.count(s1.data() + j, i)>0)||PWordsNew.count(s1.data() + j, i)>0) {
+    string str = s1.substr(j,i);
 
     //cout << "here "<< str << " L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
     //cout <<"str inside " << str << endl;
@@ -7,7 +7,7 @@
 #include <algorithm>
 #include "slpNPatternDict.h"
 #include <cctype>
-#include <vector>
+#include <cstdint>
 //#include <boost/range/adaptor/reversed.hpp>
 
 /*
@@ -17,39 +17,73 @@
 
 using namespace std;
 
-// Trie's node
+// Trie's node storage
+/*
+ * Nodes live in one arena and are addressed by index; node 0 is the root.
+ * While words are being inserted the children of a node form a sorted
+ * sibling list. compact() then lays the children of every node out as
+ * contiguous, sorted label/node arrays (structure of arrays) and drops
+ * the sibling lists, which is the form searched by trieEditDis.
+ * Terminal words are not stored: the search rebuilds them from the path.
+ */
 struct trie
 {
-    typedef map<char, trie*> next_t;
+    typedef uint32_t node_t;
+    static const node_t npos = 0xFFFFFFFFu;
+
+    trie() { clear(); }
+
+    void clear();
+
+    // Every word is stored with a leading "$", as the searches expect.
+    void insert(const string& w);
+
+    // Inserts every prefix of w (including the empty one) in one walk.
+    void insertPrefixes(const char* w, size_t len);
+
+    void compact();
+
+    bool isCompact() const { return compacted; }
 
-    // The set with all the letters which this node is prefix
-    next_t next;
+    node_t root() const { return 0; }
 
-    // If word is equal to "" is because there is no word in the
-    //  dictionary which ends here.
-    string word;
+    node_t child(node_t n, char c) const;
 
-    trie() : next(map<char, trie*>()) {}
+    node_t childBegin(node_t n) const { return childStart[n]; }
 
-    void clear() { next.clear(); }
+    node_t childEnd(node_t n) const { return childStart[n + 1]; }
 
-    void insert(string w)
-    {
-        w = string("$") + w;
+    char childLabelAt(node_t i) const { return childLabel[i]; }
 
-        int sz = w.size();
+    node_t childNodeAt(node_t i) const { return childNode[i]; }
 
-        trie* n = this;
-        for (int i = 0; i < sz; ++i) {
-            if (n->next.find(w[i]) == n->next.end()) {
-                n->next[w[i]] = new trie();
-            }
+    bool isTerminal(node_t n) const { return terminal[n] != 0; }
 
-            n = n->next[w[i]];
-        }
+    size_t nodeCount() const { return terminal.size(); }
 
-        n->word = w;
-    }
+    size_t wordCount() const { return words; }
+
+    size_t memoryUsage() const;
+
+    //! Binary form of the compact arrays, used by DictSnapshot
+    void write(string& out);
+
+    bool read(const char*& p, const char* end);
+
+private:
+    // build form: sorted sibling lists
+    vector<node_t> firstChild, nextSibling;
+    vector<char> label;
+    // compact form: children of n are [childStart[n], childStart[n+1])
+    vector<node_t> childStart, childNode;
+    vector<char> childLabel;
+    vector<unsigned char> terminal;
+    size_t words;
+    bool compacted;
+
+    node_t addNode(char c);
+    node_t findOrAddChild(node_t n, char c);
+    void expand();
 };
 
 
@@ -62,25 +96,35 @@ class trieEditDis {
 public:
     int min_cost;
 
-    void search_impl(trie* tree, char ch, vector<int> last_row, const string& word, vector<pair<int,string>>& min_str);
+    //! Edit distance bound used for the right click suggestion searches
+    static const int SUGGESTION_MAX_EDIT_DISTANCE = 3;
+
+    //! One DP row per trie depth, reused by the bounded search
+    vector<int> row_stack;
+
+    void search_impl(const trie& tree, trie::node_t node, char ch, vector<int> last_row, const string& word, string& path, vector<pair<int,string>>& min_str);
 
     vector<pair<int,string>> searchTrie(trie& tree, string word);
 
-    void search_impl1(trie* tree, char ch, vector<int> last_row, const string& word, string& min_str);
+    void search_bounded(const trie& tree, trie::node_t node, char ch, size_t depth, const string& word, string& path, int maxDist, vector<pair<int,string>>& min_str);
+
+    vector<pair<int,string>> searchTrieBounded(trie& tree, string word, int maxDist, size_t topN = 0);
+
+    void search_impl1(const trie& tree, trie::node_t node, char ch, vector<int> last_row, const string& word, string& path, string& min_str);
 
     string searchTrie1(trie& tree, string word);
 
-    void loadmaptoTrie(trie& tree,map<string,int > m2);
+    void loadmaptoTrie(trie& tree, const Lexicon& m2);
 
-    vector<string> print5NearestEntries(trie& tree,string OCRWord);
+    vector<string> print5NearestEntries(trie& tree,string OCRWord, int maxDist = -1);
 
-    vector<string> print1OCRNearestEntries(string OCRWord, vector<string> vec);
+    vector<string> print1OCRNearestEntries(string OCRWord, const vector<string>& vec);
 
     bool insertPatternsOf(string str, trie& TPWordsP, size_t& count);
 
-    size_t loadPWordsPatternstoTrie(trie& TPWordsP, map<string,int >& PWords);
+    size_t loadPWordsPatternstoTrie(trie& TPWordsP, const Lexicon& PWords);
 
-    string SamasBreakLRCorrect(string s1, map<string, int>& m1, map<string, int>& PWordsNew,trie& tree, trie& treeP);
+    string SamasBreakLRCorrect(string s1, const Lexicon& m1, const Lexicon& PWordsNew,trie& tree, trie& treeP);
 
 };
 
@@ -1,23 +1,169 @@
+/*!
+ * \class word_count
+ * \brief Counts the words of the current page and of the pages of the output folder, recounting only the pages changed since the last count
+ */
 #include "word_count.h"
 #include "customtextbrowser.h"
+#include "htmltotext.h"
 #include<QtCore>
 #include<QDir>
 #include<QDirIterator>
 #include<QTextStream>
 #include<QRegExp>
+#include<QFileInfo>
+#include<QJsonDocument>
+#include<QJsonObject>
+#include<QSaveFile>
+#include<QThreadPool>
+#include<QRunnable>
+
+/*!
+ * \class WordCountTask
+ * \brief Counts the words of one page on the word count thread pool
+ */
+class WordCountTask : public QRunnable
+{
+public:
+    WordCountTask(const QString &path, int *words) : path(path), words(words) {}
+
+    void run() override
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qDebug() << "Error reading file" << path;
+            *words = 0;
+            return;
+        }
+        QTextStream stream(&file);
+        stream.setCodec("UTF-8");
+        *words = word_count::countPageWords(stream.readAll());
+    }
 
-
+private:
+    QString path;
+    int *words;
+};
+
+/*!
+ * \fn word_count::word_count
+ * \brief Reads the text of \a curr_browser here, in the GUI thread, as the count runs in a thread of its own
+ * \param curr_browser
+ * \param mRole
+ * \param gDirTwoLevelUp
+ */
 word_count::word_count(CustomTextBrowser * curr_browser, QString mRole, QString gDirTwoLevelUp)
 {
     this->curr_browser = curr_browser;
     this->mRole = mRole;
     this->gDirTwoLevelUp = gDirTwoLevelUp;
+    if(curr_browser)
+        currentText = curr_browser->toPlainText();
+}
+
+/*!
+ * \fn word_count::countPageWords
+ * \brief Counts the words of a saved page, an equation between $$ counting as one word
+ * \param html
+ * \return
+ */
+int word_count::countPageWords(const QString &html)
+{
+    int count=0;
+    QRegularExpression rex_dollar("(?<=\\$\\$)(.*?)(?=\\$\\$)",QRegularExpression::DotMatchesEverythingOption);
+
+    auto itr = rex_dollar.globalMatch(html);
+    QString s1 = HtmlToText::toPlainText(html);
+
+    while(itr.hasNext())
+    {
+        count++;
+        itr.next();
+    }
+    s1.remove("?");
+    s1.remove("|");
+    s1.remove("`");
+    s1.remove("[");
+    s1.remove("]");
+    s1.remove("'");
+    s1.remove(",");
+    s1.remove(rex_dollar);
+
+    int wordcnt = s1.split(QRegExp("(\\s|\\n|\\r)+"), QString::SkipEmptyParts).count();
+    wordcnt += (count-1)/2;
+    return wordcnt;
+}
+
+/*!
+ * \fn word_count::readIndex
+ * \brief Reads the counts of the pages of \a folder from the index file
+ * \param path
+ * \param folder
+ * \return
+ */
+QMap<QString, word_count::PageCount> word_count::readIndex(const QString &path, const QString &folder)
+{
+    QMap<QString, PageCount> pages;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return pages;
+    QJsonObject folderObject = QJsonDocument::fromJson(file.readAll()).object().value(folder).toObject();
+    file.close();
+    for (auto it = folderObject.constBegin(); it != folderObject.constEnd(); ++it) {
+        QJsonObject page = it.value().toObject();
+        PageCount count;
+        count.size = (qint64)page.value("size").toDouble(-1);
+        count.modified = (qint64)page.value("modified").toDouble(-1);
+        count.words = page.value("words").toInt();
+        pages.insert(it.key(), count);
+    }
+    return pages;
 }
 
+/*!
+ * \fn word_count::writeIndex
+ * \brief Replaces the counts of the pages of \a folder in the index file, keeping those of the other folder
+ * \param path
+ * \param folder
+ * \param pages
+ */
+void word_count::writeIndex(const QString &path, const QString &folder, const QMap<QString, PageCount> &pages)
+{
+    QJsonObject root;
+    QFile in(path);
+    if (in.open(QIODevice::ReadOnly)) {
+        root = QJsonDocument::fromJson(in.readAll()).object();
+        in.close();
+    }
+    QJsonObject folderObject;
+    for (auto it = pages.constBegin(); it != pages.constEnd(); ++it) {
+        QJsonObject page;
+        page.insert("size", (double)it.value().size);
+        page.insert("modified", (double)it.value().modified);
+        page.insert("words", it.value().words);
+        folderObject.insert(it.key(), page);
+    }
+    root.insert(folder, folderObject);
+
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qDebug() << "Could not write" << path;
+        return;
+    }
+    out.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!out.commit())
+        qDebug() << "Could not write" << path;
+}
+
+/*!
+ * \fn word_count::run_wordCount
+ * \brief Emits the words of the current page, the number of pages and the words of all the pages
+ * \details The pages whose size or modification time differ from the index, or are not in it, are counted
+ * on a thread pool; the others take their count from the index, which is then updated.
+ */
 void word_count::run_wordCount()
 {
     if(curr_browser){
-        QString extText = curr_browser->toPlainText();
+        QString extText = currentText;
         //!Removes these symbol while counting
         extText.remove("?");
         extText.remove("|");
@@ -32,72 +178,59 @@ void word_count::run_wordCount()
         //QString str = QString::number(wordcnt);
         emit word_Count(wordcnt);
 
-        QString currentDirAbsolutePath;
+        QString folder;
         if(mRole=="Verifier")
-            currentDirAbsolutePath = gDirTwoLevelUp + "/VerifierOutput/";
+            folder = "VerifierOutput";
         else if (mRole=="Corrector") {
-            currentDirAbsolutePath = gDirTwoLevelUp + "/CorrectorOutput/";
+            folder = "CorrectorOutput";
         }
-
+        QString currentDirAbsolutePath = gDirTwoLevelUp + "/" + folder + "/";
+        QString indexPath = gDirTwoLevelUp + "/WordCount.json";
 
         //! We then open this directory and set sorting preferences.
         QDir dir(currentDirAbsolutePath);
         dir.setSorting(QDir::SortFlag::DirsFirst | QDir::SortFlag::Name);
-        QDirIterator dirIterator(dir,QDirIterator::NoIteratorFlags);
         qDebug()<<dir;
         //! Set count of files in directory
-
-        int count = dir.entryList(QStringList("*.html"), QDir::Files | QDir::NoDotAndDotDot).count();
+        QFileInfoList files = dir.entryInfoList(QStringList("*.html"), QDir::Files | QDir::NoDotAndDotDot);
 
         //QString str1 = QString::number(count);
-        emit page_Count(count);
+        emit page_Count(files.count());
 
-        int t_words=0;
-        foreach(auto a, dir.entryList())
+        QMap<QString, PageCount> index = readIndex(indexPath, folder);
+        QMap<QString, PageCount> pages;
+        QStringList changed;
+        for (const QFileInfo &info : files)
         {
-            QString x = currentDirAbsolutePath + a;
-            QString mainHtml;
-            int count=0;
-            if(x.contains("."))
-            {
-                QStringList html_files = x.split(QRegExp("[.]"));
-                if(html_files[1]=="html")
-                {
-                    QFile file(x);
-                    if (!file.open(QIODevice::ReadOnly))
-                        qDebug() << "Error reading file main.html";
-                    QTextStream stream(&file);
-                    stream.setCodec("UTF-8");
-                    mainHtml=stream.readAll();
-                    QRegularExpression rex_dollar("(?<=\\$\\$)(.*?)(?=\\$\\$)",QRegularExpression::DotMatchesEverythingOption);
-
-                    auto itr = rex_dollar.globalMatch(mainHtml);
-                    QTextDocument doc;
-                    doc.setHtml(mainHtml);
-                    QString s1 = doc.toPlainText();
-
-                    while(itr.hasNext())
-                    {
-                        count++;
-                        itr.next();
-                    }
-                    s1.remove("?");
-                    s1.remove("|");
-                    s1.remove("`");
-                    s1.remove("[");
-                    s1.remove("]");
-                    s1.remove("'");
-                    s1.remove(",");
-                    s1.remove(rex_dollar);
-
-                    int wordcnt = s1.split(QRegExp("(\\s|\\n|\\r)+"), QString::SkipEmptyParts).count();
-                    wordcnt += (count-1)/2;
-                    t_words += wordcnt;
-
-                }
-            }
+            PageCount count;
+            count.size = info.size();
+            count.modified = info.lastModified().toMSecsSinceEpoch();
+            count.words = 0;
+            auto cached = index.constFind(info.fileName());
+            if (cached != index.constEnd() && cached.value().size == count.size && cached.value().modified == count.modified)
+                count.words = cached.value().words;
+            else
+                changed.append(info.fileName());
+            pages.insert(info.fileName(), count);
         }
 
+        //! Count the changed pages in parallel
+        QVector<int> words(changed.size());
+        QThreadPool pool;
+        pool.setMaxThreadCount(QThread::idealThreadCount());
+        for (int i = 0; i < changed.size(); i++)
+            pool.start(new WordCountTask(currentDirAbsolutePath + changed[i], &words[i]));
+        pool.waitForDone();
+        for (int i = 0; i < changed.size(); i++)
+            pages[changed[i]].words = words[i];
+
+        int t_words=0;
+        for (const PageCount &count : pages)
+            t_words += count.words;
+
+        if (!changed.isEmpty() || pages.size() != index.size())
+            writeIndex(indexPath, folder, pages);
+
         //QString str3 = QString::number(t_words);
         emit total_Words(t_words);
         emit done();
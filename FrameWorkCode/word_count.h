@@ -2,14 +2,29 @@
 #define WORD_COUNT_H
 
 #include <QObject>
+#include <QMap>
 #include "customtextbrowser.h"
 
+/*
+ * Counts the words of the current page and of all the pages of the output
+ * folder of the role. The count of every page is kept in WordCount.json in
+ * the project directory with the size and modification time of its file, so
+ * only the pages changed since the last count are read again.
+ */
 class word_count: public QObject
 {
     Q_OBJECT
 public:
+    struct PageCount {
+        qint64 size;
+        qint64 modified;        // msecs since epoch
+        int words;
+    };
+
     word_count(CustomTextBrowser * curr_browser = nullptr, QString mRole = "" , QString gDirTwoLevelUp = "");
 
+    static int countPageWords(const QString &html);
+
 public slots:
     void run_wordCount();
 
@@ -17,6 +32,10 @@ private:
     CustomTextBrowser * curr_browser;
     QString mRole ;
     QString gDirTwoLevelUp;
+    QString currentText;    // of curr_browser, read in the GUI thread
+
+    QMap<QString, PageCount> readIndex(const QString &path, const QString &folder);
+    void writeIndex(const QString &path, const QString &folder, const QMap<QString, PageCount> &pages);
 
 signals:
     void word_Count(int);
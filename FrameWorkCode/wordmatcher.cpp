@@ -0,0 +1,204 @@
+/*!
+ * \class WordMatcher
+ * \brief Multi pattern whole word matcher shared by global replace, its preview and its undo
+ */
+#include "wordmatcher.h"
+#include <QTextDocument>
+#include <QTextCursor>
+#include <QTextCharFormat>
+#include <algorithm>
+
+/*!
+ * \fn WordMatcher::WordMatcher
+ * \brief Builds the automaton for patterns. Empty patterns never match.
+ * \param patterns
+ * \param cs
+ */
+WordMatcher::WordMatcher(const QStringList &patterns, Qt::CaseSensitivity cs)
+{
+    this->patterns = patterns;
+    this->cs = cs;
+    build();
+}
+
+/*!
+ * \fn WordMatcher::isWordChar
+ * \brief Letters, numbers, combining marks (matras, virama, nukta, anusvara) and the zero width joiners are part of a word
+ * \param c
+ * \return
+ */
+bool WordMatcher::isWordChar(QChar c)
+{
+    return c.isLetterOrNumber() || c.isMark() || c.unicode() == 0x200C || c.unicode() == 0x200D;
+}
+
+/*!
+ * \fn WordMatcher::fold
+ * \param c
+ * \return c, case folded if the matcher is case insensitive
+ */
+ushort WordMatcher::fold(QChar c) const
+{
+    return cs == Qt::CaseSensitive ? c.unicode() : c.toCaseFolded().unicode();
+}
+
+/*!
+ * \fn WordMatcher::child
+ * \param node
+ * \param c
+ * \return the child of node along c, -1 if there is none
+ */
+int WordMatcher::child(int node, ushort c) const
+{
+    return edges.value(((quint64)node << 16) | c, -1);
+}
+
+/*!
+ * \fn WordMatcher::build
+ * \brief Builds the trie of the patterns and then its fail and output links breadth first
+ */
+void WordMatcher::build()
+{
+    nodes.clear();
+    edges.clear();
+    Node root;
+    root.fail = 0;
+    root.pattern = -1;
+    root.output = -1;
+    root.depth = 0;
+    nodes.append(root);
+
+    for (int p = 0; p < patterns.size(); p++) {
+        const QString &w = patterns.at(p);
+        if (w.isEmpty())
+            continue;
+        int node = 0;
+        for (int i = 0; i < w.size(); i++) {
+            ushort c = fold(w.at(i));
+            int next = child(node, c);
+            if (next < 0) {
+                Node n;
+                n.fail = 0;
+                n.pattern = -1;
+                n.output = -1;
+                n.depth = nodes[node].depth + 1;
+                next = nodes.size();
+                nodes.append(n);
+                nodes[node].children.append(next);
+                edges.insert(((quint64)node << 16) | c, next);
+            }
+            node = next;
+        }
+        if (nodes[node].pattern < 0)
+            nodes[node].pattern = p;
+    }
+
+    //! The character of an edge is needed to follow the fail links, keep it per child
+    QVector<ushort> label(nodes.size(), 0);
+    for (QHash<quint64, int>::const_iterator it = edges.constBegin(); it != edges.constEnd(); ++it)
+        label[it.value()] = (ushort)(it.key() & 0xFFFF);
+
+    QVector<int> queue;
+    queue.reserve(nodes.size());
+    for (int c : nodes[0].children)
+        queue.append(c);
+    for (int q = 0; q < queue.size(); q++) {
+        int node = queue[q];
+        for (int c : nodes[node].children) {
+            int f = nodes[node].fail;
+            int next = child(f, label[c]);
+            while (next < 0 && f != 0) {
+                f = nodes[f].fail;
+                next = child(f, label[c]);
+            }
+            nodes[c].fail = (next >= 0 && next != c) ? next : 0;
+            int fn = nodes[c].fail;
+            nodes[c].output = nodes[fn].pattern >= 0 ? fn : nodes[fn].output;
+            queue.append(c);
+        }
+    }
+}
+
+/*!
+ * \fn WordMatcher::findAll
+ * \brief Scans text once and returns the non overlapping whole word matches of all patterns
+ * \param text
+ * \return matches sorted by position
+ */
+QVector<WordMatcher::Match> WordMatcher::findAll(const QString &text) const
+{
+    QVector<Match> candidates;
+    int n = text.size();
+    int node = 0;
+    for (int i = 0; i < n; i++) {
+        ushort c = fold(text.at(i));
+        int next = child(node, c);
+        while (next < 0 && node != 0) {
+            node = nodes[node].fail;
+            next = child(node, c);
+        }
+        node = next < 0 ? 0 : next;
+
+        //! a match ends at i, it is a whole word if the characters around it are boundaries
+        if (i + 1 < n && isWordChar(text.at(i + 1)))
+            continue;
+        for (int m = nodes[node].pattern >= 0 ? node : nodes[node].output; m >= 0; m = nodes[m].output) {
+            int start = i + 1 - nodes[m].depth;
+            if (start > 0 && isWordChar(text.at(start - 1)))
+                continue;
+            Match match;
+            match.position = start;
+            match.length = nodes[m].depth;
+            match.pattern = nodes[m].pattern;
+            candidates.append(match);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Match &a, const Match &b) {
+        return a.position != b.position ? a.position < b.position : a.length > b.length;
+    });
+    QVector<Match> matches;
+    int end = 0;
+    for (const Match &m : candidates) {
+        if (m.position < end)
+            continue;
+        matches.append(m);
+        end = m.position + m.length;
+    }
+    return matches;
+}
+
+/*!
+ * \fn WordMatcher::replaceInDocument
+ * \brief Finds the matches in the text of doc and replaces them, last one first so that earlier positions stay valid
+ * \param doc
+ * \param replacements replacement of each pattern
+ * \param asHtml insert the replacements as html, e.g. with a highlighting span, instead of plain text
+ * \return Number of replaced words
+ */
+int WordMatcher::replaceInDocument(QTextDocument *doc, const QStringList &replacements, bool asHtml) const
+{
+    //! toPlainText() maps every document position to one character, so match positions are cursor positions
+    QVector<Match> matches = findAll(doc->toPlainText());
+    QTextCursor cur(doc);
+    cur.beginEditBlock();
+    for (int i = matches.size() - 1; i >= 0; i--) {
+        const Match &m = matches[i];
+        cur.setPosition(m.position, QTextCursor::MoveAnchor);
+        cur.setPosition(m.position + m.length, QTextCursor::KeepAnchor);
+        QTextCharFormat fmt = cur.charFormat(); //get the QTextCharFormat of old word/phrase to be replaced
+        if (asHtml) {
+            cur.insertHtml(replacements.at(m.pattern));
+            int end = cur.position();
+            cur.setPosition(m.position, QTextCursor::MoveAnchor);
+            cur.setPosition(end, QTextCursor::KeepAnchor);
+            fmt.clearBackground(); // keep the highlighting of the inserted html
+            cur.mergeCharFormat(fmt);
+        }
+        else {
+            cur.insertText(replacements.at(m.pattern), fmt);
+        }
+    }
+    cur.endEditBlock();
+    return matches.size();
+}
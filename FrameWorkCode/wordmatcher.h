@@ -0,0 +1,63 @@
+#ifndef WORDMATCHER_H
+#define WORDMATCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+class QTextDocument;
+
+/*
+ * Aho-Corasick automaton over a set of words or phrases, used by global replace,
+ * its preview and its undo. One pass over a text finds every whole word occurrence
+ * of every pattern. A boundary is a character that is neither a letter, a number
+ * nor a combining mark, so a Devanagari word does not match inside a longer word
+ * that only differs by a matra, virama or nukta (QTextDocument::FindWholeWords
+ * treats those marks as boundaries).
+ * Overlapping occurrences are resolved leftmost first, then longest first; when
+ * a pattern is given twice the first one wins.
+ */
+class WordMatcher
+{
+public:
+    struct Match {
+        int position;
+        int length;
+        int pattern;    // index into the pattern list
+    };
+
+    explicit WordMatcher(const QStringList &patterns = QStringList(), Qt::CaseSensitivity cs = Qt::CaseSensitive);
+
+    int patternCount() const { return patterns.size(); }
+
+    QString pattern(int i) const { return patterns.at(i); }
+
+    //! Non overlapping whole word occurrences in text order
+    QVector<Match> findAll(const QString &text) const;
+
+    //! Replaces the matches in doc by replacements[pattern], as html or as plain text, keeping the character format of the replaced text
+    int replaceInDocument(QTextDocument *doc, const QStringList &replacements, bool asHtml) const;
+
+    static bool isWordChar(QChar c);
+
+private:
+    struct Node {
+        int fail;
+        int pattern;    // pattern ending here, -1 if none
+        int output;     // nearest node on the fail chain with a pattern, -1 if none
+        int depth;
+        QVector<int> children;
+    };
+
+    QStringList patterns;
+    Qt::CaseSensitivity cs;
+    QVector<Node> nodes;
+    QHash<quint64, int> edges; // (node << 16 | character) -> child node
+
+    ushort fold(QChar c) const;
+    int child(int node, ushort c) const;
+    void build();
+};
+
+#endif // WORDMATCHER_H
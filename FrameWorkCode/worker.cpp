@@ -1,6 +1,7 @@
 #include "worker.h"
 #include "slpNPatternDict.h"
 #include "editdistance.h"
+#include "suggestionservice.h"
 
 
 /*!
@@ -25,7 +26,7 @@ Worker::Worker(QObject *parent,
                QString s1,
                QString s2,
                std::map<std::string, std::string> CPair_editDis,
-               std::map<string, set<string> >* CPairs,
+               CorrectionPairs* CPairs,
                map<QString, QString> filestructure_fw,
                QSet<QString>* dict_set1,
                QString mRole
@@ -119,19 +120,13 @@ void Worker::doSaveBackend()
 void Worker:: addCpair()
 {
     //! Enters entries in CPairs through CPair_editDis; allows multiple entries for a incorrent word entry
+    //! CPairs is keyed by SLP1 like the entries loaded from the CPair file, the file keeps the words as they were replaced
+    QWriteLocker locker(&suggestionDataLock);
     for(auto &elem : CPair_editDis)
     {
-        //CPair.insert(make_pair(toslp1(elem.first), toslp1(elem.second)));
-        if ( (*CPairs).find(elem.first) != (*CPairs).end())
-        {
-            std::set< std::string>& s_ref = (*CPairs)[elem.first];
-            s_ref.insert(elem.second);
-        }
-        else
-        {
-            (*CPairs)[elem.first].insert(elem.second);
-        }
+        (*CPairs).add(slnp.toslp1(elem.first), slnp.toslp1(elem.second));
     }
+    locker.unlock();
 
     //! Reflecting CPairs entries in the file /Dicts/CPair; Making it dynamic
     QString filename12 = (*mProject).GetDir().absolutePath() + "/Dicts/" + mRole +"_CPair";
@@ -161,11 +156,10 @@ void Worker:: addCpair()
     {
         QTextStream out(&file12);
         out.setCodec("UTF-8");
-        map<string, set<string>>::iterator itr;
-        set<string>::iterator set_it;
+        map<string, string>::iterator itr;
         int flag = 0;
 
-        for (itr = (*CPairs).begin(); itr != (*CPairs).end(); ++itr)
+        for (itr = CPair_editDis.begin(); itr != CPair_editDis.end(); ++itr)
         {
             //!Don't add special symbols to cpair file
             QString special_symbols = "~`!@#$%^&*()-+={}[]|\"/:\ ;'<>,.?;";
@@ -192,11 +186,7 @@ void Worker:: addCpair()
             }
             if(flag == 0 && replaceFlag == 1){
                 split1.append(QString::fromStdString(itr->first));
-                set_it = itr->second.begin();
-                {
-                    split1.append(QString::fromStdString(*set_it));
-
-                }
+                split1.append(QString::fromStdString(itr->second));
             }
 
             flag = 0;
@@ -208,4 +198,5 @@ void Worker:: addCpair()
         }
         file12.close();
     }
+    emit finished();
 }
@@ -4,6 +4,7 @@
 #include <QObject>
 #include "Project.h"
 #include <set>
+#include "correctionpairs.h"
 
 class Worker : public QObject
 {
@@ -17,7 +18,7 @@ public:
                     QString s1 = "",
                     QString s2 = "",
                     std::map<std::string, std::string> CPair_editDis = {},
-                    std::map<std::string, std::set<std::string> >* CPairs = nullptr,
+                    CorrectionPairs* CPairs = nullptr,
                     std::map<QString, QString> filestructure_fw = {},
                     QSet<QString>* dict_set1 = {},
                     QString mRole = "Corrector");
@@ -30,7 +31,7 @@ private:
     Project* mProject;
     std::map<std::string, std::string> CPair_editDis;
     std::map<QString, QString> filestructure_fw;
-    std::map<std::string, std::set<std::string> >* CPairs;
+    CorrectionPairs* CPairs;
     QSet<QString>* dict_set1;
     QString mRole;
 